@@ -438,19 +438,12 @@ private:
             auto hNewCmdBuf =
                 AcquireNewCommandBuffer(pRangeContext->LastCmdListIndex, &pRangeContext->LastCmdListIndex);
 
+            // Each thread must have its own command list.
+            // Since an RpsCmdCallbackContext has some associated command buffer,
+            // we must create a new context with the new command list.
+            // rpsCmdCloneContext is thread safe, no lock is needed here.
             const RpsCmdCallbackContext* pLocalContext = {};
-            {
-                // We must use a lock when calling rpsCmdCloneContext as the cloned context
-                // is a data structure managed by the RPS SDK. An alloc happens here.
-                //
-                // Undefined behavior _will_ occur if we are trying to alloc from two threads at once.
-                std::lock_guard<std::mutex> lock(m_cmdListsMutex);
-
-                // Each thread must have its own command list.
-                // Since an RpsCmdCallbackContext has some associated command buffer,
-                // we must create a new context with the new command list.
-                AssertIfRpsFailed(rpsCmdCloneContext(pContext, hNewCmdBuf, &pLocalContext));
-            }
+            AssertIfRpsFailed(rpsCmdCloneContext(pContext, hNewCmdBuf, &pLocalContext));
 
             auto pCmdList = rpsD3D12CommandListFromHandle(pLocalContext->hCommandBuffer);
 
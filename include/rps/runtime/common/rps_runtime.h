@@ -124,13 +124,19 @@ typedef enum RpsScheduleFlagBits
     /// RPS_SCHEDULE_WORKLOAD_TYPE_PIPELINING_DISABLE_BIT is set, this flag will have no effect.
     RPS_SCHEDULE_WORKLOAD_TYPE_PIPELINING_AGGRESSIVE_BIT = (1 << 6),
 
-    // Reserved for future use:
+    /// Avoids rescheduling if possible and uses the existing schedule instead. If the scheduling inputs (node and
+    /// edge topology, queue and workload requirements, resource usages and schedule flags) match the previous update,
+    /// the previous command order, queue assignment and batch layout are reused. If RPS_SCHEDULE_RANDOM_ORDER_BIT is
+    /// set, this flag will have no effect.
+    RPS_SCHEDULE_AVOID_RESCHEDULE_BIT = (1 << 17),
 
-    /// Reserved for future use. Includes split barriers where appropriate.
+    /// Includes split barriers where appropriate. A transition with commands scheduled between the previous access
+    /// and the next access of the subresource is split into a begin half right after the previous access and an end
+    /// half right before the next access. Transitions are only split within a command batch. This flag has no effect
+    /// on backends without split barrier support, such as Vulkan.
     RPS_SCHEDULE_ALLOW_SPLIT_BARRIERS_BIT = (1 << 16),
 
-    /// Reserved for future use. Avoids rescheduling if possible and uses the existing schedule instead.
-    RPS_SCHEDULE_AVOID_RESCHEDULE_BIT = (1 << 17),
+    // Reserved for future use:
 
     /// Reserved for future use. Allows work to overlap between multiple frames.
     RPS_SCHEDULE_ALLOW_FRAME_OVERLAP_BIT = (1 << 21),
@@ -174,8 +180,11 @@ typedef enum RpsDiagnosticFlagBits
                                                          ///  resource definitions and node calls.
     RPS_DIAGNOSTIC_ENABLE_RUNTIME_DEBUG_NAMES = 1 << 4,  ///< Sets resource names as debug names in the graphics
                                                          ///  API in use.
+    RPS_DIAGNOSTIC_ENABLE_REFERENCE_SCHEDULER = 1 << 5,  ///< Scores every ready node for each scheduling step
+                                                         ///  instead of using the ready node queue. Produces the
+                                                         ///  same schedule more slowly, for validation.
 
-    RPS_DIAGNOSTIC_ENABLE_ALL = (1 << 5) - 1,  ///< Enable all flags.
+    RPS_DIAGNOSTIC_ENABLE_ALL = (1 << 6) - 1,  ///< Enable all flags.
 } RpsDiagnosticFlagBits;
 
 /// @brief Bitmask type for <c><i>RpsDiagnosticFlagBits</i></c>.
@@ -189,11 +198,72 @@ typedef enum RpsRenderGraphFlagBits
     RPS_RENDER_GRAPH_NO_GPU_MEMORY_ALIASING     = 1 << 1,  ///< Disables GPU memory aliasing.
     RPS_RENDER_GRAPH_NO_LIFETIME_ANALYSIS       = 1 << 2,  ///< Disables lifetime analysis unless required by other
                                                            ///  core features, e.g. memory aliasing.
+    RPS_RENDER_GRAPH_INCREMENTAL_UPDATE         = 1 << 3,  ///< Reuses the DAG, schedule, transitions, aliasing and
+                                                           ///  batch layout of the previous update if the commands,
+                                                           ///  their accesses, resource descriptions and explicit
+                                                           ///  dependencies are unchanged. Per-frame arguments are
+                                                           ///  still re-bound every update.
+    RPS_RENDER_GRAPH_COMPACT_HEAPS              = 1 << 4,  ///< Compacts the heaps of a memory type once their size
+                                                           ///  exceeds a compacted placement of the current resources
+                                                           ///  by more than memoryInfo.compactionThresholdPercent.
+                                                           ///  Resources are moved out of the old heaps over several
+                                                           ///  updates, and the old heaps are released once
+                                                           ///  gpuCompletedFrameIndex reports the last frame using
+                                                           ///  them as completed.
+    RPS_RENDER_GRAPH_SUBRESOURCE_LIFETIMES      = 1 << 5,  ///< Records the lifetime of each subresource in addition
+                                                           ///  to the lifetime of each resource, for the resource
+                                                           ///  diagnostic info and the memory budget report. The
+                                                           ///  memory of idle subresources is not aliased. Only
+                                                           ///  takes effect while lifetime analysis is enabled.
+    RPS_RENDER_GRAPH_SMALL_RESOURCE_PAGES       = 1 << 6,  ///< Sub-allocates resources smaller than 64 KiB from
+                                                           ///  64 KiB pages of the heaps, which are held for the
+                                                           ///  whole frame. Resources within a page alias by
+                                                           ///  lifetime.
 } RpsRenderGraphFlagBits;
 
 /// @brief Bitmask type for <c><i>RpsRenderGraphFlagBits</i></c>.
 typedef RpsFlags32 RpsRenderGraphFlags;
 
+/// @brief Strategies for placing transient resources in memory heaps.
+typedef enum RpsMemoryPlacementStrategy
+{
+    /// Uses the default strategy, RPS_MEMORY_PLACEMENT_BEST_FIT.
+    RPS_MEMORY_PLACEMENT_DEFAULT = 0,
+
+    /// Places each resource in the free heap range with the least space left over.
+    RPS_MEMORY_PLACEMENT_BEST_FIT,
+
+    /// Places each resource in the first free heap range it fits in, starting at the lowest heap index and offset.
+    /// This is the cheapest strategy per update, but may use more memory than RPS_MEMORY_PLACEMENT_BEST_FIT.
+    RPS_MEMORY_PLACEMENT_FIRST_FIT,
+
+    /// Packs the resources of a memory type in several orders (by size, by size * lifetime, by lifetime length and by
+    /// lifetime start), each with best fit and first fit, and keeps the combination with the lowest heap usage. This
+    /// is several times more expensive than RPS_MEMORY_PLACEMENT_BEST_FIT. Packing only runs if no resource of the
+    /// memory type holds a placement from a previous update, so its result is kept as long as the resources do not
+    /// need to be placed again. Otherwise new resources are placed with best fit.
+    RPS_MEMORY_PLACEMENT_MIN_MEMORY,
+
+    RPS_MEMORY_PLACEMENT_COUNT,  ///< Count of defined placement strategy values.
+} RpsMemoryPlacementStrategy;
+
+/// @brief Modes for overriding GPU memory aliasing in a single render graph update.
+typedef enum RpsMemoryAliasingMode
+{
+    /// Aliases memory unless the render graph is created with RPS_RENDER_GRAPH_NO_GPU_MEMORY_ALIASING.
+    RPS_MEMORY_ALIASING_DEFAULT = 0,
+
+    /// Aliases memory of resources with disjoint lifetimes. Requires lifetime analysis, so fails with
+    /// RPS_ERROR_INVALID_OPERATION if the render graph is created with both RPS_RENDER_GRAPH_NO_GPU_MEMORY_ALIASING and
+    /// RPS_RENDER_GRAPH_NO_LIFETIME_ANALYSIS.
+    RPS_MEMORY_ALIASING_ENABLED,
+
+    /// Gives every resource memory of its own.
+    RPS_MEMORY_ALIASING_DISABLED,
+
+    RPS_MEMORY_ALIASING_MODE_COUNT,  ///< Count of defined memory aliasing mode values.
+} RpsMemoryAliasingMode;
+
 /// @brief Constant for the maximum number of hardware queues in use by RPS.
 #define RPS_MAX_QUEUES (8)
 
@@ -344,6 +414,25 @@ typedef RpsResult (*PFN_rpsRenderGraphBuild)(RpsRenderGraphBuilder hBuilder,
                                              const RpsConstant*    pArgs,
                                              uint32_t              numArgs);
 
+/// @brief Signature of functions for estimating the GPU execution time of a node.
+///
+/// The estimates are only used to compare nodes with each other, so any unit can be used as long as it is consistent
+/// for all nodes of a render graph, e.g. microseconds measured with GPU timestamps in a previous frame.
+///
+/// @param pContext                 Context for estimating node times.
+/// @param nodeId                   ID of the node, as returned by rpsCmdGetNodeId or rpsRenderGraphAddNode.
+/// @param pNodeName                Null terminated name of the node declaration. Can be NULL for unnamed nodes.
+///
+/// @returns                        Estimated GPU time of the node. Negative values are treated as 0.
+typedef float (*PFN_rpsEstimateNodeTime)(void* pContext, RpsNodeId nodeId, const char* pNodeName);
+
+/// @brief Node time estimator interface.
+typedef struct RpsNodeTimeEstimator
+{
+    PFN_rpsEstimateNodeTime pfnEstimateNodeTime;  ///< Pointer to a function for estimating the GPU time of a node.
+    void*                   pContext;             ///< Context to be passed to the estimator function.
+} RpsNodeTimeEstimator;
+
 /// @brief Parameters for updating a render graph.
 ///
 /// @relates RpsRenderGraph
@@ -383,6 +472,20 @@ typedef struct RpsRenderGraphUpdateInfo
     /// Pointer to a random number generator. Only required if any randomized behavior is used, e.g.
     /// RPS_SCHEDULE_RANDOM_ORDER_BIT.
     const RpsRandomNumberGenerator* pRandomNumberGenerator;
+
+    /// Pointer to a node time estimator. Optional, passing NULL schedules without GPU time estimates. If provided and
+    /// multiple queues are used, the scheduler keeps a timeline per queue and favors nodes on the critical path and
+    /// nodes that fill idle time of other queues. The estimates are queried every update, changing them invalidates
+    /// a schedule kept by RPS_RENDER_GRAPH_INCREMENTAL_UPDATE or RPS_SCHEDULE_AVOID_RESCHEDULE_BIT, so measured times
+    /// should be smoothed or quantized before being returned.
+    const RpsNodeTimeEstimator* pNodeTimeEstimator;
+
+    /// Memory aliasing mode of this update, overriding RPS_RENDER_GRAPH_NO_GPU_MEMORY_ALIASING. Switching modes does
+    /// not recreate resources: placements still valid in the new mode are kept, only resources sharing memory they
+    /// may no longer share are placed again. Resources placed without aliasing keep their placements after aliasing is
+    /// enabled, so heaps only shrink as resources are recreated or compacted with RPS_RENDER_GRAPH_COMPACT_HEAPS.
+    /// Ignored by backends without placed resources, e.g. D3D11.
+    RpsMemoryAliasingMode memoryAliasingMode;
 } RpsRenderGraphUpdateInfo;
 
 /// @brief Constant for the maximum number of supported frames which can be queued on the GPU simultaneously.
@@ -588,6 +691,48 @@ RpsResult rpsProgramBindNodeSubprogram(RpsSubprogram hProgram, const char* name,
 /// @addtogroup RpsRenderGraphRuntime
 /// @{
 
+/// @brief Signature of functions executing a single task of a parallel job.
+///
+/// @param pTaskContext                         Context of the job, as passed to PFN_rpsTaskSystemEnqueueJob.
+/// @param taskIndex                            Index of the task in [0, numTasks) of the job.
+typedef void (*PFN_rpsTask)(void* pTaskContext, uint32_t taskIndex);
+
+/// @brief Signature of functions enqueueing a parallel job into a task system.
+///
+/// The task system is expected to call pfnTask once for each task index in [0, numTasks), in any order and on any
+/// thread.
+///
+/// @param pUserContext                         User context of the task system. See <c><i>RpsTaskSystem</i></c>.
+/// @param pfnTask                              Pointer to the task function.
+/// @param pTaskContext                         Context to be passed to the task function.
+/// @param numTasks                             Number of tasks of the job.
+///
+/// @returns                                    Opaque handle to the job, passed to PFN_rpsTaskSystemWaitJob.
+typedef void* (*PFN_rpsTaskSystemEnqueueJob)(void*       pUserContext,
+                                             PFN_rpsTask pfnTask,
+                                             void*       pTaskContext,
+                                             uint32_t    numTasks);
+
+/// @brief Signature of functions waiting for all tasks of a parallel job to complete.
+///
+/// @param pUserContext                         User context of the task system. See <c><i>RpsTaskSystem</i></c>.
+/// @param hJob                                 Handle to the job as returned by PFN_rpsTaskSystemEnqueueJob.
+typedef void (*PFN_rpsTaskSystemWaitJob)(void* pUserContext, void* hJob);
+
+/// @brief Task system used to split data-parallel work of render graph updates across multiple threads.
+///
+/// If pfnEnqueueJob is NULL, all render graph update work runs on the thread calling rpsRenderGraphUpdate.
+typedef struct RpsTaskSystem
+{
+    PFN_rpsTaskSystemEnqueueJob pfnEnqueueJob;     ///< Pointer to a function for enqueueing a parallel job.
+    PFN_rpsTaskSystemWaitJob    pfnWaitJob;        ///< Pointer to a function for waiting on a parallel job. Must not
+                                                   ///  be NULL if pfnEnqueueJob is not NULL.
+    uint32_t                    numWorkerThreads;  ///< Number of threads executing tasks concurrently. Used to decide
+                                                   ///  how many tasks a job is split into. If 0, RPS uses the number
+                                                   ///  of hardware threads.
+    void*                       pUserContext;      ///< Context to be passed to the task system functions.
+} RpsTaskSystem;
+
 /// @brief Parameters for creating a render graph.
 typedef struct RpsRenderGraphCreateInfo
 {
@@ -598,14 +743,37 @@ typedef struct RpsRenderGraphCreateInfo
                                            ///  is 1 graphics queue.
         const RpsQueueFlags* pQueueInfos;  ///< Pointer to an array of <c><i>RpsQueueFlags</i></c> with numQueues queue
                                            ///  flags. Must not be NULL if numQueues != 0.
+        uint32_t numMemoryFeedbackIterations;  ///< Maximum number of times a new schedule is computed again with
+                                               ///  the resources live at the peak memory usage of the previous
+                                               ///  schedule weighted higher. Stops once the heap size stops
+                                               ///  improving, keeping the schedule with the smallest heaps. Only
+                                               ///  runs when the schedule is not replayed, so combine with
+                                               ///  RPS_SCHEDULE_AVOID_RESCHEDULE_BIT to only pay for it when the
+                                               ///  graph changes. If 0, the first schedule is kept.
     } scheduleInfo;
 
     struct
     {
-        uint32_t        numHeaps;        ///< Number of memory heaps available to the render graph.
+        uint32_t        numHeaps;        ///< Number of entries in heapBudgetMiBs.
         const uint32_t* heapBudgetMiBs;  ///< Pointer to an array of <c><i>uint32_t</i></c> numHeaps memory sizes as
-                                         ///  limits on the amount of memory to be used. Must not be NULL if
-                                         ///  numHeaps != 0.
+                                         ///  limits on the amount of memory to be used, indexed by memory type. 0 or
+                                         ///  a memory type index beyond numHeaps means no limit. If the heaps of a
+                                         ///  memory type exceed its budget, the update is scheduled once more with
+                                         ///  RPS_SCHEDULE_PREFER_MEMORY_SAVING_BIT, and fails with
+                                         ///  RPS_ERROR_OUT_OF_MEMORY if the budget is still exceeded. Must not be
+                                         ///  NULL if numHeaps != 0.
+        RpsMemoryPlacementStrategy placementStrategy;  ///< Strategy for placing transient resources in heaps.
+        uint32_t compactionThresholdPercent;     ///< Percentage by which the heaps of a memory type may exceed a
+                                                 ///  compacted placement before they are compacted, if
+                                                 ///  RPS_RENDER_GRAPH_COMPACT_HEAPS is set. If 0, RPS uses 25.
+        uint32_t maxCompactionMovesPerUpdate;    ///< Maximum number of resources re-created per update to compact
+                                                 ///  heaps, bounding the cost of compaction in a single frame. If 0,
+                                                 ///  RPS uses 16.
+        uint64_t defaultHeapSize;                ///< Size in bytes of the heaps created for transient resources,
+                                                 ///  overriding RpsMemoryTypeInfo::defaultHeapSize of every memory
+                                                 ///  type. Resources larger than the default heap size of their
+                                                 ///  memory type are placed in dedicated heaps sized to fit. If 0,
+                                                 ///  the defaults of the runtime device are used.
     } memoryInfo;
 
     RpsProgramCreateInfo mainEntryCreateInfo;  ///< Creation parameters for the main entry RPS program.
@@ -618,6 +786,10 @@ typedef struct RpsRenderGraphCreateInfo
     /// used by the render graph. If null, RPS uses the runtime specified default pipeline to process the render graph.
     const RpsRenderGraphPhaseInfo* pPhases;
 
+    /// Optional task system to run data-parallel parts of render graph updates on. The job functions are called from
+    /// the thread calling rpsRenderGraphUpdate, and a job is always waited on before the update continues.
+    RpsTaskSystem taskSystem;
+
 } RpsRenderGraphCreateInfo;
 
 /// @brief Creates a render graph.
@@ -882,11 +1054,22 @@ typedef struct RpsCmdDiagnosticInfo
             RpsAccessAttr       nextAccess;     ///< Access after the current transition.
             RpsSubresourceRange range;          ///< Access range for the transition.
             uint32_t            resourceIndex;  ///< Index of the resource to transition.
+            RpsBool             isSplitBegin;   ///< Indicator for the begin half of a split transition.
+            RpsBool             isSplitEnd;     ///< Indicator for the end half of a split transition.
         } transition;
     };
 
 } RpsCmdDiagnosticInfo;
 
+/// @brief Lifetime of a subresource, as indices of the first and last commands accessing it.
+///
+/// lifetimeBegin is greater than lifetimeEnd if the subresource is not accessed.
+typedef struct RpsSubresourceLifetime
+{
+    uint32_t lifetimeBegin;  ///< Index of the first command accessing the subresource.
+    uint32_t lifetimeEnd;    ///< Index of the last command accessing the subresource.
+} RpsSubresourceLifetime;
+
 /// @brief Diagnostic information for a resource.
 typedef struct RpsResourceDiagnosticInfo
 {
@@ -905,6 +1088,10 @@ typedef struct RpsResourceDiagnosticInfo
     RpsGpuMemoryRequirement allocRequirement;  ///< Allocation requirements for the memory of the resource.
     RpsHeapPlacement        allocPlacement;    ///< Allocation placement for the memory of the resource.
     RpsRuntimeResource      hRuntimeResource;  ///< Handle to the backend specific resource.
+    uint32_t numSubresourceLifetimes;          ///< Number of entries in pSubresourceLifetimes. 0 unless the render
+                                               ///  graph is created with RPS_RENDER_GRAPH_SUBRESOURCE_LIFETIMES.
+    const RpsSubresourceLifetime* pSubresourceLifetimes;  ///< Pointer to the lifetimes of the subresources, ordered
+                                                          ///  by aspect, then array layer, then mip level.
 } RpsResourceDiagnosticInfo;
 
 /// @brief Diagnostic information for a heap.
@@ -934,6 +1121,15 @@ typedef struct RpsRenderGraphDiagnosticInfo
 
     /// Pointer to an array of <c><i>RpsHeapDiagnosticInfo</i></c> with numHeapInfos heap infos.
     const RpsHeapDiagnosticInfo* pHeapDiagInfos;
+
+    /// Indicator for the latest update reusing the structure of the previous one instead of rebuilding and
+    /// rescheduling the graph. Only set with <c><i>RPS_RENDER_GRAPH_INCREMENTAL_UPDATE</i></c>.
+    RpsBool isStructureReused;
+
+    /// Number of schedules computed by the latest update. 0 if the previous schedule was replayed, see
+    /// <c><i>RPS_SCHEDULE_AVOID_RESCHEDULE_BIT</i></c>, or the structure was reused. More than 1 if the update was
+    /// rescheduled for memory saving or memory feedback.
+    uint32_t numSchedulesComputed;
 } RpsRenderGraphDiagnosticInfo;
 
 /// @brief Bitflags for diagnostic info modes.
@@ -1035,8 +1231,8 @@ typedef struct RpsCmdRenderPassBeginInfo
 ///
 /// The cloned context inherits states from the context being cloned, such as current command info and command
 /// arguments. The typical use case is multi-threaded command recording from within a node callback.
-/// Must be synchronized by the caller if called from multiple threads. The created context pointer is valid until the
-/// next render graph update.
+/// Safe to call from multiple threads concurrently, including on contexts cloned by other threads. The created context
+/// pointer is valid until the next render graph update.
 ///
 /// @param pContext                             Pointer to the current command callback context.
 /// @param hCmdBufferForDerivedContext          Handle to the command buffer to be associated with the new context.
@@ -1089,6 +1285,17 @@ RpsResult rpsCmdSetCommandBuffer(const RpsCmdCallbackContext* pContext, RpsRunti
 /// @return                                     Result code of the operation. See <c><i>RpsResult</i></c> for more info.
 RpsResult rpsCmdGetNodeName(const RpsCmdCallbackContext* pContext, const char** ppNodeName, size_t* pNodeNameLength);
 
+/// @brief Gets the ID of the current cmd node.
+///
+/// The ID is stable as long as the render graph structure does not change, which allows e.g. GPU times measured in a
+/// node callback to be returned by a <c><i>RpsNodeTimeEstimator</i></c> in a later update.
+///
+/// @param pContext                             Pointer to the current command callback context. Must not be NULL.
+/// @param pNodeId                              Pointer in which the node ID is returned. Must not be NULL.
+///
+/// @return                                     Result code of the operation. See <c><i>RpsResult</i></c> for more info.
+RpsResult rpsCmdGetNodeId(const RpsCmdCallbackContext* pContext, RpsNodeId* pNodeId);
+
 /// @brief Gets the description of a node argument.
 ///
 /// @param pContext                             Pointer to the current command callback context. Must not be NULL.
@@ -1201,36 +1408,84 @@ static inline RpsVariable rpsCmdGetArg(const RpsCmdCallbackContext* pContext, ui
 
 /// @brief Signature of functions for acquiring command buffers in a simplified execution mode.
 ///
-/// Reserved for future use.
+/// Called from the thread calling rpsRenderGraphExecute, before any commands are recorded into the command buffers.
+///
+/// @param pUserContext                     User context passed as RpsRenderGraphExecuteInfo::pUserContext.
+/// @param queueIndex                       Index of the queue the command buffers will be submitted to.
+/// @param numCmdBuffers                    Number of command buffers to acquire.
+/// @param pCmdBuffers                      Pointer to an array of numCmdBuffers command buffer handles in which the
+///                                         acquired command buffers are returned. The command buffers must be ready
+///                                         for recording.
+///
+/// @returns                                Result code of the operation. See <c><i>RpsResult</i></c> for more info.
 typedef RpsResult (*PFN_rpsAcquireRuntimeCommandBuffer)(void*                    pUserContext,
                                                         uint32_t                 queueIndex,
                                                         uint32_t                 numCmdBuffers,
-                                                        RpsRuntimeCommandBuffer* pCmdBuffers,
-                                                        uint32_t*                pCmdBufferIdentifiers);
+                                                        RpsRuntimeCommandBuffer* pCmdBuffers);
 
 /// @brief Signature of functions for submitting command buffers in a simplified execution mode.
 ///
-/// Reserved for future use.
+/// Called from the thread calling rpsRenderGraphExecute, once per command batch and in batch order.
+///
+/// @param pUserContext                     User context passed as RpsRenderGraphExecuteInfo::pUserContext.
+/// @param queueIndex                       Index of the queue to submit to.
+/// @param pRuntimeCmdBufs                  Pointer to an array of numRuntimeCmdBufs recorded command buffers, to be
+///                                         submitted in array order.
+/// @param numRuntimeCmdBufs                Number of command buffers to submit. Can be 0 for batches only waiting for
+///                                         or signaling fences.
+/// @param pWaitFenceIndices                Pointer to an array of numWaitFences indices of fences to wait for before
+///                                         executing the command buffers. Each index refers to the signalFenceIndex of
+///                                         a previously submitted batch.
+/// @param numWaitFences                    Number of fences to wait for.
+/// @param signalFenceIndex                 Index of the fence to signal after the command buffers have executed, or
+///                                         RPS_INDEX_NONE_U32 if no fence needs to be signaled.
+///
+/// @returns                                Result code of the operation. See <c><i>RpsResult</i></c> for more info.
 typedef RpsResult (*PFN_rpsSubmitRuntimeCommandBuffer)(void*                          pUserContext,
                                                        uint32_t                       queueIndex,
                                                        const RpsRuntimeCommandBuffer* pRuntimeCmdBufs,
                                                        uint32_t                       numRuntimeCmdBufs,
-                                                       uint32_t                       waitId,
-                                                       uint32_t                       signalId);
+                                                       const uint32_t*                pWaitFenceIndices,
+                                                       uint32_t                       numWaitFences,
+                                                       uint32_t                       signalFenceIndex);
+
+/// @brief Signature of functions returning the relative CPU recording cost of a command node.
+///
+/// @param pUserContext                     User context passed as RpsRenderGraphExecuteInfo::pUserContext.
+/// @param nodeId                           ID of the command node, as returned by rpsRenderGraphAddNode.
+///
+/// @returns                                Relative cost of recording the node. 0 marks nodes which are negligible
+///                                         to record.
+typedef uint32_t (*PFN_rpsGetCmdRecordCost)(void* pUserContext, RpsNodeId nodeId);
 
 /// @brief Parameters for executing a render graph.
 typedef struct RpsRenderGraphExecuteInfo
 {
     void* pUserContext;                                            ///< Pointer to a user defined context to be passed
-                                                                   ///  to the callbacks.
+                                                                   ///  to the callbacks. Also passed as
+                                                                   ///  RpsCmdCallbackContext::pUserRecordContext.
     PFN_rpsAcquireRuntimeCommandBuffer pfnAcquireRuntimeCmdBufCb;  ///< Pointer to a function to acquire command
-                                                                   ///  buffers.
+                                                                   ///  buffers. Must not be NULL.
     PFN_rpsSubmitRuntimeCommandBuffer pfnSubmitRuntimeCmdBufCb;    ///< Pointer to a function to submit command
-                                                                   ///  buffers.
+                                                                   ///  buffers. Must not be NULL.
+    PFN_rpsGetCmdRecordCost pfnGetCmdRecordCostCb;                 ///< Pointer to a function returning per node
+                                                                   ///  recording cost hints used to balance recording
+                                                                   ///  jobs. If NULL, each node has a cost of 1.
+    uint64_t              frameIndex;                              ///< Index of the frame to record commands for.
+    RpsRecordCommandFlags recordFlags;                             ///< Flags for specifying recording behavior.
+    uint32_t              minRecordCostPerCmdBuffer;               ///< Minimum total cost of the nodes recorded into
+                                                                   ///  one command buffer, to amortize the overhead of
+                                                                   ///  additional command buffers. 0 is treated as 1.
 } RpsRenderGraphExecuteInfo;
 
 /// @brief Executes a render graph.
 ///
+/// Records and submits all command batches of the most recent update. Each batch is split into one or more recording
+/// jobs balanced by the node recording costs, each recording into its own command buffer. If the render graph was
+/// created with a task system (see <c><i>RpsRenderGraphCreateInfo::taskSystem</i></c>), the jobs of all batches are
+/// recorded in parallel through it, otherwise each batch is recorded into a single command buffer on the calling
+/// thread. Command buffers are acquired and submitted from the calling thread.
+///
 /// @param hRenderGraph                                 Handle to the render graph. Must not be RPS_NULL_HANDLE.
 /// @param pExecuteInfo                                 Pointer to render graph execution parameters. Must not be NULL.
 ///
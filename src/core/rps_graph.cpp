@@ -12,7 +12,8 @@
 namespace rps
 {
     Graph::Graph(const Device& device, Arena& arena)
-        : m_nodes(&arena)
+        : m_pArena(&arena)
+        , m_nodes(&arena)
         , m_edges(&arena)
         , m_subgraphs(&arena)
         , m_edgeListPool(m_edges)
@@ -58,9 +59,93 @@ namespace rps
 
     void Graph::AddToEdgeList(Span<Edge>& edgeList, Edge newEdge)
     {
+        // Packed lists have no spare capacity, move them back to the pool first.
+        if (!edgeList.empty() && (edgeList.GetBegin() < m_numFrozenEdges))
+        {
+            Span<Edge> pooledList;
+            m_edgeListPool.alloc_span(pooledList, edgeList.size());
+            pooledList.SetCount(edgeList.size());
+
+            auto srcEdges = edgeList.Get(m_edges);
+            std::copy(srcEdges.begin(), srcEdges.end(), pooledList.Get(m_edges).begin());
+
+            edgeList = pooledList;
+        }
+
         m_edgeListPool.push_to_span(edgeList, newEdge);
     }
 
+    void Graph::PackEdgeList(Span<Edge>& edgeList, ConstArrayRef<Edge> srcEdges, uint32_t& offset)
+    {
+        auto src = edgeList.GetConstRef(srcEdges);
+        std::copy(src.begin(), src.end(), m_edges.begin() + offset);
+
+        edgeList.SetRange(offset, edgeList.size());
+        offset += edgeList.size();
+    }
+
+    RpsResult Graph::Freeze()
+    {
+        uint32_t numEdges = 0;
+
+        for (const Node& node : m_nodes)
+        {
+            numEdges += node.outEdges.size() + node.inEdges.size();
+        }
+
+        // The pooled lists stay readable, arena allocations are only released when the build arena is reset.
+        const ConstArrayRef<Edge> pooledEdges = m_edges.crange_all();
+
+        m_edges.reset(m_pArena);
+        RPS_CHECK_ALLOC(m_edges.resize(numEdges));
+
+        uint32_t offset = 0;
+
+        for (Node& node : m_nodes)
+        {
+            PackEdgeList(node.outEdges, pooledEdges, offset);
+        }
+
+        for (Node& node : m_nodes)
+        {
+            PackEdgeList(node.inEdges, pooledEdges, offset);
+        }
+
+        RPS_ASSERT(offset == numEdges);
+
+        m_edgeListPool.reset();
+        m_numFrozenEdges = numEdges;
+        m_bFrozen        = true;
+
+        return RPS_OK;
+    }
+
+    bool Graph::HasEdge(NodeId fromNode, NodeId toNode) const
+    {
+        const Node& from = m_nodes[fromNode];
+        const Node& to   = m_nodes[toNode];
+
+        // Scan the shorter of the two edge lists.
+        if (from.outEdges.size() <= to.inEdges.size())
+        {
+            for (const Edge& e : from.outEdges.Get(m_edges))
+            {
+                if (e.dst == toNode)
+                    return true;
+            }
+        }
+        else
+        {
+            for (const Edge& e : to.inEdges.Get(m_edges))
+            {
+                if (e.src == fromNode)
+                    return true;
+            }
+        }
+
+        return false;
+    }
+
     bool Graph::IsParentSubgraph(uint32_t parentSubgraphId, uint32_t childSubgraphId) const
     {
         if ((parentSubgraphId == RPS_INDEX_NONE_U32) || (childSubgraphId == RPS_INDEX_NONE_U32))
@@ -78,12 +163,16 @@ namespace rps
         return currIdx == parentSubgraphId;
     }
 
-    void Graph::Reset()
+    void Graph::Reset(Arena& buildArena)
     {
         m_nodes.reset();
-        m_edges.reset();
+        m_edges.reset(&buildArena);
         m_subgraphs.reset();
         m_edgeListPool.reset();
+
+        m_numPrunedEdges = 0;
+        m_numFrozenEdges = 0;
+        m_bFrozen        = false;
     }
 
 }  // namespace rps
@@ -124,6 +124,19 @@ namespace rps
             AddToEdgeList(m_nodes[toNode].inEdges, Edge{fromNode, toNode});
         }
 
+        bool HasEdge(NodeId fromNode, NodeId toNode) const;
+
+        // Number of edges skipped while building the graph because other edges already imply them.
+        uint32_t GetNumPrunedEdges() const
+        {
+            return m_numPrunedEdges;
+        }
+
+        void AddPrunedEdges(uint32_t numEdges)
+        {
+            m_numPrunedEdges += numEdges;
+        }
+
         SubgraphId AddSubgraph(uint32_t parentId, RpsSubgraphFlags flags, NodeId beginNode)
         {
             SubgraphId resultId = SubgraphId(m_subgraphs.size());
@@ -138,17 +151,33 @@ namespace rps
 
         bool IsParentSubgraph(uint32_t parentSubgraphId, uint32_t childSubgraphId) const;
 
-        void Reset();
+        // Starts a new graph. Until Freeze, edge lists are pooled in buildArena, which must outlive the build.
+        void Reset(Arena& buildArena);
+
+        // Packs the edge lists into the graph arena in compressed sparse row order: the out edges of all nodes by
+        // node id, followed by their in edges. Edges added afterwards move the list they are added to.
+        RpsResult Freeze();
+
+        bool IsFrozen() const
+        {
+            return m_bFrozen;
+        }
 
     private:
         void AddToEdgeList(Span<Edge>& edgeList, Edge newEdge);
+        void PackEdgeList(Span<Edge>& edgeList, ConstArrayRef<Edge> srcEdges, uint32_t& offset);
 
     private:
+        Arena*                m_pArena;
         ArenaVector<Node>     m_nodes;
         ArenaVector<Edge>     m_edges;
         ArenaVector<Subgraph> m_subgraphs;
 
         SpanPool<Edge, ArenaVector<Edge>> m_edgeListPool;
+
+        uint32_t m_numPrunedEdges = 0;
+        uint32_t m_numFrozenEdges = 0;
+        bool     m_bFrozen        = false;
     };
 }
 
@@ -10,6 +10,9 @@
 
 #include "rps_core.hpp"
 
+#include <atomic>
+#include <mutex>
+
 template <typename T>
 static constexpr T rpsMin(const T lhs, const T rhs)
 {
@@ -222,6 +225,25 @@ static constexpr T* rpsBytePtrInc(void* ptr, size_t size)
     return static_cast<T*>(rpsBytePtrInc(ptr, size));
 }
 
+static constexpr uint64_t RPS_HASH_SEED = 0xcbf29ce484222325ull;
+
+// FNV-1a. Not intended for cryptographic or persistent use.
+static inline uint64_t rpsHashBytes(const void* pData, size_t size, uint64_t hash = RPS_HASH_SEED)
+{
+    const uint8_t* pBytes = static_cast<const uint8_t*>(pData);
+    for (size_t i = 0; i < size; i++)
+    {
+        hash = (hash ^ pBytes[i]) * 0x100000001b3ull;
+    }
+    return hash;
+}
+
+template <typename T, typename = typename std::enable_if<std::is_trivially_copyable<T>::value>::type>
+static inline uint64_t rpsHashValue(const T& value, uint64_t hash = RPS_HASH_SEED)
+{
+    return rpsHashBytes(&value, sizeof(T), hash);
+}
+
 template <typename T,
           typename U,
           typename = typename std::enable_if<(std::is_integral<T>::value || std::is_enum<T>::value) &&
@@ -2139,6 +2161,190 @@ namespace rps
         }
     };
 
+    // Linear allocator which can be allocated from by multiple threads concurrently. Allocations bump an atomic
+    // offset in the current block without locking. Only running out of space takes a lock, so the parent allocator is
+    // never called concurrently. Reset is not thread safe and must not overlap with allocations.
+    class ConcurrentArena
+    {
+        RPS_CLASS_NO_COPY_MOVE(ConcurrentArena);
+
+        struct Block
+        {
+            struct Block*       pNext;
+            size_t              size;
+            std::atomic<size_t> offset;
+        };
+
+        static const size_t DEFAULT_BLOCK_SIZE = 4096;
+
+        std::atomic<Block*> m_pBlocks   = {};
+        std::mutex          m_growMutex;
+        size_t              m_blockSize = DEFAULT_BLOCK_SIZE;
+        const RpsAllocator  m_allocCbs  = {};
+
+    public:
+        ConcurrentArena(const RpsAllocator& parentAllocator, size_t defaultBlockSize = 0)
+            : m_blockSize(defaultBlockSize ? defaultBlockSize : DEFAULT_BLOCK_SIZE)
+            , m_allocCbs(parentAllocator)
+        {
+        }
+
+        ~ConcurrentArena()
+        {
+            FreeBlockList(m_pBlocks.load(std::memory_order_relaxed));
+        }
+
+        void* AlignedAlloc(size_t size, size_t alignment)
+        {
+            Block* pBlock = m_pBlocks.load(std::memory_order_acquire);
+
+            for (;;)
+            {
+                if (pBlock)
+                {
+                    void* pAllocated = TryAllocFromBlock(pBlock, size, alignment);
+                    if (pAllocated)
+                    {
+                        RPS_DEBUG_FILL_MEMORY_ON_POOL_ALLOC(pAllocated, size);
+                        return pAllocated;
+                    }
+                }
+
+                std::lock_guard<std::mutex> lock(m_growMutex);
+
+                // Another thread may have added a block while we were waiting, retry with that first.
+                Block* const pCurrBlock = m_pBlocks.load(std::memory_order_acquire);
+                if (pCurrBlock != pBlock)
+                {
+                    pBlock = pCurrBlock;
+                    continue;
+                }
+
+                // Grow geometrically so that a frame needing more than one block converges to a single block.
+                const size_t minSize   = sizeof(Block) + size + alignment;
+                const size_t blockSize = rpsMax(minSize, pBlock ? (pBlock->size * 2) : m_blockSize);
+
+                Block* pNewBlock = AllocBlock(blockSize);
+                if (!pNewBlock)
+                {
+                    return nullptr;
+                }
+
+                pNewBlock->pNext = pBlock;
+                m_pBlocks.store(pNewBlock, std::memory_order_release);
+
+                pBlock = pNewBlock;
+            }
+        }
+
+        template <typename T>
+        T* New()
+        {
+            static_assert(std::is_trivially_destructible<T>::value, "ConcurrentArena doesn't run destructors.");
+            return static_cast<T*>(AlignedAlloc(sizeof(T), alignof(T)));
+        }
+
+        // Recycles all blocks in use. The largest block is kept as the current block so a steady workload doesn't
+        // touch the parent allocator, smaller blocks are freed.
+        void Reset()
+        {
+            Block* pLargest = nullptr;
+
+            for (Block *pBlock = m_pBlocks.exchange(nullptr, std::memory_order_acq_rel), *pNext = nullptr;
+                 pBlock != nullptr;
+                 pBlock = pNext)
+            {
+                pNext = pBlock->pNext;
+
+                if (!pLargest || (pBlock->size > pLargest->size))
+                {
+                    FreeBlock(pLargest);
+                    pLargest = pBlock;
+                }
+                else
+                {
+                    FreeBlock(pBlock);
+                }
+            }
+
+            if (pLargest)
+            {
+                m_blockSize     = rpsMax(m_blockSize, pLargest->size);
+                pLargest->pNext = nullptr;
+                pLargest->offset.store(0, std::memory_order_relaxed);
+
+                RPS_DEBUG_FILL_MEMORY_ON_POOL_FREE(rpsBytePtrInc(pLargest, sizeof(Block)),
+                                                   (pLargest->size - sizeof(Block)));
+
+                m_pBlocks.store(pLargest, std::memory_order_release);
+            }
+        }
+
+    private:
+        static void* TryAllocFromBlock(Block* pBlock, size_t size, size_t alignment)
+        {
+            void* const  pBase    = rpsBytePtrInc(pBlock, sizeof(Block));
+            const size_t capacity = pBlock->size - sizeof(Block);
+
+            size_t offset = pBlock->offset.load(std::memory_order_relaxed);
+            size_t newOffset;
+
+            do
+            {
+                const size_t alignedOffset = offset + rpsPaddingSize(rpsBytePtrInc(pBase, offset), alignment);
+
+                newOffset = alignedOffset + size;
+
+                if (newOffset > capacity)
+                {
+                    return nullptr;
+                }
+            } while (!pBlock->offset.compare_exchange_weak(offset, newOffset, std::memory_order_relaxed));
+
+            return rpsBytePtrInc(pBase, newOffset - size);
+        }
+
+        Block* AllocBlock(size_t blockSize)
+        {
+            void* pNewBuffer = m_allocCbs.pfnAlloc(m_allocCbs.pContext, blockSize, alignof(Block));
+
+            if (!pNewBuffer)
+            {
+                return nullptr;
+            }
+
+            RPS_DEBUG_FILL_MEMORY_ON_ALLOC(pNewBuffer, blockSize);
+
+            Block* pNewBlock = new (pNewBuffer) Block;
+            pNewBlock->pNext = nullptr;
+            pNewBlock->size  = blockSize;
+            pNewBlock->offset.store(0, std::memory_order_relaxed);
+
+            return pNewBlock;
+        }
+
+        void FreeBlock(Block* pBlock)
+        {
+            if (pBlock)
+            {
+                // Only fill the payload, the block header holds an atomic.
+                RPS_DEBUG_FILL_MEMORY_ON_FREE(rpsBytePtrInc(pBlock, sizeof(Block)), (pBlock->size - sizeof(Block)));
+
+                m_allocCbs.pfnFree(m_allocCbs.pContext, pBlock);
+            }
+        }
+
+        void FreeBlockList(Block* pBlockList)
+        {
+            Block* pNext = nullptr;
+            for (Block* pBlock = pBlockList; pBlock != nullptr; pBlock = pNext)
+            {
+                pNext = pBlock->pNext;
+                FreeBlock(pBlock);
+            }
+        }
+    };
+
     template <typename T>
     class ArenaAllocator
     {
@@ -2443,6 +2649,81 @@ namespace rps
     template <typename T>
     using ArenaFreeListPool = rps::FreeListPool<T, ArenaAllocator<details::FreeListPoolSlot<T>>>;
 
+    // Inputs of a cached result, packed into 32-bit words. Comparing the inputs of an update with the ones a cached
+    // result was computed from, rather than only their hashes, never mistakes changed inputs for unchanged ones.
+    class CacheInputs
+    {
+    public:
+        CacheInputs(Arena* pArena)
+            : m_words(pArena)
+        {
+        }
+
+        void Reset(Arena* pArena)
+        {
+            m_words.reset(pArena);
+            m_bAllocFailed = false;
+        }
+
+        template <typename T, typename = typename std::enable_if<std::is_trivially_copyable<T>::value>::type>
+        void Add(const T& value)
+        {
+            AddBytes(&value, sizeof(T));
+        }
+
+        void AddBytes(const void* pData, size_t size)
+        {
+            if (size == 0)
+            {
+                return;
+            }
+
+            uint32_t* pWords = m_words.grow((size + sizeof(uint32_t) - 1) / sizeof(uint32_t), 0u);
+
+            if (pWords == nullptr)
+            {
+                m_bAllocFailed = true;
+                return;
+            }
+
+            memcpy(pWords, pData, size);
+        }
+
+        // Allocation failures of Add are reported here, so gathering the inputs doesn't need to check each of them.
+        bool IsValid() const
+        {
+            return !m_bAllocFailed;
+        }
+
+        bool CopyFrom(const CacheInputs& other)
+        {
+            if (!m_words.resize(other.m_words.size()))
+            {
+                return false;
+            }
+
+            std::copy(other.m_words.begin(), other.m_words.end(), m_words.begin());
+            m_bAllocFailed = other.m_bAllocFailed;
+
+            return true;
+        }
+
+        bool operator==(const CacheInputs& other) const
+        {
+            return (m_words.size() == other.m_words.size()) &&
+                   std::equal(m_words.begin(), m_words.end(), other.m_words.begin());
+        }
+
+        bool operator!=(const CacheInputs& other) const
+        {
+            return !(*this == other);
+        }
+
+    private:
+        ArenaVector<uint32_t> m_words;
+        bool                  m_bAllocFailed = false;
+    };
+
     namespace details
     {
         template <typename T>
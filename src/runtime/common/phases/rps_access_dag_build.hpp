@@ -23,6 +23,11 @@ namespace rps
         {
         }
 
+        virtual bool IsStructuralPhase() const override final
+        {
+            return true;
+        }
+
         virtual RpsResult Run(RenderGraphUpdateContext& context) override final
         {
             RPS_ASSERT(&m_renderGraph == &context.renderGraph);
@@ -38,6 +43,12 @@ namespace rps
             m_subResStates.reset_keep_capacity(&context.scratchArena);
             m_nodeRefLists.reset_keep_capacity(&context.scratchArena);
             m_nodeRefListPool.reset();
+            m_accessorMarks.reset_keep_capacity(&context.scratchArena);
+            RPS_CHECK_ALLOC(m_accessorMarks.resize(cmds.size(), RenderGraph::INVALID_TRANSITION));
+            m_coveredStates.reset_keep_capacity(&context.scratchArena);
+            m_mergeCandidates.reset_keep_capacity(&context.scratchArena);
+            m_coalescedNodes.reset_keep_capacity(&context.scratchArena);
+            RPS_CHECK_ALLOC(m_coalescedNodes.resize(resourceInsts.size(), RPS_INDEX_NONE_U32));
 
             RPS_V_RETURN(InitResourceStates());
 
@@ -65,121 +76,58 @@ namespace rps
 
                 auto cmdAccesses = m_renderGraph.GetCmdAccesses(iCmd);
 
-                for (uint32_t iPass = 0; iPass < NumAccessDAGPasses; iPass++)
+                if (cmdAccesses.size() <= MAX_MASK_BITS)
                 {
-                    // TODO: Bitmask R/W accesses per node for common cases where access count is limited.
-                    for (const CmdAccessInfo& currAccess : cmdAccesses)
+                    // Common case, sort the accesses into a write and a read mask once instead of filtering them in
+                    // each pass.
+                    uint64_t passAccessMasks[NumAccessDAGPasses] = {};
+
+                    for (uint32_t iAccess = 0; iAccess < cmdAccesses.size(); iAccess++)
                     {
-                        if (currAccess.resourceId == RPS_RESOURCE_ID_INVALID)
-                            continue;
+                        const CmdAccessInfo& currAccess = cmdAccesses[iAccess];
 
-                        if (((iPass == WriteAccessDAGPass) &&
-                             !(currAccess.access.accessFlags & RPS_ACCESS_ALL_GPU_WRITE)) ||
-                            ((iPass == ReadAccessDAGPass) &&
-                             (currAccess.access.accessFlags & RPS_ACCESS_ALL_GPU_WRITE)))
-                        {
+                        if (currAccess.resourceId == RPS_RESOURCE_ID_INVALID)
                             continue;
-                        }
 
-                        ResourceInstance& resInfo = resourceInsts[currAccess.resourceId];
+                        const uint32_t iPass = (currAccess.access.accessFlags & RPS_ACCESS_ALL_GPU_WRITE)
+                                                   ? WriteAccessDAGPass
+                                                   : ReadAccessDAGPass;
 
-                        const bool isSingleSubresource = (resInfo.numSubResources == 1);
-
-                        // Previous states
-                        ResourceState& resState     = m_resourceStates[currAccess.resourceId];
-                        auto           subResStates = resState.subResStates.Get(m_subResStates);
-
-                        // Set initial state
-                        if ((resInfo.initialAccess.accessFlags == RPS_ACCESS_UNKNOWN) &&
-                            ((!isSingleSubresource && subResStates[0].access.accessorNodes.empty()) ||
-                             resState.access.accessorNodes.empty()))
-                        {
-                            RPS_ASSERT((isSingleSubresource && subResStates.empty()) || (subResStates.size() == 1));
-
-                            resInfo.SetInitialAccess(currAccess.access);
-                        }
-
-                        // Buffers and single-subresource images: simple path
+                        passAccessMasks[iPass] |= (uint64_t(1) << iAccess);
+                    }
 
-                        if (isSingleSubresource)
+                    for (uint32_t iPass = 0; iPass < NumAccessDAGPasses; iPass++)
+                    {
+                        for (uint64_t accessMask = passAccessMasks[iPass]; accessMask != 0;
+                             accessMask &= (accessMask - 1))
                         {
-                            RPS_V_RETURN(ProcessTransition(graph,
-                                                           nodeId,
-                                                           resState.access,
-                                                           currAccess.access,
-                                                           currAccess.resourceId,
-                                                           currAccess.range));
+                            RPS_V_RETURN(ProcessAccess(graph, nodeId, cmdAccesses[rpsFirstBitLow(accessMask)]));
                         }
-                        else
+                    }
+                }
+                else
+                {
+                    for (uint32_t iPass = 0; iPass < NumAccessDAGPasses; iPass++)
+                    {
+                        for (const CmdAccessInfo& currAccess : cmdAccesses)
                         {
-                            // Check each subresource range in previous access ranges
-                            auto prevRanges = resState.subResStates.Get(m_subResStates);
+                            if (currAccess.resourceId == RPS_RESOURCE_ID_INVALID)
+                                continue;
 
-                            for (SubresourceState& prevSubResState : prevRanges)
+                            if (((iPass == WriteAccessDAGPass) &&
+                                 !(currAccess.access.accessFlags & RPS_ACCESS_ALL_GPU_WRITE)) ||
+                                ((iPass == ReadAccessDAGPass) &&
+                                 (currAccess.access.accessFlags & RPS_ACCESS_ALL_GPU_WRITE)))
                             {
-                                SubresourceRangePacked overlapRange;
-                                SubresourceRangePacked remainingRanges[SubresourceRangePacked::MAX_CLIP_COMPLEMENTS];
-                                uint32_t               numRemainingRanges = 0;
-
-                                // Try to clip current access range against existing range
-                                if (SubresourceRangePacked::Clip(prevSubResState.range,
-                                                                 currAccess.range,
-                                                                 remainingRanges,
-                                                                 &numRemainingRanges,
-                                                                 &overlapRange))
-                                {
-                                    RPS_ASSERT(resState.subResStates.size() + numRemainingRanges <=
-                                               resInfo.numSubResources);
-
-                                    const uint32_t newRangeOffset = resState.subResStates.GetEnd();
-                                    resState.subResStates.SetRange(resState.subResStates.GetBegin(),
-                                                                   resState.subResStates.size() + numRemainingRanges);
-
-                                    for (uint32_t iRemaining = 0; iRemaining < numRemainingRanges; iRemaining++)
-                                    {
-                                        SubresourceState& newAccessState = m_subResStates[newRangeOffset + iRemaining];
-
-                                        newAccessState.range = remainingRanges[iRemaining];
-
-                                        RPS_V_RETURN(CloneReferenceList(prevSubResState.access.accessorNodes,
-                                                                        newAccessState.access.accessorNodes));
-
-                                        uint32_t newTransition = RenderGraph::INVALID_TRANSITION;
-                                        if (prevSubResState.access.lastTransition != RenderGraph::INVALID_TRANSITION)
-                                        {
-                                            RPS_V_RETURN(CloneTransition(
-                                                graph, prevSubResState.access.lastTransition, newTransition));
-                                            m_transitions[newTransition].access.range = remainingRanges[iRemaining];
-                                        }
-
-                                        newAccessState.access.lastTransition = newTransition;
-                                    }
-
-                                    // Replace previous transition node's access range to the overlapping region.
-                                    if (prevSubResState.access.lastTransition != RenderGraph::INVALID_TRANSITION)
-                                    {
-                                        auto& access = m_transitions[prevSubResState.access.lastTransition].access;
-
-                                        access.range = overlapRange;
-                                        FilterAccessByRange(access.access, overlapRange);
-                                    }
-
-                                    prevSubResState.range = overlapRange;
-
-                                    auto filteredCurrentAccess = currAccess.access;
-                                    FilterAccessByRange(filteredCurrentAccess, overlapRange);
-
-                                    ProcessTransition(graph,
-                                                      nodeId,
-                                                      prevSubResState.access,
-                                                      filteredCurrentAccess,
-                                                      currAccess.resourceId,
-                                                      overlapRange);
-                                }
+                                continue;
                             }
+
+                            RPS_V_RETURN(ProcessAccess(graph, nodeId, currAccess));
                         }
                     }
                 }
+
+                RPS_V_RETURN(CoalesceSubresourceStates(nodeId, cmdAccesses));
             }
 
             auto& finalAccesses = context.renderGraph.GetResourceFinalAccesses();
@@ -216,6 +164,9 @@ namespace rps
                 }
             }
 
+            // No more nodes are cloned from here on, pack the edges for the scheduling phases.
+            RPS_V_RETURN(graph.Freeze());
+
             // Save high watermark scale by 1.5 for next frame reservation size
             m_transitionCountWatermark = uint32_t(m_transitions.size());
             m_transitionCountWatermark = m_transitionCountWatermark + (m_transitionCountWatermark >> 1);
@@ -224,16 +175,21 @@ namespace rps
         }
 
     private:
+        // Accesses of a node, or subresources of a resource, up to which bit masks are used instead of ranges.
+        static constexpr uint32_t MAX_MASK_BITS = 64;
+
         struct AccessState
         {
             Span<NodeId> accessorNodes;
             uint32_t     lastTransition;
+            bool         bOrderedAccessors;  // Each accessor node has an edge from the one before it.
         };
 
         struct SubresourceState
         {
             AccessState            access;
             SubresourceRangePacked range;
+            uint64_t               subResMask;  // Subresources in range, see GetSubresourceMask. 0 if not used.
         };
 
         struct ResourceState
@@ -267,7 +223,11 @@ namespace rps
                     SubresourceState* pSubResStates = m_subResStates.grow(resInstance.numSubResources, {});
                     RPS_RETURN_ERROR_IF(!pSubResStates, RPS_ERROR_OUT_OF_MEMORY);
 
-                    pSubResStates[0].range = resInstance.fullSubresourceRange;
+                    const auto& fullRange = resInstance.fullSubresourceRange;
+
+                    pSubResStates[0].range = fullRange;
+                    pSubResStates[0].subResMask =
+                        UseSubresourceMasks(resInstance) ? GetSubresourceMask(resInstance, fullRange) : 0;
 
                     // Init size to 0. SubResStates grows as subresource ranges are accessed:
                     m_resourceStates[iRes].subResStates.SetRange(totalSubResources, 1);
@@ -278,6 +238,480 @@ namespace rps
             return RPS_OK;
         }
 
+        RpsResult ProcessAccess(Graph& graph, NodeId nodeId, const CmdAccessInfo& currAccess)
+        {
+            ResourceInstance& resInfo = m_renderGraph.GetResourceInstances()[currAccess.resourceId];
+
+            const bool isSingleSubresource = (resInfo.numSubResources == 1);
+
+            // Previous states
+            ResourceState& resState     = m_resourceStates[currAccess.resourceId];
+            auto           subResStates = resState.subResStates.Get(m_subResStates);
+
+            // Set initial state
+            if ((resInfo.initialAccess.accessFlags == RPS_ACCESS_UNKNOWN) &&
+                ((!isSingleSubresource && subResStates[0].access.accessorNodes.empty()) ||
+                 resState.access.accessorNodes.empty()))
+            {
+                RPS_ASSERT((isSingleSubresource && subResStates.empty()) || (subResStates.size() == 1));
+
+                resInfo.SetInitialAccess(currAccess.access);
+            }
+
+            // Buffers and single-subresource images: simple path
+
+            if (isSingleSubresource)
+            {
+                return ProcessTransition(
+                    graph, nodeId, resState.access, currAccess.access, currAccess.resourceId, currAccess.range);
+            }
+
+            // Images with few subresources track them as bit masks. The states of a resource partition its
+            // subresources, so a state either misses the access, is covered by it and needs no clipping, or is
+            // split. Once all subresources of the access are found, the remaining states can't overlap it.
+            const bool     bUseSubResMasks   = UseSubresourceMasks(resInfo);
+            const uint64_t accessSubResMask  = bUseSubResMasks ? GetSubresourceMask(resInfo, currAccess.range) : 0;
+            uint64_t       pendingSubResMask = accessSubResMask;
+
+            // Clip previous states to the access range, collecting the states covered by it.
+            auto prevRanges = resState.subResStates.Get(m_subResStates);
+
+            m_coveredStates.clear();
+
+            for (uint32_t iState = 0, numStates = prevRanges.size(); iState < numStates; iState++)
+            {
+                SubresourceState& prevSubResState = prevRanges[iState];
+                const uint32_t    stateIndex      = resState.subResStates.GetBegin() + iState;
+
+                if (bUseSubResMasks)
+                {
+                    if (pendingSubResMask == 0)
+                        break;
+
+                    const uint64_t overlapMask = prevSubResState.subResMask & accessSubResMask;
+
+                    RPS_ASSERT(prevSubResState.subResMask == GetSubresourceMask(resInfo, prevSubResState.range));
+                    RPS_ASSERT((overlapMask != 0) ==
+                               SubresourceRangePacked::Intersect(prevSubResState.range, currAccess.range));
+
+                    if (overlapMask == 0)
+                        continue;
+
+                    pendingSubResMask &= ~overlapMask;
+
+                    if (overlapMask == prevSubResState.subResMask)
+                    {
+                        RPS_CHECK_ALLOC(m_coveredStates.push_back(stateIndex));
+                        continue;
+                    }
+                }
+
+                SubresourceRangePacked overlapRange;
+                SubresourceRangePacked remainingRanges[SubresourceRangePacked::MAX_CLIP_COMPLEMENTS];
+                uint32_t               numRemainingRanges = 0;
+
+                // Try to clip current access range against existing range
+                if (SubresourceRangePacked::Clip(prevSubResState.range,
+                                                 currAccess.range,
+                                                 remainingRanges,
+                                                 &numRemainingRanges,
+                                                 &overlapRange))
+                {
+                    RPS_ASSERT(resState.subResStates.size() + numRemainingRanges <= resInfo.numSubResources);
+
+                    const uint32_t newRangeOffset = resState.subResStates.GetEnd();
+                    resState.subResStates.SetRange(resState.subResStates.GetBegin(),
+                                                   resState.subResStates.size() + numRemainingRanges);
+
+                    // The remaining ranges share the previous transition, it already covers them.
+                    for (uint32_t iRemaining = 0; iRemaining < numRemainingRanges; iRemaining++)
+                    {
+                        SubresourceState& newAccessState = m_subResStates[newRangeOffset + iRemaining];
+
+                        newAccessState.range = remainingRanges[iRemaining];
+                        newAccessState.subResMask =
+                            bUseSubResMasks ? GetSubresourceMask(resInfo, remainingRanges[iRemaining]) : 0;
+
+                        RPS_V_RETURN(CloneReferenceList(prevSubResState.access.accessorNodes,
+                                                        newAccessState.access.accessorNodes));
+                        newAccessState.access.bOrderedAccessors = prevSubResState.access.bOrderedAccessors;
+                        newAccessState.access.lastTransition    = prevSubResState.access.lastTransition;
+                    }
+
+                    prevSubResState.range = overlapRange;
+                    prevSubResState.subResMask &= accessSubResMask;
+
+                    RPS_CHECK_ALLOC(m_coveredStates.push_back(stateIndex));
+                }
+            }
+
+            uint32_t numMergedStates = 0;
+
+            if (m_coveredStates.size() > 1)
+            {
+                RPS_V_RETURN(MergeTransitionStates(nodeId, currAccess, numMergedStates));
+            }
+
+            for (uint32_t stateIndex : m_coveredStates)
+            {
+                SubresourceState& coveredState = m_subResStates[stateIndex];
+
+                if (!IsMergedAway(coveredState))
+                {
+                    RPS_V_RETURN(ProcessSubresourceOverlap(graph, nodeId, currAccess, coveredState));
+                }
+            }
+
+            if (numMergedStates > 0)
+            {
+                CompactSubresourceStates(resState);
+            }
+
+            return RPS_OK;
+        }
+
+        RpsResult ProcessSubresourceOverlap(Graph&               graph,
+                                            NodeId               nodeId,
+                                            const CmdAccessInfo& currAccess,
+                                            SubresourceState&    subResState)
+        {
+            auto filteredCurrentAccess = currAccess.access;
+            FilterAccessByRange(filteredCurrentAccess, subResState.range);
+
+            return ProcessTransition(
+                graph, nodeId, subResState.access, filteredCurrentAccess, currAccess.resourceId, subResState.range);
+        }
+
+        // States covered by one access that all transition from the same access are joined into as few ranges as
+        // possible first, so each joined range needs a single transition.
+        RpsResult MergeTransitionStates(NodeId nodeId, const CmdAccessInfo& currAccess, uint32_t& numMergedStates)
+        {
+            m_mergeCandidates.clear();
+
+            for (uint32_t stateIndex : m_coveredStates)
+            {
+                const SubresourceState& state = m_subResStates[stateIndex];
+
+                // Same node accessing the state again, handled by ProcessTransition.
+                if (!state.access.accessorNodes.empty() &&
+                    (state.access.accessorNodes.Get(m_nodeRefLists).back() == nodeId))
+                {
+                    continue;
+                }
+
+                if (state.access.lastTransition != RenderGraph::INVALID_TRANSITION)
+                {
+                    auto filteredCurrentAccess = currAccess.access;
+                    FilterAccessByRange(filteredCurrentAccess, state.range);
+
+                    AccessTransitionInfo transitionInfo;
+                    if (!NeedTransition(m_transitions[state.access.lastTransition].access.access,
+                                        filteredCurrentAccess,
+                                        transitionInfo))
+                    {
+                        continue;
+                    }
+                }
+
+                RPS_CHECK_ALLOC(m_mergeCandidates.push_back(stateIndex));
+            }
+
+            auto getPrevAccessKey = [&](uint32_t stateIndex) {
+                const RpsAccessAttr& prevAccess =
+                    m_transitions[m_subResStates[stateIndex].access.lastTransition].access.access;
+                return (uint64_t(prevAccess.accessFlags) << 32) | prevAccess.accessStages;
+            };
+
+            auto canMerge = [&](const SubresourceState& lhs, const SubresourceState& rhs) {
+                return ((lhs.access.lastTransition == RenderGraph::INVALID_TRANSITION) ==
+                        (rhs.access.lastTransition == RenderGraph::INVALID_TRANSITION)) &&
+                       (m_transitions[lhs.access.lastTransition].access.access ==
+                        m_transitions[rhs.access.lastTransition].access.access);
+            };
+
+            // The new transition waits for the accessors of all merged states.
+            return MergeAdjacentStates(getPrevAccessKey, canMerge, true, numMergedStates);
+        }
+
+        // Merges the states of resources accessed by the node which ended up with the same transition and accessors,
+        // so the number of states follows the distinct access history rather than the number of past splits.
+        RpsResult CoalesceSubresourceStates(NodeId nodeId, ConstArrayRef<CmdAccessInfo, uint32_t> cmdAccesses)
+        {
+            for (const CmdAccessInfo& access : cmdAccesses)
+            {
+                if ((access.resourceId == RPS_RESOURCE_ID_INVALID) || (m_coalescedNodes[access.resourceId] == nodeId))
+                    continue;
+
+                m_coalescedNodes[access.resourceId] = nodeId;
+
+                ResourceState& resState = m_resourceStates[access.resourceId];
+
+                if (resState.subResStates.size() < 2)
+                    continue;
+
+                m_mergeCandidates.clear();
+
+                const auto states = resState.subResStates.Get(m_subResStates);
+
+                for (uint32_t iState = 0; iState < states.size(); iState++)
+                {
+                    const AccessState& stateAccess = states[iState].access;
+
+                    if (!stateAccess.accessorNodes.empty() &&
+                        (stateAccess.accessorNodes.Get(m_nodeRefLists).back() == nodeId))
+                    {
+                        RPS_CHECK_ALLOC(m_mergeCandidates.push_back(resState.subResStates.GetBegin() + iState));
+                    }
+                }
+
+                auto getTransitionKey = [&](uint32_t stateIndex) {
+                    return uint64_t(m_subResStates[stateIndex].access.lastTransition);
+                };
+
+                auto canMerge = [&](const SubresourceState& lhs, const SubresourceState& rhs) {
+                    if (lhs.access.lastTransition != rhs.access.lastTransition)
+                        return false;
+
+                    const auto lhsNodes = lhs.access.accessorNodes.Get(m_nodeRefLists);
+                    const auto rhsNodes = rhs.access.accessorNodes.Get(m_nodeRefLists);
+
+                    return (lhsNodes.size() == rhsNodes.size()) &&
+                           std::equal(lhsNodes.begin(), lhsNodes.end(), rhsNodes.begin());
+                };
+
+                uint32_t numMergedStates = 0;
+                RPS_V_RETURN(MergeAdjacentStates(getTransitionKey, canMerge, false, numMergedStates));
+
+                if (numMergedStates > 0)
+                {
+                    CompactSubresourceStates(resState);
+                }
+            }
+
+            return RPS_OK;
+        }
+
+        // Joins m_mergeCandidates states whose ranges form a single range, first along mip levels, then along array
+        // layers. A (layer, mip) grid thus first joins into layers with all mips, which then join into layer ranges.
+        template <typename TGetKey, typename TCanMerge>
+        RpsResult MergeAdjacentStates(TGetKey   getKey,
+                                      TCanMerge canMerge,
+                                      bool      bUnionAccessors,
+                                      uint32_t& numMergedStates)
+        {
+            for (uint32_t iSweep = 0; (iSweep < 2) && (m_mergeCandidates.size() > 1); iSweep++)
+            {
+                const bool bAlongMips = (iSweep == 0);
+
+                // Orders ranges so that the ones to join along the sweep direction are next to each other.
+                auto getRangeKey = [bAlongMips](const SubresourceRangePacked& range) {
+                    return bAlongMips ? ((uint64_t(range.aspectMask) << 56) | (uint64_t(range.baseArrayLayer) << 32) |
+                                         (uint64_t(range.arrayLayerEnd) << 8) | range.baseMipLevel)
+                                      : ((uint64_t(range.aspectMask) << 56) | (uint64_t(range.baseMipLevel) << 48) |
+                                         (uint64_t(range.mipLevelEnd) << 40) | range.baseArrayLayer);
+                };
+
+                std::sort(m_mergeCandidates.begin(), m_mergeCandidates.end(), [&](uint32_t lhs, uint32_t rhs) {
+                    const uint64_t lhsKey = getKey(lhs);
+                    const uint64_t rhsKey = getKey(rhs);
+                    return (lhsKey != rhsKey) ? (lhsKey < rhsKey)
+                                              : (getRangeKey(m_subResStates[lhs].range) <
+                                                 getRangeKey(m_subResStates[rhs].range));
+                });
+
+                uint32_t numKept = 1;
+
+                for (uint32_t iCandidate = 1; iCandidate < m_mergeCandidates.size(); iCandidate++)
+                {
+                    uint32_t&      currIndex = m_mergeCandidates[numKept - 1];
+                    const uint32_t nextIndex = m_mergeCandidates[iCandidate];
+
+                    SubresourceRangePacked joinedRange;
+
+                    if (canMerge(m_subResStates[currIndex], m_subResStates[nextIndex]) &&
+                        JoinRanges(m_subResStates[currIndex].range,
+                                   m_subResStates[nextIndex].range,
+                                   bAlongMips,
+                                   joinedRange))
+                    {
+                        // Keep the lower index, the first state of a resource tells if it has been accessed.
+                        const uint32_t dstIndex = rpsMin(currIndex, nextIndex);
+                        const uint32_t srcIndex = rpsMax(currIndex, nextIndex);
+
+                        RPS_V_RETURN(MergeState(
+                            m_subResStates[dstIndex], m_subResStates[srcIndex], joinedRange, bUnionAccessors));
+
+                        currIndex = dstIndex;
+                        numMergedStates++;
+                    }
+                    else
+                    {
+                        m_mergeCandidates[numKept++] = nextIndex;
+                    }
+                }
+
+                m_mergeCandidates.resize(numKept);
+            }
+
+            return RPS_OK;
+        }
+
+        RpsResult MergeState(SubresourceState&             dst,
+                             SubresourceState&             src,
+                             const SubresourceRangePacked& joinedRange,
+                             bool                          bUnionAccessors)
+        {
+            if (bUnionAccessors)
+            {
+                RPS_V_RETURN(UnionAccessorNodes(dst.access, src.access));
+            }
+            else
+            {
+                dst.access.bOrderedAccessors = dst.access.bOrderedAccessors && src.access.bOrderedAccessors;
+                m_nodeRefListPool.free_span(src.access.accessorNodes);
+            }
+
+            dst.range = joinedRange;
+            dst.subResMask |= src.subResMask;
+
+            // Merged away, an empty aspect mask never intersects an access.
+            src.range.aspectMask = 0;
+            src.subResMask       = 0;
+
+            return RPS_OK;
+        }
+
+        RpsResult UnionAccessorNodes(AccessState& dst, AccessState& src)
+        {
+            if (src.accessorNodes.empty())
+            {
+                return RPS_OK;
+            }
+
+            if (dst.accessorNodes.empty())
+            {
+                std::swap(dst.accessorNodes, src.accessorNodes);
+                dst.bOrderedAccessors = src.bOrderedAccessors;
+                return RPS_OK;
+            }
+
+            Span<NodeId> unionNodes;
+            m_nodeRefListPool.alloc_span(unionNodes, dst.accessorNodes.size() + src.accessorNodes.size());
+            RPS_RETURN_ERROR_IF(unionNodes.empty(), RPS_ERROR_OUT_OF_MEMORY);
+
+            // Accessor lists are in node order.
+            const auto dstNodes   = dst.accessorNodes.Get(m_nodeRefLists);
+            const auto srcNodes   = src.accessorNodes.Get(m_nodeRefLists);
+            const auto unionBegin = unionNodes.Get(m_nodeRefLists).begin();
+
+            const auto unionEnd =
+                std::set_union(dstNodes.begin(), dstNodes.end(), srcNodes.begin(), srcNodes.end(), unionBegin);
+            unionNodes.SetCount(uint32_t(unionEnd - unionBegin));
+
+            m_nodeRefListPool.free_span(dst.accessorNodes);
+            m_nodeRefListPool.free_span(src.accessorNodes);
+
+            dst.accessorNodes     = unionNodes;
+            dst.bOrderedAccessors = false;
+
+            return RPS_OK;
+        }
+
+        void CompactSubresourceStates(ResourceState& resState)
+        {
+            auto     states       = resState.subResStates.Get(m_subResStates);
+            uint32_t numRemaining = 0;
+
+            for (uint32_t iState = 0; iState < states.size(); iState++)
+            {
+                if (!IsMergedAway(states[iState]))
+                {
+                    states[numRemaining++] = states[iState];
+                }
+            }
+
+            resState.subResStates.SetCount(numRemaining);
+        }
+
+        static bool RangeContains(const SubresourceRangePacked& outer, const SubresourceRangePacked& inner)
+        {
+            return ((inner.aspectMask & ~outer.aspectMask) == 0) && (outer.baseArrayLayer <= inner.baseArrayLayer) &&
+                   (inner.arrayLayerEnd <= outer.arrayLayerEnd) && (outer.baseMipLevel <= inner.baseMipLevel) &&
+                   (inner.mipLevelEnd <= outer.mipLevelEnd);
+        }
+
+        static bool IsMergedAway(const SubresourceState& state)
+        {
+            return state.range.aspectMask == 0;
+        }
+
+        // Joins two ranges if together they form a single range. lhs is expected to come first along the direction.
+        static bool JoinRanges(const SubresourceRangePacked& lhs,
+                               const SubresourceRangePacked& rhs,
+                               bool                          bAlongMips,
+                               SubresourceRangePacked&       joined)
+        {
+            if (lhs.aspectMask != rhs.aspectMask)
+                return false;
+
+            if (bAlongMips)
+            {
+                if ((lhs.baseArrayLayer != rhs.baseArrayLayer) || (lhs.arrayLayerEnd != rhs.arrayLayerEnd) ||
+                    (lhs.mipLevelEnd != rhs.baseMipLevel))
+                    return false;
+
+                joined = SubresourceRangePacked(
+                    lhs.aspectMask, lhs.baseArrayLayer, lhs.arrayLayerEnd, lhs.baseMipLevel, rhs.mipLevelEnd);
+            }
+            else
+            {
+                if ((lhs.baseMipLevel != rhs.baseMipLevel) || (lhs.mipLevelEnd != rhs.mipLevelEnd) ||
+                    (lhs.arrayLayerEnd != rhs.baseArrayLayer))
+                    return false;
+
+                joined = SubresourceRangePacked(
+                    lhs.aspectMask, lhs.baseArrayLayer, rhs.arrayLayerEnd, lhs.baseMipLevel, lhs.mipLevelEnd);
+            }
+
+            return true;
+        }
+
+        static bool UseSubresourceMasks(const ResourceInstance& resInfo)
+        {
+            return resInfo.fullSubresourceRange.GetNumSubresources() <= MAX_MASK_BITS;
+        }
+
+        // Bit mask of the subresources in range, indexed by aspect, then array layer, then mip level.
+        static uint64_t GetSubresourceMask(const ResourceInstance& resInfo, const SubresourceRangePacked& range)
+        {
+            RPS_ASSERT(UseSubresourceMasks(resInfo));
+
+            const uint32_t resMipLevels    = resInfo.fullSubresourceRange.GetMipLevelCount();
+            const uint32_t subResPerAspect = resInfo.fullSubresourceRange.GetArrayLayerCount() * resMipLevels;
+            const uint64_t mipMask         = ((uint64_t(1) << range.GetMipLevelCount()) - 1) << range.baseMipLevel;
+
+            uint64_t mask               = 0;
+            uint32_t aspectSubResOffset = 0;
+
+            for (uint32_t aspectMask = resInfo.fullSubresourceRange.aspectMask; aspectMask != 0;
+                 aspectMask &= (aspectMask - 1))
+            {
+                const uint32_t currAspectBit = aspectMask & (~aspectMask + 1);
+
+                if (range.aspectMask & currAspectBit)
+                {
+                    for (uint32_t iArray = range.baseArrayLayer; iArray < range.arrayLayerEnd; iArray++)
+                    {
+                        mask |= mipMask << (aspectSubResOffset + iArray * resMipLevels);
+                    }
+                }
+
+                aspectSubResOffset += subResPerAspect;
+            }
+
+            return mask;
+        }
+
         bool IsFullResource(const SubresourceRangePacked& range, const ResourceInstance& resourceDesc)
         {
             return range.GetNumSubresources() == resourceDesc.numSubResources;
@@ -287,6 +721,9 @@ namespace rps
         {
             m_nodeRefListPool.alloc_span(dst, src.size());
 
+            // alloc_span returns the rounded up capacity, trim to the actual reference count.
+            dst.SetCount(src.size());
+
             if (!src.empty())
             {
                 if (dst.GetEnd() > m_nodeRefLists.size())
@@ -302,25 +739,6 @@ namespace rps
             return RPS_OK;
         }
 
-        RpsResult CloneTransition(Graph& graph, uint32_t srcTransition, uint32_t& dstTransition)
-        {
-            const TransitionInfo& srcTrans        = m_transitions[srcTransition];
-            int32_t               newTransitionId = int32_t(m_transitions.size());
-
-            const NodeId newTransNodeId = graph.CloneNode(srcTrans.nodeId, -newTransitionId);
-            RPS_RETURN_ERROR_IF(newTransNodeId == RPS_INDEX_NONE_U32, RPS_ERROR_UNSPECIFIED);
-
-            TransitionInfo* pNewTrans = m_transitions.grow(1);
-            RPS_RETURN_ERROR_IF(!pNewTrans, RPS_ERROR_OUT_OF_MEMORY);
-
-            *pNewTrans        = srcTrans;
-            pNewTrans->nodeId = newTransNodeId;
-
-            dstTransition = newTransitionId;
-
-            return RPS_OK;
-        }
-
         RpsResult AddNewTransition(Graph&                        graph,
                                    NodeId                        currNodeId,
                                    AccessState&                  accessorInfo,
@@ -346,20 +764,69 @@ namespace rps
             pNewTransNode->subgraph     = pCurrNode->subgraph;
             pNewTransNode->barrierScope = pCurrNode->barrierScope;
 
-            // Add edges for existing accessors -> new transition node
-            // TODO: If previous accessors are ordered, only add edge from the last node
-            for (auto accessorNodeId : accessorInfo.accessorNodes.Get(m_nodeRefLists))
+            // Add edges for existing accessors -> new transition node.
+            // If previous accessors are ordered, the edge from the last one implies the others.
+            const auto accessorNodes = accessorInfo.accessorNodes.Get(m_nodeRefLists);
+
+            if (accessorInfo.bOrderedAccessors && !accessorNodes.empty())
             {
-                graph.AddEdge(accessorNodeId, newTransNodeId);
-                // RPS_V_RETURN(result);
+                graph.AddEdge(accessorNodes.back(), newTransNodeId);
+                graph.AddPrunedEdges(uint32_t(accessorNodes.size() - 1));
+            }
+            else if (accessorNodes.size() > 1)
+            {
+                // An accessor with an edge to another accessor is implied by that one's edge, e.g. in a sequential
+                // subgraph. The graph is acyclic, so at least one accessor keeps its edge.
+                for (auto accessorNodeId : accessorNodes)
+                {
+                    m_accessorMarks[accessorNodeId] = newTransitionId;
+                }
+
+                uint32_t numPrunedEdges = 0;
+
+                for (auto accessorNodeId : accessorNodes)
+                {
+                    if (HasEdgeToMarkedNode(graph, accessorNodeId, newTransitionId))
+                    {
+                        numPrunedEdges++;
+                        continue;
+                    }
+
+                    graph.AddEdge(accessorNodeId, newTransNodeId);
+                }
+
+                graph.AddPrunedEdges(numPrunedEdges);
+            }
+            else
+            {
+                for (auto accessorNodeId : accessorNodes)
+                {
+                    graph.AddEdge(accessorNodeId, newTransNodeId);
+                }
             }
 
             m_nodeRefListPool.free_span(accessorInfo.accessorNodes);
-            accessorInfo.lastTransition = newTransitionId;
+            accessorInfo.lastTransition    = newTransitionId;
+            accessorInfo.bOrderedAccessors = true;
 
             return RPS_OK;
         }
 
+        bool HasEdgeToMarkedNode(const Graph& graph, NodeId nodeId, uint32_t mark) const
+        {
+            const auto edges = graph.GetEdges();
+
+            for (const Edge& outEdge : graph.GetNode(nodeId)->outEdges.Get(edges))
+            {
+                if ((outEdge.dst < m_accessorMarks.size()) && (m_accessorMarks[outEdge.dst] == mark))
+                {
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
         RpsResult ProcessTransition(Graph&                        graph,
                                     NodeId                        currNodeId,
                                     AccessState&                  accessState,
@@ -400,21 +867,32 @@ namespace rps
                 // No Transition
                 if (transitionInfo.bMergedAccessStates)
                 {
-                    // We should have splitted (cloned) the previou transition node if any, and patched its range to the current one.
-                    RPS_ASSERT(m_transitions[accessState.lastTransition].access.range == range);
+                    // The previous transition may be shared with other states of the resource. Merging widens the
+                    // read state of its whole range, which stays valid for all of them.
+                    RPS_ASSERT(RangeContains(m_transitions[accessState.lastTransition].access.range, range));
                     m_transitions[accessState.lastTransition].access.access = transitionInfo.mergedAccess;
                 }
 
-                if (transitionInfo.bKeepOrdering && !accessState.accessorNodes.empty())
+                if (!accessState.accessorNodes.empty())
                 {
                     NodeId lastAccessor = accessState.accessorNodes.Get(m_nodeRefLists).back();
 
-                    // TODO: Validate all existing accessors are in order.
                     if (lastAccessor != currNodeId)
                     {
-                        graph.AddEdge(lastAccessor, currNodeId);
+                        if (transitionInfo.bKeepOrdering)
+                        {
+                            graph.AddEdge(lastAccessor, currNodeId);
+                        }
+                        else
+                        {
+                            accessState.bOrderedAccessors = false;
+                        }
                     }
                 }
+                else
+                {
+                    accessState.bOrderedAccessors = true;
+                }
             }
 
             graph.AddEdge(m_transitions[accessState.lastTransition].nodeId, currNodeId);
@@ -521,6 +999,16 @@ namespace rps
         ArenaVector<NodeId>                   m_nodeRefLists;
         SpanPool<NodeId, ArenaVector<NodeId>> m_nodeRefListPool;
 
+        // Per cmd node, id of the last transition it was collected as an accessor for.
+        ArenaVector<uint32_t> m_accessorMarks;
+
+        // Indices into m_subResStates of the states covered by the current access, and of the states to merge.
+        ArenaVector<uint32_t> m_coveredStates;
+        ArenaVector<uint32_t> m_mergeCandidates;
+
+        // Per resource, the last node its states were coalesced after.
+        ArenaVector<uint32_t> m_coalescedNodes;
+
         uint32_t m_transitionCountWatermark = 0;
     };
 }
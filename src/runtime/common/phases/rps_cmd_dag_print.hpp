@@ -42,7 +42,14 @@ namespace rps
             // TODO: Expose print functionality separately / allow specify printer
             PrinterRef printer(m_renderGraph.GetDevice().Printer());
 
+            uint32_t numEdges = 0;
+            for (const Node& node : nodes)
+            {
+                numEdges += node.inEdges.size();
+            }
+
             printer("\ndigraph G {\n");
+            printer("    // Edges: %u (%u before pruning)\n", numEdges, numEdges + m_graph.GetNumPrunedEdges());
             printer("    graph [ size = \"128,64\" ];\n");
             printer("    edge [ style = bold ];\n");
             printer(
@@ -17,6 +17,11 @@ namespace rps
     class DAGBuilderPass final : public IRenderGraphPhase
     {
     public:
+        virtual bool IsStructuralPhase() const override final
+        {
+            return true;
+        }
+
         virtual RpsResult Run(RenderGraphUpdateContext& context) override final
         {
             auto&      renderGraph = context.renderGraph;
@@ -95,6 +100,14 @@ namespace rps
             for (auto dep : explicitDeps)
             {
                 RPS_ASSERT(dep.before < dep.after);
+
+                // Skip duplicates, e.g. dependencies already implied by a sequential subgraph.
+                if (graph.HasEdge(dep.before, dep.after))
+                {
+                    graph.AddPrunedEdges(1);
+                    continue;
+                }
+
                 graph.AddEdge(dep.before, dep.after);
             }
 
@@ -30,6 +30,7 @@ namespace rps
             bool bWorkloadTypePipeliningAggressive;
             bool bForceProgramOrder;
             bool bRandomOrder;
+            bool bAvoidReschedule;
 
             explicit ScheduleFlags(uint32_t numQueues = 1, RpsScheduleFlags flags = RPS_SCHEDULE_DEFAULT)
             {
@@ -45,6 +46,7 @@ namespace rps
                 bMinimizeGfxCompSwitch = !!(flags & RPS_SCHEDULE_MINIMIZE_COMPUTE_GFX_SWITCH_BIT);
                 bForceProgramOrder     = !!(flags & RPS_SCHEDULE_KEEP_PROGRAM_ORDER_BIT);
                 bRandomOrder           = !bForceProgramOrder && !!(flags & RPS_SCHEDULE_RANDOM_ORDER_BIT);
+                bAvoidReschedule       = !bRandomOrder && !!(flags & RPS_SCHEDULE_AVOID_RESCHEDULE_BIT);
             }
         };
 
@@ -116,10 +118,113 @@ namespace rps
             }
         };
 
+        // Node scoring:
+        // [31]      : Scope bit
+        // [30]      : Queue bit
+        // [29]      : Barrier Batching High
+        // [29 : 16] : Memory Saving
+        // [16]      : Barrier Batching Low
+        // [15]      : Work Type Grouping
+        // [8]       : Work Type Interleave
+        // [0  : 15] : Program Order, or Critical Path with node time estimates
+        // Note: The Work Type Grouping bit can be shifted within the Program Order bit range,
+        // and the Barrier Batching High bit can be shifted within the Memory Saving bit range.
+        // This allows us to interpolate between ordering preferences.
+        // For example, if the schedule option prefers barrier batching over memory saving,
+        // we can put the barrier batching bit on the highest bit in the memory saving score range,
+        // and vice versa. In general, these are the default initial weight assignment of different node scheduling
+        // factors. The actual weights of each factor are not limited to their ranges and may overlap.
+
+        static constexpr uint32_t ScopeScoreBit         = (1u << 31);
+        static constexpr uint32_t QueueScoreBit         = (1u << 30);
+        static constexpr uint32_t BarrierScoreHighBit   = (1u << 29);
+        static constexpr uint32_t BarrierScoreLowBit    = (1u << 16);
+        static constexpr uint32_t BarrierScoreBitRange  = (13u);
+        static constexpr uint32_t MemoryScoreShift      = (16u);
+        static constexpr uint32_t WorkTypeGroupingBit   = (1u << 15);
+        static constexpr uint32_t WorkTypeInterleaveBit = (1u << 8);
+        static constexpr uint32_t MemoryScoreMax        = (0x1fff);
+        static constexpr uint32_t ProgramOrderScoreMax  = (0xffff);
+
+        // The score of a ready node is split into a local part (memory saving & program order), which only changes
+        // when one of the node's resources gets its first or last user scheduled, and a context part which depends
+        // on the last scheduled node (scope, queue, barrier batching & work type bits).
+        // Ready nodes with the same ReadyNodeKey always get the same context score, so they are kept in one bucket,
+        // ordered by their local score. Picking a node then only needs to score the top node of each bucket.
+        // Since the final score ORs the two parts together, local score bits overlapping the context score bits
+        // are part of the key, so that the order within a bucket is the same as the order of the final scores.
+        enum ReadyNodeKeyFlagBits
+        {
+            READY_NODE_KEY_TRANSITION_BIT          = 1 << 0,
+            READY_NODE_KEY_INITIAL_TRANSITION_BIT  = 1 << 1,
+            READY_NODE_KEY_IMMEDIATE_DEPENDENT_BIT = 1 << 2,
+        };
+
+        struct ReadyNodeKey
+        {
+            uint32_t barrierScopeIdx;
+            uint32_t atomicSubgraphId;
+            uint32_t localScoreContextBits;
+            uint8_t  validQueueMask;
+            uint8_t  preferredQueueMask;
+            uint8_t  workloadTypeMask;
+            uint8_t  flags;
+
+            bool operator==(const ReadyNodeKey& other) const
+            {
+                return (barrierScopeIdx == other.barrierScopeIdx) && (atomicSubgraphId == other.atomicSubgraphId) &&
+                       (localScoreContextBits == other.localScoreContextBits) &&
+                       (validQueueMask == other.validQueueMask) && (preferredQueueMask == other.preferredQueueMask) &&
+                       (workloadTypeMask == other.workloadTypeMask) && (flags == other.flags);
+            }
+        };
+
+        struct ReadyNodeBucket
+        {
+            ReadyNodeKey key;
+            uint32_t     scoreHeapRoot;
+            uint32_t     readyIndexHeapRoot;
+            uint32_t     activeIndex;
+            uint32_t     hashSlot;
+            uint32_t     nextInHashSlot;
+        };
+
+        struct ReadyNodeState
+        {
+            uint64_t allocAliasableMemSize;
+            uint64_t freeAliasableMemSize;
+            uint32_t readyIndex;
+            uint32_t bucketIndex;
+            uint32_t localScore;
+        };
+
+        // Intrusive pairing heap links, indexed by node id.
+        struct ReadyNodeHeapLinks
+        {
+            uint32_t child;
+            uint32_t sibling;
+            uint32_t prev;
+        };
+
+        struct ScoringContext
+        {
+            uint32_t lastCmdNodeId;
+            uint32_t lastBarrierScopeIdx;
+            uint32_t lastAtomicSubgraphId;
+            uint32_t currQueueMask;
+            uint32_t idleQueueMask;
+            bool     lastNodeIsTransition;
+        };
+
     public:
         DAGSchedulePass(RenderGraph& renderGraph)
             : m_renderGraph(renderGraph)
             , graph(m_renderGraph.GetGraph())
+            , m_scheduleCacheArena(renderGraph.GetDevice().Allocator())
+            , m_cachedRuntimeCmds(&m_scheduleCacheArena)
+            , m_cachedCmdBatches(&m_scheduleCacheArena)
+            , m_cachedCmdBatchWaitFenceIds(&m_scheduleCacheArena)
+            , m_cachedScheduleInputs(&m_scheduleCacheArena)
         {
             m_targetInfo.numQueues   = m_renderGraph.GetCreateInfo().scheduleInfo.numQueues;
             m_targetInfo.pQueueFlags = m_renderGraph.GetCreateInfo().scheduleInfo.pQueueInfos;
@@ -133,6 +238,16 @@ namespace rps
             }
         }
 
+        virtual bool IsStructuralPhase() const override final
+        {
+            return true;
+        }
+
+        virtual bool IsSchedulePhase() const override final
+        {
+            return true;
+        }
+
         virtual RpsResult Run(RenderGraphUpdateContext& context) override final
         {
             RPS_RETURN_OK_IF(context.renderGraph.GetCmdInfos().empty());
@@ -144,10 +259,14 @@ namespace rps
 
             const RpsRenderGraphCreateInfo& renderGraphCreateInfo = context.renderGraph.GetCreateInfo();
 
-            m_targetInfo.options = ScheduleFlags(renderGraphCreateInfo.scheduleInfo.numQueues,
-                                                 (context.pUpdateInfo->scheduleFlags != RPS_SCHEDULE_UNSPECIFIED)
-                                                     ? context.pUpdateInfo->scheduleFlags
-                                                     : renderGraphCreateInfo.scheduleInfo.scheduleFlags);
+            const RpsScheduleFlags scheduleFlags = (context.pUpdateInfo->scheduleFlags != RPS_SCHEDULE_UNSPECIFIED)
+                                                       ? context.pUpdateInfo->scheduleFlags
+                                                       : renderGraphCreateInfo.scheduleInfo.scheduleFlags;
+
+            m_targetInfo.options = ScheduleFlags(renderGraphCreateInfo.scheduleInfo.numQueues, scheduleFlags);
+
+            m_targetInfo.options.bUseSplitBarrier &=
+                RuntimeDevice::Get(context.renderGraph.GetDevice())->SupportsSplitBarriers();
 
             const ScheduleFlags flags = m_targetInfo.options;
 
@@ -166,6 +285,8 @@ namespace rps
             nodeReadyDeps             = scratchArena.NewArray<uint32_t>(nodes.size());
             nodeAtomicSubgraphIndices = scratchArena.NewArray<uint32_t>(nodes.size());
             scheduledNodes            = scratchArena.NewArray<uint32_t>(nodes.size());
+            nodeTimeCosts             = scratchArena.NewArray<float>(nodes.size());
+            nodeReadyTimes            = scratchArena.NewArray<float>(nodes.size());
 
             ArrayRef<NodeQueueInfo> nodeQueueInfos;
             if (flags.bUseAsync)
@@ -175,37 +296,20 @@ namespace rps
 
             nodeResourceRefs.reset(&scratchArena);
 
-            // Node scoring:
-            // [31]      : Scope bit
-            // [30]      : Queue bit
-            // [29]      : Barrier Batching High
-            // [29 : 16] : Memory Saving
-            // [16]      : Barrier Batching Low
-            // [15]      : Work Type Grouping
-            // [8]       : Work Type Interleave
-            // [0  : 15] : Program Order
-            // Note: The Work Type Grouping bit can be shifted within the Program Order bit range,
-            // and the Barrier Batching High bit can be shifted within the Memory Saving bit range.
-            // This allows us to interpolate between ordering preferences.
-            // For example, if the schedule option prefers barrier batching over memory saving,
-            // we can put the barrier batching bit on the highest bit in the memory saving score range,
-            // and vice versa. In general, these are the default initial weight assignment of different node scheduling
-            // factors. The actual weights of each factor are not limited to their ranges and may overlap.
-
-            static constexpr uint32_t ScopeScoreBit         = (1u << 31);
-            static constexpr uint32_t QueueScoreBit         = (1u << 30);
-            static constexpr uint32_t BarrierScoreHighBit   = (1u << 29);
-            static constexpr uint32_t BarrierScoreLowBit    = (1u << 16);
-            static constexpr uint32_t MemoryScoreShift      = (16u);
-            static constexpr uint32_t WorkTypeGroupingBit   = (1u << 15);
-            static constexpr uint32_t WorkTypeInterleaveBit = (1u << 8);
-            static constexpr uint32_t MemoryScoreMax        = (0x1fff);
-            static constexpr uint32_t ProgramOrderScoreMax  = (0xffff);
-
-            const uint32_t numTotalCmdNodes      = uint32_t(cmdInfos.size());
-            const uint32_t maxCmdNodeId          = numTotalCmdNodes - 1;
-            const uint32_t barrierBatchingBit    = flags.bPreferMemorySaving ? BarrierScoreLowBit : BarrierScoreHighBit;
-            const uint32_t memoryAllocScoreShift = flags.bPreferMemorySaving ? 17 : 16;
+            // Each memory feedback iteration moves the barrier batching bit halfway closer to where it is when
+            // preferring memory saving, so the memory saving score can outweigh barrier batching.
+            const uint32_t memoryFeedbackLevel = rpsMin(m_renderGraph.GetMemoryFeedbackLevel(), 31u);
+            const uint32_t barrierBitShift     = BarrierScoreBitRange - (BarrierScoreBitRange >> memoryFeedbackLevel);
+
+            barrierBatchingBit    = flags.bPreferMemorySaving
+                                        ? BarrierScoreLowBit
+                                        : rpsMax(BarrierScoreHighBit >> barrierBitShift, BarrierScoreLowBit);
+            memoryAllocScoreShift = flags.bPreferMemorySaving ? 17 : 16;
+            contextScoreBits      = ScopeScoreBit | QueueScoreBit | (QueueScoreBit >> 1) | barrierBatchingBit |
+                               WorkTypeGroupingBit | WorkTypeInterleaveBit;
+
+            const uint32_t numTotalCmdNodes = uint32_t(cmdInfos.size());
+            const uint32_t maxCmdNodeId     = numTotalCmdNodes - 1;
 
             // Initialize node and resource scheduling info
             InitNodeResourceSchedulingInfos();
@@ -213,11 +317,42 @@ namespace rps
             // (Atomic) subgraph info
             const bool bHasAnyAtomicSubgraphs = InitAtomicSubgraphTopology();
 
+            hasAnyAtomicSubgraphs = bHasAnyAtomicSubgraphs;
+
             if (flags.bForceProgramOrder)
             {
                 EnforceProgramOrder();
             }
 
+            // Time estimates only matter when there are multiple queues to overlap work on.
+            const ConstArrayRef<float> cmdTimeEstimates = m_renderGraph.GetCmdTimeEstimates();
+
+            useCostModel = flags.bUseAsync && !flags.bRandomOrder && !cmdTimeEstimates.empty();
+
+            InitNodeTimeCosts(cmdTimeEstimates);
+
+            if (useCostModel)
+            {
+                InitCriticalPathScores(scratchArena);
+            }
+
+            // Replay the previous schedule if none of the scheduling inputs changed.
+            CacheInputs scheduleInputs(&scratchArena);
+
+            if (flags.bAvoidReschedule)
+            {
+                GatherScheduleInputs(
+                    scheduleInputs, scheduleFlags, context.pUpdateInfo->frameIndex, bHasAnyAtomicSubgraphs);
+                RPS_CHECK_ALLOC(scheduleInputs.IsValid());
+
+                if (m_bScheduleCacheValid && (m_cachedScheduleInputs == scheduleInputs))
+                {
+                    return RestoreCachedSchedule();
+                }
+            }
+
+            m_bScheduleCacheValid = false;
+
             uint32_t numScheduled       = 0;
             uint32_t numEliminated      = 0;
             uint32_t numReadyCmdNodes   = 0;
@@ -248,10 +383,30 @@ namespace rps
             uint32_t lastAtomicSubgraphId = RPS_INDEX_NONE_U32;
             uint32_t atomicSGStackDepth   = 0;
 
-            // TODO: Should be per queue
-            float currentTime = 0.0f;
+            // Random order rescores every ready node per pick, so there is nothing to keep track of.
+            // The reference scheduler does the same in any order, to validate the queue against.
+            useReadyNodeQueue = !flags.bRandomOrder && !rpsAnyBitsSet(context.pUpdateInfo->diagnosticFlags,
+                                                                      RPS_DIAGNOSTIC_ENABLE_REFERENCE_SCHEDULER);
+
+            const bool bUseReadyNodeQueue = useReadyNodeQueue;
+
+            if (bUseReadyNodeQueue)
+            {
+                InitReadyNodeQueue(scratchArena);
+
+                for (uint32_t iRN = 0; iRN < numReadyCmdNodes; iRN++)
+                {
+                    readyNodeStates[readyNodes[iRN].nodeId].readyIndex = iRN;
+                    AddToReadyNodeQueue(readyNodes[iRN].nodeId, lastCmdNodeId);
+                }
+            }
+
+            // Timeline per queue, in reverse from the end of the frame.
+            float queueTimes[RPS_MAX_QUEUES] = {};
 
-            bool lastNodeIsSplitCandidate = false;
+            // Ready transitions of the last command node. Switching queues before they are scheduled would move them
+            // to another queue than their command.
+            uint32_t numPendingLastCmdTransitions = 0;
 
             uint32_t currQueueIndex = RPS_INDEX_NONE_U32;
             uint32_t currQueueMask  = 0;
@@ -263,162 +418,26 @@ namespace rps
             while ((numReadyCmdNodes + numReadyTransNodes) > 0)
             {
                 // Score and pick one node to schedule
-                uint32_t highScore      = 0;
-                uint32_t highScoreIndex = UINT32_MAX;
-
                 const bool lastNodeIsTransition = IsTransitionNode(lastNodeId);
 
                 lastCmdNodeId = lastNodeIsTransition ? lastCmdNodeId : lastNodeId;
 
-                for (uint32_t iRN = 0; iRN < (numReadyCmdNodes + numReadyTransNodes); iRN++)
-                {
-                    const uint32_t currNodeId = readyNodes[iRN].nodeId;
-
-                    const NodeSchedulingInfo& nodeInfo = nodeSchInfos[currNodeId];
-
-                    const bool currNodeIsTransition = IsTransitionNode(currNodeId);
-
-                    if (nodeInfo.canBeEliminated)
-                    {
-                        highScoreIndex = iRN;
-                        break;
-                    }
-
-                    // Score nodes
-
-                    // Barrier batching scoring
-                    uint32_t barrierBatchingScore =
-                        ((lastNodeIsTransition == currNodeIsTransition) ? barrierBatchingBit : 0);
-
-                    // Program order scoring
-                    const uint32_t nodeOrder = flags.bRandomOrder
-                                                   ? randGen.pfnRandomUniformInt(randGen.pContext, 0, maxCmdNodeId)
-                                                   : currNodeId;
-
-                    const uint32_t programOrderScore = currNodeIsTransition ? 0 : nodeOrder;
-
-                    // Workload type scoring
-                    uint32_t pipelineWorkTypeScore = 0;
-
-                    if (!(currNodeIsTransition || lastNodeIsTransition))
-                    {
-                        const bool workloadTypeEq =
-                            (nodeSchInfos[lastCmdNodeId].workloadTypeMask == nodeInfo.workloadTypeMask);
-
-                        if (flags.bMinimizeGfxCompSwitch)
-                            pipelineWorkTypeScore = workloadTypeEq ? WorkTypeGroupingBit : 0;
-                        else if (!flags.bWorkloadTypePipeliningDisabled)
-                            pipelineWorkTypeScore = workloadTypeEq ? 0 : WorkTypeGroupingBit;
-                    }
-                    else if (lastNodeIsTransition && flags.bWorkloadTypePipeliningAggressive)
-                    {
-                        // TODO: Check the benefit / effect of this. Add a flag for control?
-                        pipelineWorkTypeScore =
-                            (nodeInfo.workloadTypeMask & RPS_NODE_DECL_GRAPHICS_BIT) ? WorkTypeInterleaveBit : 0;
-                    }
-
-                    // Memory allocation scoring
-                    // TODO: Should be per heap
-                    uint64_t allocAliasableMemSize = 0;
-                    uint64_t freeAliasableMemSize  = 0;
-                    uint64_t usingAliasableMemSize = 0;
-                    uint64_t immediateReuseMemSize = 0;
-                    for (uint32_t resIdx : nodeInfo.resourceRefs.Get(nodeResourceRefs))
-                    {
-                        ResourceSchedulingInfo& resSchInfo = resourceSchInfos[resIdx];
-
-                        if (resSchInfo.scheduledUserNodesCount == 0)  // First access to a resource
-                        {
-                            allocAliasableMemSize += resSchInfo.aliasableSize;
-                        }
-
-                        if ((resSchInfo.scheduledUserNodesCount + 1) ==
-                            resSchInfo.totalUserNodesCount)  // Last access to a resource
-                        {
-                            freeAliasableMemSize += resSchInfo.aliasableSize;
-                        }
-
-                        if (resSchInfo.mostRecentRefNodeId == lastCmdNodeId)
-                        {
-                            immediateReuseMemSize += resSchInfo.aliasableSize;  //TODO - should not limit to aliasable.
-                        }
-
-                        usingAliasableMemSize += resSchInfo.aliasableSize;
-                    }
-
-                    // Prioritize nodes with smaller new allocations
-                    uint32_t memorySavingScore = uint32_t(
-                        (rpsClamp<uint64_t>((maxNodeMemorySize - allocAliasableMemSize) >> 16, 0ull, MemoryScoreMax) +
-                         rpsClamp<uint64_t>(freeAliasableMemSize >> 16, 0ull, MemoryScoreMax))
-                        << memoryAllocScoreShift);
-
-                    // Maximize memory saving score if the transition node is the initial access of a resource and
-                    // is ready to be batched into a transition batch.
-                    const bool bIsInitialTransitionNode = currNodeIsTransition && (freeAliasableMemSize != 0);
-                    if (bIsInitialTransitionNode && lastNodeIsTransition)
-                    {
-                        memorySavingScore = MemoryScoreMax << memoryAllocScoreShift;
-                    }
-
-                    memorySavingScore = flags.bRandomOrder ? 0 : memorySavingScore;
-
-                    uint32_t memoryReuseScore =
-                        uint32_t(rpsClamp<uint64_t>((immediateReuseMemSize >> 19), 0ull, 0xFFFull)
-                                 << memoryAllocScoreShift);  // TODO - use its own shift.
-
-                    // Queue scoring:
+                const ScoringContext scoringContext = {lastCmdNodeId,
+                                                       lastBarrierScopeIdx,
+                                                       lastAtomicSubgraphId,
+                                                       currQueueMask,
+                                                       (useCostModel && (numPendingLastCmdTransitions == 0))
+                                                           ? GetIdleQueueMask(queueTimes, currQueueIndex)
+                                                           : 0,
+                                                       lastNodeIsTransition};
 
-                    uint32_t queueScore = QueueScoreBit;
+                uint32_t highScoreIndex =
+                    bUseReadyNodeQueue ? PickReadyNodeFromQueue(scoringContext) : RPS_INDEX_NONE_U32;
 
-                    if (flags.bUseAsync)
-                    {
-                        // Prioritize independent node between workload on another queue and its immediate dependent node.
-
-                        // Penalize nodes who want a queue switch.
-                        if (!rpsAnyBitsSet(currQueueMask, nodeInfo.preferredQueueMask))
-                        {
-                            queueScore = (QueueScoreBit >> 1);
-
-                            // Candidate require a queue switch, and is an immediate dependent node of the previously scheduled command,
-                            // raise penalty.
-                            if ((!rpsAnyBitsSet(currQueueMask, nodeInfo.validQueueMask)) &&
-                                (readyNodes[iRN].depNodeId == lastCmdNodeId))
-                            {
-                                queueScore = 0;
-                            }
-                        }
-                    }
-
-                    // Schedule barriers & Atomic subgraph should have highest priority.
-                    uint32_t scopeScore = ScopeScoreBit;  // This is the highest bit
-
-                    // Penalize nodes in an earlier barrier scope.
-                    const uint32_t currBarrierScopeIdx = readyNodes[iRN].schBarrierScopeIdx;
-                    if (currBarrierScopeIdx < lastBarrierScopeIdx)
-                    {
-                        scopeScore = 0;
-                    }
-
-                    // Penalize nodes in another atomic subgraph.
-                    uint32_t currAtomicSubgraphId = nodeAtomicSubgraphIndices[currNodeId];
-                    if (bHasAnyAtomicSubgraphs && (currAtomicSubgraphId != lastAtomicSubgraphId) &&
-                        ((currAtomicSubgraphId == RPS_INDEX_NONE_U32) ||
-                         (lastAtomicSubgraphId != subgraphSchInfos[currAtomicSubgraphId].atomicParentId)))
-                    {
-                        scopeScore = 0;
-                    }
-
-                    // Individual score categories should already be in their own bit range,
-                    // OR them together as the final score.
-                    const uint32_t currScore = rpsMax((scopeScore | queueScore | barrierBatchingScore |
-                                                       memorySavingScore | programOrderScore | pipelineWorkTypeScore),
-                                                      1u);
-
-                    if (highScore < currScore)
-                    {
-                        highScore      = currScore;
-                        highScoreIndex = iRN;
-                    }
+                if (highScoreIndex == RPS_INDEX_NONE_U32)
+                {
+                    highScoreIndex = PickReadyNodeLinear(
+                        scoringContext, numReadyCmdNodes + numReadyTransNodes, randGen, maxCmdNodeId);
                 }
 
                 RPS_ASSERT(highScoreIndex != UINT32_MAX);
@@ -430,18 +449,40 @@ namespace rps
 
                 lastBarrierScopeIdx = readyNodes[highScoreIndex].schBarrierScopeIdx;
 
+                // Time at which all dependents of the node are done, in reverse.
+                float scheduledNodeTime = readyNodes[highScoreIndex].timeReady;
+
+                // The ready list slot is reused below, keep what is needed of the winner.
+                const bool scheduledNodeIsImmediateDependent = (readyNodes[highScoreIndex].depNodeId == lastCmdNodeId);
+
                 const bool scheduledNodeIsTransition = IsTransitionNode(scheduledNodeId);
 
-                lastNodeIsSplitCandidate =
-                    (scheduledNodeIsTransition && (readyNodes[highScoreIndex].depNodeId != lastCmdNodeId));
+                if (!scheduledNodeIsTransition)
+                {
+                    numPendingLastCmdTransitions = 0;
+                }
+                else if (scheduledNodeIsImmediateDependent && (numPendingLastCmdTransitions > 0))
+                {
+                    numPendingLastCmdTransitions--;
+                }
 
                 if (scheduledNodeIsTransition)
                     numReadyTransNodes--;
                 else
                     numReadyCmdNodes--;
 
+                if (bUseReadyNodeQueue)
+                {
+                    RemoveFromReadyNodeQueue(scheduledNodeId);
+                }
+
                 readyNodes[highScoreIndex] = readyNodes[(numReadyCmdNodes + numReadyTransNodes)];
 
+                if (bUseReadyNodeQueue && (highScoreIndex != (numReadyCmdNodes + numReadyTransNodes)))
+                {
+                    PromoteReadyNode(readyNodes[highScoreIndex].nodeId, highScoreIndex);
+                }
+
                 // Eliminate nodes if allowed.
                 // Also skip subgraph/subroutine markers.
                 const bool bEliminate =
@@ -461,7 +502,7 @@ namespace rps
 
                         const bool bRequireQueueSwitch = (0 == (scheduledNodeInfo.validQueueMask & currQueueMask));
                         const bool bPreferQueueSwitch  = (0 == (scheduledNodeInfo.preferredQueueMask & currQueueMask));
-                        const bool bImmediateDependent = (readyNodes[highScoreIndex].depNodeId == lastCmdNodeId);
+                        const bool bImmediateDependent = scheduledNodeIsImmediateDependent;
 
                         // Only actually do queue switch if:
                         // Current queue is not compatible with the candidate at all,
@@ -486,6 +527,10 @@ namespace rps
                         nodeQueueInfos[scheduledNodeId].queueIndex     = currQueueIndex;
                         nodeQueueInfos[scheduledNodeId].scheduledIndex = (numScheduled - 1);
                     }
+
+                    float& queueTime  = queueTimes[flags.bUseAsync ? currQueueIndex : 0];
+                    scheduledNodeTime = rpsMax(queueTime, scheduledNodeTime) + nodeTimeCosts[scheduledNodeId];
+                    queueTime         = scheduledNodeTime;
                 }
                 else
                 {
@@ -502,6 +547,20 @@ namespace rps
                     }
                 }
 
+                // The scheduled command node becomes the last command node for the next pick,
+                // nodes made ready by the previous one are no longer its immediate dependents.
+                if (!scheduledNodeIsTransition && (lastCmdNodeId != scheduledNodeId))
+                {
+                    const uint32_t prevCmdNodeId = lastCmdNodeId;
+
+                    lastCmdNodeId = scheduledNodeId;
+
+                    if (bUseReadyNodeQueue && flags.bUseAsync)
+                    {
+                        UpdateImmediateDependents(prevCmdNodeId, lastCmdNodeId);
+                    }
+                }
+
                 // Add new ready nodes to ready list
                 const Node& newScheduledNode = nodes[scheduledNodeId];
 
@@ -512,22 +571,33 @@ namespace rps
 
                     int32_t outInputReadyCount = ++nodeReadyDeps[srcNodeId];
 
+                    nodeReadyTimes[srcNodeId] = rpsMax(nodeReadyTimes[srcNodeId], scheduledNodeTime);
+
                     if (srcNode.outEdges.size() == outInputReadyCount)
                     {
-                        ReadyNodeInfo* pNewReadyNode      = &readyNodes[(numReadyCmdNodes + numReadyTransNodes)];
+                        const uint32_t newReadyIndex = (numReadyCmdNodes + numReadyTransNodes);
+
+                        ReadyNodeInfo* pNewReadyNode      = &readyNodes[newReadyIndex];
                         pNewReadyNode->nodeId             = srcNodeId;
                         pNewReadyNode->depNodeId          = scheduledNodeId;
                         pNewReadyNode->schBarrierScopeIdx = srcNode.barrierScope;
-                        pNewReadyNode->timeReady          = currentTime;
+                        pNewReadyNode->timeReady          = nodeReadyTimes[srcNodeId];
 
                         if (IsTransitionNode(srcNodeId))
                         {
                             numReadyTransNodes++;
+                            numPendingLastCmdTransitions += scheduledNodeIsTransition ? 0 : 1;
                         }
                         else
                         {
                             numReadyCmdNodes++;
                         }
+
+                        if (bUseReadyNodeQueue)
+                        {
+                            readyNodeStates[srcNodeId].readyIndex = newReadyIndex;
+                            AddToReadyNodeQueue(srcNodeId, lastCmdNodeId);
+                        }
                     }
                 }
 
@@ -537,13 +607,14 @@ namespace rps
                     resSchInfo.scheduledUserNodesCount++;
                     resSchInfo.mostRecentRefNodeId = scheduledNodeId;
                     RPS_ASSERT(resSchInfo.scheduledUserNodesCount <= resSchInfo.totalUserNodesCount);
+
+                    if (bUseReadyNodeQueue)
+                    {
+                        UpdateReadyResourceUsers(resIdx, lastCmdNodeId);
+                    }
                 }
 
                 lastNodeId = scheduledNodeId;
-
-                // TODO: Per queue, use actual time estimation.
-                static const uint32_t RPS_DEFAULT_COMMAND_MAKESPAN = 1;
-                currentTime += RPS_DEFAULT_COMMAND_MAKESPAN;
             }
 
             RPS_ASSERT((numScheduled + numEliminated) == nodes.size());
@@ -686,6 +757,7 @@ namespace rps
                 batchInfos.back().runtimeCmdEnd = uint32_t(runtimeCmds.size());
 
                 cmdBatches.resize(batchInfos.size());
+                cmdBatchWaitIndices.clear();
                 cmdBatchWaitIndices.reserve(numWaitFenceIdCount);
 
                 uint32_t fenceIndex = 0;
@@ -729,11 +801,24 @@ namespace rps
 
                 runtimeCmds.push_back(RuntimeCmdInfo{CMD_ID_POSTAMBLE, true});
 
+                cmdBatches.clear();
                 cmdBatches.resize(1, CommandBatch{});
                 cmdBatches.back().cmdBegin = 0;
                 cmdBatches.back().numCmds = uint32_t(runtimeCmds.size());
             }
 
+            if (flags.bUseSplitBarrier)
+            {
+                RPS_V_RETURN(SplitTransitions(context.renderGraph, scratchArena));
+            }
+
+            if (flags.bAvoidReschedule)
+            {
+                RPS_V_RETURN(CacheSchedule(scheduleInputs));
+            }
+
+            context.numSchedulesComputed++;
+
             return RPS_OK;
         }
 
@@ -749,7 +834,10 @@ namespace rps
             {
                 auto& resSchInfo = resourceSchInfos[iRes];
 
-                resSchInfo.aliasableSize           = resources[iRes].allocRequirement.size;
+                // Resources found live at the memory peak of a previous schedule are weighted higher, see
+                // RpsRenderGraphCreateInfo::scheduleInfo.numMemoryFeedbackIterations.
+                resSchInfo.aliasableSize =
+                    resources[iRes].allocRequirement.size * resources[iRes].memoryFeedbackWeight;
                 resSchInfo.scheduledUserNodesCount = 0;
                 resSchInfo.totalUserNodesCount     = 0;
             }
@@ -901,6 +989,7 @@ namespace rps
                 const auto&         transitionInfo = transitions[iTrans];
 
                 nodeResInfo.resourceRefs.SetRange(uint32_t(nodeResourceRefs.size()), 1);
+                nodeResInfo.canBeEliminated = false;
 
                 if (m_targetInfo.options.bUseAsync)
                 {
@@ -978,8 +1067,8 @@ namespace rps
                 if (sg.IsAtomic() && sgInfo.atomicParentId != RPS_INDEX_NONE_U32)
                 {
                     const Subgraph& parentAtomicSG = subgraphs[sgInfo.atomicParentId];
-                    graph.AddEdge(parentAtomicSG.beginNode, sg.beginNode);
-                    graph.AddEdge(sg.beginNode, parentAtomicSG.endNode);
+                    AddTopologyEdge(parentAtomicSG.beginNode, sg.beginNode);
+                    AddTopologyEdge(sg.beginNode, parentAtomicSG.endNode);
                 }
             }
 
@@ -1054,7 +1143,7 @@ namespace rps
 
             for (uint32_t iSrcNode = 0; iSrcNode < numSrcNodes; iSrcNode++)
             {
-                graph.AddEdge(iSrcNode, iSrcNode + 1);
+                AddTopologyEdge(iSrcNode, iSrcNode + 1);
             }
         }
 
@@ -1088,7 +1177,7 @@ namespace rps
                         const Subgraph& outermostAtomicSG = subgraphs[outermostAtomicSGIdx];
                         if (srcNode != outermostAtomicSG.beginNode)
                         {
-                            graph.AddEdge(srcNode, outermostAtomicSG.beginNode);
+                            AddTopologyEdge(srcNode, outermostAtomicSG.beginNode);
                         }
                     }
                 }
@@ -1096,7 +1185,7 @@ namespace rps
 
             if (addEdgeFromSGBegin)
             {
-                graph.AddEdge(sg.beginNode, nodeId);
+                AddTopologyEdge(sg.beginNode, nodeId);
             }
 
             RpsBool addEdgeToSGEnd = (node.outEdges.empty());
@@ -1128,7 +1217,7 @@ namespace rps
 
                         if (dstNode != outermostAtomicSG.endNode)
                         {
-                            graph.AddEdge(outermostAtomicSG.endNode, dstNode);
+                            AddTopologyEdge(outermostAtomicSG.endNode, dstNode);
                         }
                     }
                 }
@@ -1136,7 +1225,17 @@ namespace rps
 
             if (addEdgeToSGEnd)
             {
-                graph.AddEdge(nodeId, sg.endNode);
+                AddTopologyEdge(nodeId, sg.endNode);
+            }
+        }
+
+        // The schedule pass runs again on the same graph when rescheduling or when the structure is reused, so the
+        // edges it adds may exist already.
+        void AddTopologyEdge(NodeId fromNode, NodeId toNode)
+        {
+            if (!graph.HasEdge(fromNode, toNode))
+            {
+                graph.AddEdge(fromNode, toNode);
             }
         }
 
@@ -1145,26 +1244,1152 @@ namespace rps
             return id >= cmdInfos.size();
         }
 
-    private:
-        RenderGraph&  m_renderGraph;
-        TargetInfo    m_targetInfo;
+        void InitReadyNodeQueue(Arena& scratchArena)
+        {
+            readyNodeStates     = scratchArena.NewArray<ReadyNodeState>(nodes.size());
+            scoreHeapLinks      = scratchArena.NewArray<ReadyNodeHeapLinks>(nodes.size());
+            readyIndexHeapLinks = scratchArena.NewArray<ReadyNodeHeapLinks>(nodes.size());
 
-        Graph&                          graph;
-        ConstArrayRef<Node>             nodes;
-        ConstArrayRef<Subgraph>         subgraphs;
-        ConstArrayRef<ResourceInstance> resources;
-        ConstArrayRef<CmdInfo>          cmdInfos;
+            for (ReadyNodeState& state : readyNodeStates)
+            {
+                state.readyIndex  = RPS_INDEX_NONE_U32;
+                state.bucketIndex = RPS_INDEX_NONE_U32;
+            }
 
-        ArrayRef<NodeId, uint32_t>                 scheduledNodes;
-        ArrayRef<ReadyNodeInfo, uint32_t>          readyNodes;
-        ArrayRef<NodeSchedulingInfo, uint32_t>     nodeSchInfos;
-        ArrayRef<ResourceSchedulingInfo, uint32_t> resourceSchInfos;
-        ArrayRef<SubgraphSchedulingInfo, uint32_t> subgraphSchInfos;
-        ArrayRef<uint32_t, uint32_t>               nodeReadyDeps;
-        ArrayRef<uint32_t, uint32_t>               nodeAtomicSubgraphIndices;
-        ArenaVector<uint32_t>                      nodeResourceRefs;
+            readyNodeBuckets.reset(&scratchArena);
+            activeReadyNodeBuckets.reset(&scratchArena);
+            freeReadyNodeBuckets.reset(&scratchArena);
 
-        uint64_t   maxNodeMemorySize = 0;
+            // Each active bucket holds at least one ready node.
+            readyNodeBucketHashSlots =
+                scratchArena.NewArray<uint32_t>(rpsRoundUpToPowerOfTwo(rpsMax(uint32_t(nodes.size()), 1u)));
+            std::fill(readyNodeBucketHashSlots.begin(), readyNodeBucketHashSlots.end(), RPS_INDEX_NONE_U32);
+
+            eliminableNodesHeapRoot = RPS_INDEX_NONE_U32;
+
+            // Build resource -> user nodes lists, to find the ready nodes affected when a resource gets its first or
+            // last user scheduled.
+            resourceUserOffsets = scratchArena.NewArray<uint32_t>(resources.size() + 1);
+            resourceUserNodes   = scratchArena.NewArray<uint32_t>(nodeResourceRefs.size());
+
+            uint32_t numUsers = 0;
+            for (uint32_t iRes = 0, numRes = uint32_t(resources.size()); iRes < numRes; iRes++)
+            {
+                numUsers += resourceSchInfos[iRes].totalUserNodesCount;
+                resourceUserOffsets[iRes] = numUsers;
+            }
+            resourceUserOffsets[resources.size()] = numUsers;
+
+            RPS_ASSERT(numUsers == nodeResourceRefs.size());
+
+            for (uint32_t iNode = 0, numNodes = uint32_t(nodes.size()); iNode < numNodes; iNode++)
+            {
+                for (uint32_t resIdx : nodeSchInfos[iNode].resourceRefs.Get(nodeResourceRefs))
+                {
+                    resourceUserNodes[--resourceUserOffsets[resIdx]] = iNode;
+                }
+            }
+        }
+
+        void InitNodeTimeCosts(ConstArrayRef<float> cmdTimeEstimates)
+        {
+            // Without estimates every command node counts as one unit of time.
+            static constexpr float DefaultCmdNodeTimeCost = 1.0f;
+
+            for (uint32_t iNode = 0, numNodes = uint32_t(nodes.size()); iNode < numNodes; iNode++)
+            {
+                float timeCost = 0.0f;
+
+                if (!IsTransitionNode(iNode) && !nodeSchInfos[iNode].canBeEliminated)
+                {
+                    const uint32_t cmdId = nodes[iNode].GetCmdId();
+
+                    timeCost = cmdInfos[cmdId].IsNodeDeclBuiltIn()
+                                   ? 0.0f
+                                   : (useCostModel ? cmdTimeEstimates[cmdId] : DefaultCmdNodeTimeCost);
+                }
+
+                nodeTimeCosts[iNode]  = timeCost;
+                nodeReadyTimes[iNode] = 0.0f;
+            }
+        }
+
+        // Calculates the longest path from any source node to the end of each node.
+        // Scheduling runs in reverse, so picking the node with the longest path first schedules the critical path
+        // as early as possible in the frame. Transitions get the score of their commands, to keep them together.
+        void InitCriticalPathScores(Arena& scratchArena)
+        {
+            const uint32_t numNodes = uint32_t(nodes.size());
+
+            ArrayRef<float, uint32_t> nodeCriticalPathTimes = scratchArena.NewArray<float>(numNodes);
+
+            nodeCriticalPathScores = scratchArena.NewArray<uint32_t>(numNodes);
+
+            ArrayRef<uint32_t, uint32_t> pendingInEdges = scratchArena.NewArray<uint32_t>(numNodes);
+            ArrayRef<uint32_t, uint32_t> sortedNodes    = scratchArena.NewArray<uint32_t>(numNodes);
+
+            uint32_t numSorted = 0;
+
+            for (uint32_t iNode = 0; iNode < numNodes; iNode++)
+            {
+                pendingInEdges[iNode] = nodes[iNode].inEdges.size();
+
+                if (pendingInEdges[iNode] == 0)
+                {
+                    sortedNodes[numSorted++] = iNode;
+                }
+            }
+
+            const auto edges = graph.GetEdges();
+
+            float maxCriticalPathTime = 0.0f;
+
+            for (uint32_t iSorted = 0; iSorted < numSorted; iSorted++)
+            {
+                const NodeId nodeId = sortedNodes[iSorted];
+                const Node&  node   = nodes[nodeId];
+
+                float pathTime = 0.0f;
+
+                for (const Edge& inEdge : node.inEdges.Get(edges))
+                {
+                    pathTime = rpsMax(pathTime, nodeCriticalPathTimes[inEdge.src]);
+                }
+
+                pathTime += nodeTimeCosts[nodeId];
+
+                nodeCriticalPathTimes[nodeId] = pathTime;
+                maxCriticalPathTime           = rpsMax(maxCriticalPathTime, pathTime);
+
+                for (const Edge& outEdge : node.outEdges.Get(edges))
+                {
+                    if (--pendingInEdges[outEdge.dst] == 0)
+                    {
+                        sortedNodes[numSorted++] = outEdge.dst;
+                    }
+                }
+            }
+
+            RPS_ASSERT(numSorted == numNodes);
+
+            const float scoreScale = (maxCriticalPathTime > 0.0f) ? (ProgramOrderScoreMax / maxCriticalPathTime) : 0.0f;
+
+            for (uint32_t iSorted = numSorted; iSorted > 0; iSorted--)
+            {
+                const NodeId nodeId = sortedNodes[iSorted - 1];
+
+                uint32_t score = 0;
+
+                if (IsTransitionNode(nodeId))
+                {
+                    for (const Edge& outEdge : nodes[nodeId].outEdges.Get(edges))
+                    {
+                        score = rpsMax(score, nodeCriticalPathScores[outEdge.dst]);
+                    }
+                }
+                else
+                {
+                    score = uint32_t(nodeCriticalPathTimes[nodeId] * scoreScale);
+                }
+
+                nodeCriticalPathScores[nodeId] = score;
+            }
+        }
+
+        // Queues whose timeline is behind the current queue would idle unless work is scheduled on them.
+        uint32_t GetIdleQueueMask(const float (&queueTimes)[RPS_MAX_QUEUES], uint32_t currQueueIndex) const
+        {
+            uint32_t idleQueueMask = 0;
+
+            if (currQueueIndex != RPS_INDEX_NONE_U32)
+            {
+                for (uint32_t iQ = 0; iQ < m_targetInfo.numQueues; iQ++)
+                {
+                    idleQueueMask |= (queueTimes[iQ] < queueTimes[currQueueIndex]) ? (1u << iQ) : 0;
+                }
+            }
+
+            return idleQueueMask;
+        }
+
+        uint32_t CalcLocalScore(NodeId nodeId, const ReadyNodeState& state) const
+        {
+            // Prioritize nodes with smaller new allocations
+            const uint32_t memorySavingScore = uint32_t(
+                (rpsClamp<uint64_t>((maxNodeMemorySize - state.allocAliasableMemSize) >> 16, 0ull, MemoryScoreMax) +
+                 rpsClamp<uint64_t>(state.freeAliasableMemSize >> 16, 0ull, MemoryScoreMax))
+                << memoryAllocScoreShift);
+
+            const uint32_t programOrderScore =
+                useCostModel ? nodeCriticalPathScores[nodeId] : (IsTransitionNode(nodeId) ? 0 : nodeId);
+
+            return memorySavingScore | programOrderScore;
+        }
+
+        ReadyNodeKey GetReadyNodeKey(NodeId               nodeId,
+                                     const ReadyNodeInfo& readyNode,
+                                     uint32_t             localScore,
+                                     bool                 bIsInitialTransition,
+                                     uint32_t             lastCmdNodeId) const
+        {
+            const NodeSchedulingInfo& nodeInfo  = nodeSchInfos[nodeId];
+            const bool                bUseAsync = m_targetInfo.options.bUseAsync;
+
+            ReadyNodeKey key;
+            key.barrierScopeIdx  = readyNode.schBarrierScopeIdx;
+            key.atomicSubgraphId = hasAnyAtomicSubgraphs ? nodeAtomicSubgraphIndices[nodeId] : RPS_INDEX_NONE_U32;
+            key.localScoreContextBits = localScore & contextScoreBits;
+            key.validQueueMask        = uint8_t(bUseAsync ? nodeInfo.validQueueMask : 0);
+            key.preferredQueueMask    = uint8_t(bUseAsync ? nodeInfo.preferredQueueMask : 0);
+            key.workloadTypeMask      = uint8_t(nodeInfo.workloadTypeMask);
+            key.flags = uint8_t((IsTransitionNode(nodeId) ? READY_NODE_KEY_TRANSITION_BIT : 0) |
+                                (bIsInitialTransition ? READY_NODE_KEY_INITIAL_TRANSITION_BIT : 0) |
+                                ((bUseAsync && (readyNode.depNodeId == lastCmdNodeId))
+                                     ? READY_NODE_KEY_IMMEDIATE_DEPENDENT_BIT
+                                     : 0));
+            return key;
+        }
+
+        // Returns the node score before clamping, given the context independent part of the node score.
+        uint32_t CalcReadyNodeScore(const ReadyNodeKey& key, uint32_t localScore, const ScoringContext& ctx) const
+        {
+            const ScheduleFlags& flags = m_targetInfo.options;
+
+            const bool currNodeIsTransition = !!(key.flags & READY_NODE_KEY_TRANSITION_BIT);
+
+            // Barrier batching scoring.
+            // With time estimates, transitions of the last command are kept with it instead of being batched with
+            // later ones, which would also move their cross queue waits earlier.
+            const bool bKeepWithLastCmd = useCostModel && currNodeIsTransition &&
+                                          !!(key.flags & READY_NODE_KEY_IMMEDIATE_DEPENDENT_BIT);
+
+            const uint32_t barrierBatchingScore =
+                (((ctx.lastNodeIsTransition == currNodeIsTransition) || bKeepWithLastCmd) ? barrierBatchingBit : 0);
+
+            // Workload type scoring
+            uint32_t pipelineWorkTypeScore = 0;
+
+            if (!(currNodeIsTransition || ctx.lastNodeIsTransition))
+            {
+                const bool workloadTypeEq = (nodeSchInfos[ctx.lastCmdNodeId].workloadTypeMask == key.workloadTypeMask);
+
+                if (flags.bMinimizeGfxCompSwitch)
+                    pipelineWorkTypeScore = workloadTypeEq ? WorkTypeGroupingBit : 0;
+                else if (!flags.bWorkloadTypePipeliningDisabled)
+                    pipelineWorkTypeScore = workloadTypeEq ? 0 : WorkTypeGroupingBit;
+            }
+            else if (ctx.lastNodeIsTransition && flags.bWorkloadTypePipeliningAggressive)
+            {
+                // TODO: Check the benefit / effect of this. Add a flag for control?
+                pipelineWorkTypeScore = (key.workloadTypeMask & RPS_NODE_DECL_GRAPHICS_BIT) ? WorkTypeInterleaveBit : 0;
+            }
+
+            // Maximize memory saving score if the transition node is the initial access of a resource and
+            // is ready to be batched into a transition batch.
+            if ((key.flags & READY_NODE_KEY_INITIAL_TRANSITION_BIT) && ctx.lastNodeIsTransition)
+            {
+                localScore = MemoryScoreMax << memoryAllocScoreShift;
+            }
+
+            // Queue scoring:
+
+            uint32_t queueScore = QueueScoreBit;
+
+            if (flags.bUseAsync)
+            {
+                // Prioritize independent node between workload on another queue and its immediate dependent node.
+
+                // Penalize nodes who want a queue switch.
+                if (!rpsAnyBitsSet(ctx.currQueueMask, key.preferredQueueMask))
+                {
+                    queueScore = (QueueScoreBit >> 1);
+
+                    // Candidate require a queue switch, and is an immediate dependent node of the previously scheduled command,
+                    // raise penalty.
+                    if ((!rpsAnyBitsSet(ctx.currQueueMask, key.validQueueMask)) &&
+                        (key.flags & READY_NODE_KEY_IMMEDIATE_DEPENDENT_BIT))
+                    {
+                        queueScore = 0;
+                    }
+                    // Don't penalize switching to a queue that would otherwise idle, unless the candidate has to
+                    // wait for the previously scheduled command anyway.
+                    else if (rpsAnyBitsSet(ctx.idleQueueMask, key.preferredQueueMask) &&
+                             !(key.flags & READY_NODE_KEY_IMMEDIATE_DEPENDENT_BIT))
+                    {
+                        queueScore = QueueScoreBit;
+                    }
+                }
+            }
+
+            // Schedule barriers & Atomic subgraph should have highest priority.
+            uint32_t scopeScore = ScopeScoreBit;  // This is the highest bit
+
+            // Penalize nodes in an earlier barrier scope.
+            if (key.barrierScopeIdx < ctx.lastBarrierScopeIdx)
+            {
+                scopeScore = 0;
+            }
+
+            // Penalize nodes in another atomic subgraph.
+            const uint32_t currAtomicSubgraphId = key.atomicSubgraphId;
+            if (hasAnyAtomicSubgraphs && (currAtomicSubgraphId != ctx.lastAtomicSubgraphId) &&
+                ((currAtomicSubgraphId == RPS_INDEX_NONE_U32) ||
+                 (ctx.lastAtomicSubgraphId != subgraphSchInfos[currAtomicSubgraphId].atomicParentId)))
+            {
+                scopeScore = 0;
+            }
+
+            // Individual score categories should already be in their own bit range,
+            // OR them together as the final score.
+            return (scopeScore | queueScore | barrierBatchingScore | localScore | pipelineWorkTypeScore);
+        }
+
+        // Scores every ready node. Used for random order, where the program order score changes per pick, and for
+        // the reference scheduler.
+        uint32_t PickReadyNodeLinear(const ScoringContext&           ctx,
+                                     uint32_t                        numReadyNodes,
+                                     const RpsRandomNumberGenerator& randGen,
+                                     uint32_t                        maxCmdNodeId) const
+        {
+            const bool bRandomOrder = m_targetInfo.options.bRandomOrder;
+
+            uint32_t highScore      = 0;
+            uint32_t highScoreIndex = UINT32_MAX;
+
+            for (uint32_t iRN = 0; iRN < numReadyNodes; iRN++)
+            {
+                const uint32_t currNodeId = readyNodes[iRN].nodeId;
+
+                if (nodeSchInfos[currNodeId].canBeEliminated)
+                {
+                    highScoreIndex = iRN;
+                    break;
+                }
+
+                ReadyNodeKey key;
+                uint32_t     localScore;
+
+                if (bRandomOrder)
+                {
+                    // Program order scoring, memory saving is ignored in random order mode.
+                    const uint32_t nodeOrder = randGen.pfnRandomUniformInt(randGen.pContext, 0, maxCmdNodeId);
+
+                    localScore = IsTransitionNode(currNodeId) ? 0 : nodeOrder;
+                    key        = GetReadyNodeKey(currNodeId, readyNodes[iRN], 0, false, ctx.lastCmdNodeId);
+                }
+                else if (!useReadyNodeQueue)
+                {
+                    // Reference scoring, without any state kept by the ready node queue.
+                    ReadyNodeState state;
+                    CalcAliasableMemSizes(currNodeId, state);
+
+                    const bool bIsInitialTransition = IsTransitionNode(currNodeId) && (state.freeAliasableMemSize != 0);
+
+                    localScore = CalcLocalScore(currNodeId, state);
+                    key        = GetReadyNodeKey(
+                        currNodeId, readyNodes[iRN], localScore, bIsInitialTransition, ctx.lastCmdNodeId);
+                }
+                else
+                {
+                    const ReadyNodeState& state = readyNodeStates[currNodeId];
+
+                    localScore = state.localScore;
+                    key        = readyNodeBuckets[state.bucketIndex].key;
+                }
+
+                const uint32_t currScore = rpsMax(CalcReadyNodeScore(key, localScore, ctx), 1u);
+
+                if (highScore < currScore)
+                {
+                    highScore      = currScore;
+                    highScoreIndex = iRN;
+                }
+            }
+
+            return highScoreIndex;
+        }
+
+        // Returns the ready list index of the best node, or RPS_INDEX_NONE_U32 if the candidates can't be told apart
+        // from bucket tops and a linear scan is needed.
+        uint32_t PickReadyNodeFromQueue(const ScoringContext& ctx) const
+        {
+            // Nodes to eliminate are picked first, in ready list order.
+            if (eliminableNodesHeapRoot != RPS_INDEX_NONE_U32)
+            {
+                return readyNodeStates[eliminableNodesHeapRoot].readyIndex;
+            }
+
+            uint32_t highScore      = 0;
+            uint32_t highScoreIndex = RPS_INDEX_NONE_U32;
+
+            for (uint32_t bucketIndex : activeReadyNodeBuckets)
+            {
+                const ReadyNodeBucket& bucket = readyNodeBuckets[bucketIndex];
+
+                // Initial transitions all get the max memory saving score after a transition,
+                // the first one in ready list order wins.
+                const bool bUseReadyIndexOrder =
+                    (bucket.key.flags & READY_NODE_KEY_INITIAL_TRANSITION_BIT) && ctx.lastNodeIsTransition;
+
+                const uint32_t        topNodeId = bUseReadyIndexOrder ? bucket.readyIndexHeapRoot : bucket.scoreHeapRoot;
+                const ReadyNodeState& topState  = readyNodeStates[topNodeId];
+
+                const uint32_t rawScore = CalcReadyNodeScore(bucket.key, topState.localScore, ctx);
+
+                // Scores 0 and 1 are clamped to the same value, so ready list order decides between them instead.
+                if (!bUseReadyIndexOrder && (rawScore == 1))
+                {
+                    return RPS_INDEX_NONE_U32;
+                }
+
+                const uint32_t currScore = rpsMax(rawScore, 1u);
+
+                if ((highScore < currScore) || ((highScore == currScore) && (topState.readyIndex < highScoreIndex)))
+                {
+                    highScore      = currScore;
+                    highScoreIndex = topState.readyIndex;
+                }
+            }
+
+            return highScoreIndex;
+        }
+
+        void AddToReadyNodeQueue(NodeId nodeId, uint32_t lastCmdNodeId)
+        {
+            ReadyNodeState& state = readyNodeStates[nodeId];
+
+            RPS_ASSERT(state.readyIndex != RPS_INDEX_NONE_U32);
+
+            if (nodeSchInfos[nodeId].canBeEliminated)
+            {
+                state.bucketIndex       = RPS_INDEX_NONE_U32;
+                eliminableNodesHeapRoot = HeapInsert(eliminableNodesHeapRoot, nodeId, true);
+                return;
+            }
+
+            CalcAliasableMemSizes(nodeId, state);
+
+            AddToReadyNodeBucket(nodeId, lastCmdNodeId);
+        }
+
+        void CalcAliasableMemSizes(NodeId nodeId, ReadyNodeState& state) const
+        {
+            state.allocAliasableMemSize = 0;
+            state.freeAliasableMemSize  = 0;
+
+            for (uint32_t resIdx : nodeSchInfos[nodeId].resourceRefs.Get(nodeResourceRefs))
+            {
+                const ResourceSchedulingInfo& resSchInfo = resourceSchInfos[resIdx];
+
+                if (resSchInfo.scheduledUserNodesCount == 0)  // First access to a resource
+                {
+                    state.allocAliasableMemSize += resSchInfo.aliasableSize;
+                }
+
+                if ((resSchInfo.scheduledUserNodesCount + 1) ==
+                    resSchInfo.totalUserNodesCount)  // Last access to a resource
+                {
+                    state.freeAliasableMemSize += resSchInfo.aliasableSize;
+                }
+            }
+        }
+
+        void RemoveFromReadyNodeQueue(NodeId nodeId)
+        {
+            ReadyNodeState& state = readyNodeStates[nodeId];
+
+            if (state.bucketIndex == RPS_INDEX_NONE_U32)
+            {
+                eliminableNodesHeapRoot = HeapRemove(eliminableNodesHeapRoot, nodeId, true);
+            }
+            else
+            {
+                RemoveFromReadyNodeBucket(nodeId);
+            }
+
+            state.readyIndex = RPS_INDEX_NONE_U32;
+        }
+
+        // Called when a node is moved to an earlier ready list slot.
+        void PromoteReadyNode(NodeId nodeId, uint32_t newReadyIndex)
+        {
+            ReadyNodeState& state = readyNodeStates[nodeId];
+
+            RPS_ASSERT(newReadyIndex < state.readyIndex);
+            state.readyIndex = newReadyIndex;
+
+            if (state.bucketIndex == RPS_INDEX_NONE_U32)
+            {
+                eliminableNodesHeapRoot = HeapPromote(eliminableNodesHeapRoot, nodeId, true);
+                return;
+            }
+
+            ReadyNodeBucket& bucket = readyNodeBuckets[state.bucketIndex];
+
+            bucket.scoreHeapRoot = HeapPromote(bucket.scoreHeapRoot, nodeId, false);
+
+            if (bucket.key.flags & READY_NODE_KEY_INITIAL_TRANSITION_BIT)
+            {
+                bucket.readyIndexHeapRoot = HeapPromote(bucket.readyIndexHeapRoot, nodeId, true);
+            }
+        }
+
+        // Nodes made ready by prevCmdNodeId were its immediate dependents, which only affects queue scoring.
+        void UpdateImmediateDependents(NodeId prevCmdNodeId, uint32_t lastCmdNodeId)
+        {
+            for (const Edge& inEdge : nodes[prevCmdNodeId].inEdges.Get(graph.GetEdges()))
+            {
+                const ReadyNodeState& state = readyNodeStates[inEdge.src];
+
+                if ((state.readyIndex != RPS_INDEX_NONE_U32) && (state.bucketIndex != RPS_INDEX_NONE_U32) &&
+                    (readyNodes[state.readyIndex].depNodeId == prevCmdNodeId))
+                {
+                    UpdateReadyNodeBucket(inEdge.src, lastCmdNodeId);
+                }
+            }
+        }
+
+        // Updates the memory saving score of ready nodes using resIdx, after a user of it got scheduled.
+        void UpdateReadyResourceUsers(uint32_t resIdx, uint32_t lastCmdNodeId)
+        {
+            const ResourceSchedulingInfo& resSchInfo = resourceSchInfos[resIdx];
+
+            const bool bIsFirstScheduledUser = (resSchInfo.scheduledUserNodesCount == 1);
+            const bool bHasOneUserLeft       = ((resSchInfo.scheduledUserNodesCount + 1) == resSchInfo.totalUserNodesCount);
+
+            if ((resSchInfo.aliasableSize == 0) || !(bIsFirstScheduledUser || bHasOneUserLeft))
+            {
+                return;
+            }
+
+            for (uint32_t iUser = resourceUserOffsets[resIdx], userEnd = resourceUserOffsets[resIdx + 1];
+                 iUser < userEnd;
+                 iUser++)
+            {
+                const NodeId    userNodeId = resourceUserNodes[iUser];
+                ReadyNodeState& state      = readyNodeStates[userNodeId];
+
+                if ((state.readyIndex == RPS_INDEX_NONE_U32) || (state.bucketIndex == RPS_INDEX_NONE_U32))
+                {
+                    continue;
+                }
+
+                if (bIsFirstScheduledUser)
+                {
+                    state.allocAliasableMemSize -= resSchInfo.aliasableSize;
+                }
+
+                if (bHasOneUserLeft)
+                {
+                    state.freeAliasableMemSize += resSchInfo.aliasableSize;
+                }
+
+                UpdateReadyNodeBucket(userNodeId, lastCmdNodeId);
+            }
+        }
+
+        void UpdateReadyNodeBucket(NodeId nodeId, uint32_t lastCmdNodeId)
+        {
+            RemoveFromReadyNodeBucket(nodeId);
+            AddToReadyNodeBucket(nodeId, lastCmdNodeId);
+        }
+
+        void AddToReadyNodeBucket(NodeId nodeId, uint32_t lastCmdNodeId)
+        {
+            ReadyNodeState& state = readyNodeStates[nodeId];
+
+            state.localScore = CalcLocalScore(nodeId, state);
+
+            const bool bIsInitialTransition = IsTransitionNode(nodeId) && (state.freeAliasableMemSize != 0);
+
+            const ReadyNodeKey key = GetReadyNodeKey(
+                nodeId, readyNodes[state.readyIndex], state.localScore, bIsInitialTransition, lastCmdNodeId);
+
+            const uint32_t hashSlot    = GetReadyNodeBucketHashSlot(key);
+            uint32_t       bucketIndex = readyNodeBucketHashSlots[hashSlot];
+
+            while ((bucketIndex != RPS_INDEX_NONE_U32) && !(readyNodeBuckets[bucketIndex].key == key))
+            {
+                bucketIndex = readyNodeBuckets[bucketIndex].nextInHashSlot;
+            }
+
+            if (bucketIndex == RPS_INDEX_NONE_U32)
+            {
+                if (!freeReadyNodeBuckets.empty())
+                {
+                    bucketIndex = freeReadyNodeBuckets.back();
+                    freeReadyNodeBuckets.pop_back();
+                }
+                else
+                {
+                    bucketIndex = uint32_t(readyNodeBuckets.size());
+                    readyNodeBuckets.emplace_back();
+                }
+
+                ReadyNodeBucket& newBucket   = readyNodeBuckets[bucketIndex];
+                newBucket.key                = key;
+                newBucket.scoreHeapRoot      = RPS_INDEX_NONE_U32;
+                newBucket.readyIndexHeapRoot = RPS_INDEX_NONE_U32;
+                newBucket.activeIndex        = uint32_t(activeReadyNodeBuckets.size());
+                newBucket.hashSlot           = hashSlot;
+                newBucket.nextInHashSlot     = readyNodeBucketHashSlots[hashSlot];
+
+                readyNodeBucketHashSlots[hashSlot] = bucketIndex;
+                activeReadyNodeBuckets.push_back(bucketIndex);
+            }
+
+            ReadyNodeBucket& bucket = readyNodeBuckets[bucketIndex];
+
+            bucket.scoreHeapRoot = HeapInsert(bucket.scoreHeapRoot, nodeId, false);
+
+            if (bIsInitialTransition)
+            {
+                bucket.readyIndexHeapRoot = HeapInsert(bucket.readyIndexHeapRoot, nodeId, true);
+            }
+
+            state.bucketIndex = bucketIndex;
+        }
+
+        uint32_t GetReadyNodeBucketHashSlot(const ReadyNodeKey& key) const
+        {
+            const uint64_t hash = rpsHashValue(key);
+            return uint32_t(hash ^ (hash >> 32)) & (uint32_t(readyNodeBucketHashSlots.size()) - 1);
+        }
+
+        void RemoveFromReadyNodeBucket(NodeId nodeId)
+        {
+            ReadyNodeState&  state  = readyNodeStates[nodeId];
+            ReadyNodeBucket& bucket = readyNodeBuckets[state.bucketIndex];
+
+            bucket.scoreHeapRoot = HeapRemove(bucket.scoreHeapRoot, nodeId, false);
+
+            if (bucket.key.flags & READY_NODE_KEY_INITIAL_TRANSITION_BIT)
+            {
+                bucket.readyIndexHeapRoot = HeapRemove(bucket.readyIndexHeapRoot, nodeId, true);
+            }
+
+            if (bucket.scoreHeapRoot == RPS_INDEX_NONE_U32)
+            {
+                const uint32_t lastActiveBucketIndex = activeReadyNodeBuckets.back();
+
+                activeReadyNodeBuckets[bucket.activeIndex]         = lastActiveBucketIndex;
+                readyNodeBuckets[lastActiveBucketIndex].activeIndex = bucket.activeIndex;
+                activeReadyNodeBuckets.pop_back();
+
+                uint32_t* pHashLink = &readyNodeBucketHashSlots[bucket.hashSlot];
+
+                while (*pHashLink != state.bucketIndex)
+                {
+                    pHashLink = &readyNodeBuckets[*pHashLink].nextInHashSlot;
+                }
+
+                *pHashLink = bucket.nextInHashSlot;
+
+                freeReadyNodeBuckets.push_back(state.bucketIndex);
+            }
+
+            state.bucketIndex = RPS_INDEX_NONE_U32;
+        }
+
+        // Pairing heap over ready nodes. Nodes are ordered either by local score then ready list index,
+        // or by ready list index only. Each order uses its own set of links.
+
+        bool IsBetterReadyNode(NodeId lhs, NodeId rhs, bool bByReadyIndex) const
+        {
+            const ReadyNodeState& lhsState = readyNodeStates[lhs];
+            const ReadyNodeState& rhsState = readyNodeStates[rhs];
+
+            if (!bByReadyIndex && (lhsState.localScore != rhsState.localScore))
+            {
+                return lhsState.localScore > rhsState.localScore;
+            }
+
+            return lhsState.readyIndex < rhsState.readyIndex;
+        }
+
+        ArrayRef<ReadyNodeHeapLinks, uint32_t>& GetHeapLinks(bool bByReadyIndex)
+        {
+            return bByReadyIndex ? readyIndexHeapLinks : scoreHeapLinks;
+        }
+
+        uint32_t HeapMeld(uint32_t lhs, uint32_t rhs, bool bByReadyIndex)
+        {
+            if (lhs == RPS_INDEX_NONE_U32)
+                return rhs;
+            if (rhs == RPS_INDEX_NONE_U32)
+                return lhs;
+
+            if (IsBetterReadyNode(rhs, lhs, bByReadyIndex))
+            {
+                std::swap(lhs, rhs);
+            }
+
+            auto& links = GetHeapLinks(bByReadyIndex);
+
+            links[rhs].prev    = lhs;
+            links[rhs].sibling = links[lhs].child;
+
+            if (links[lhs].child != RPS_INDEX_NONE_U32)
+            {
+                links[links[lhs].child].prev = rhs;
+            }
+
+            links[lhs].child = rhs;
+
+            return lhs;
+        }
+
+        // Melds a sibling list in two passes, returns the new root.
+        uint32_t HeapMergePairs(uint32_t first, bool bByReadyIndex)
+        {
+            auto& links = GetHeapLinks(bByReadyIndex);
+
+            uint32_t pairs = RPS_INDEX_NONE_U32;
+
+            while (first != RPS_INDEX_NONE_U32)
+            {
+                const uint32_t second = links[first].sibling;
+                const uint32_t next   = (second != RPS_INDEX_NONE_U32) ? links[second].sibling : RPS_INDEX_NONE_U32;
+
+                links[first].sibling = RPS_INDEX_NONE_U32;
+                links[first].prev    = RPS_INDEX_NONE_U32;
+
+                if (second != RPS_INDEX_NONE_U32)
+                {
+                    links[second].sibling = RPS_INDEX_NONE_U32;
+                    links[second].prev    = RPS_INDEX_NONE_U32;
+                }
+
+                const uint32_t merged = HeapMeld(first, second, bByReadyIndex);
+
+                links[merged].sibling = pairs;
+                pairs                 = merged;
+
+                first = next;
+            }
+
+            uint32_t root = pairs;
+
+            if (root != RPS_INDEX_NONE_U32)
+            {
+                pairs              = links[root].sibling;
+                links[root].sibling = RPS_INDEX_NONE_U32;
+
+                while (pairs != RPS_INDEX_NONE_U32)
+                {
+                    const uint32_t next = links[pairs].sibling;
+                    links[pairs].sibling = RPS_INDEX_NONE_U32;
+
+                    root  = HeapMeld(root, pairs, bByReadyIndex);
+                    pairs = next;
+                }
+
+                links[root].prev = RPS_INDEX_NONE_U32;
+            }
+
+            return root;
+        }
+
+        void HeapDetach(uint32_t nodeId, bool bByReadyIndex)
+        {
+            auto& links = GetHeapLinks(bByReadyIndex);
+
+            const uint32_t prev    = links[nodeId].prev;
+            const uint32_t sibling = links[nodeId].sibling;
+
+            if (links[prev].child == nodeId)
+                links[prev].child = sibling;
+            else
+                links[prev].sibling = sibling;
+
+            if (sibling != RPS_INDEX_NONE_U32)
+            {
+                links[sibling].prev = prev;
+            }
+
+            links[nodeId].prev    = RPS_INDEX_NONE_U32;
+            links[nodeId].sibling = RPS_INDEX_NONE_U32;
+        }
+
+        uint32_t HeapInsert(uint32_t root, uint32_t nodeId, bool bByReadyIndex)
+        {
+            GetHeapLinks(bByReadyIndex)[nodeId] = {RPS_INDEX_NONE_U32, RPS_INDEX_NONE_U32, RPS_INDEX_NONE_U32};
+
+            return HeapMeld(root, nodeId, bByReadyIndex);
+        }
+
+        uint32_t HeapRemove(uint32_t root, uint32_t nodeId, bool bByReadyIndex)
+        {
+            auto& links = GetHeapLinks(bByReadyIndex);
+
+            const uint32_t children = links[nodeId].child;
+            links[nodeId].child     = RPS_INDEX_NONE_U32;
+
+            if (nodeId == root)
+            {
+                return HeapMergePairs(children, bByReadyIndex);
+            }
+
+            HeapDetach(nodeId, bByReadyIndex);
+
+            return HeapMeld(root, HeapMergePairs(children, bByReadyIndex), bByReadyIndex);
+        }
+
+        // Restores heap order after a node got a better key.
+        uint32_t HeapPromote(uint32_t root, uint32_t nodeId, bool bByReadyIndex)
+        {
+            if (nodeId == root)
+            {
+                return root;
+            }
+
+            HeapDetach(nodeId, bByReadyIndex);
+
+            return HeapMeld(root, nodeId, bByReadyIndex);
+        }
+
+        // Gathers everything the scoring loop and the batch analysis depend on.
+        void GatherScheduleInputs(CacheInputs&     inputs,
+                                  RpsScheduleFlags scheduleFlags,
+                                  uint64_t         frameIndex,
+                                  bool             bHasAnyAtomicSubgraphs) const
+        {
+            inputs.Add(scheduleFlags);
+            inputs.Add(m_targetInfo.numQueues);
+            inputs.Add(useCostModel);
+            inputs.Add(uint32_t(nodes.size()));
+            inputs.Add(uint32_t(cmdInfos.size()));
+            inputs.Add(maxNodeMemorySize);
+            inputs.Add(barrierBatchingBit);
+
+            const auto edges = graph.GetEdges();
+
+            for (uint32_t iNode = 0, numNodes = uint32_t(nodes.size()); iNode < numNodes; iNode++)
+            {
+                const Node&               node     = nodes[iNode];
+                const NodeSchedulingInfo& nodeInfo = nodeSchInfos[iNode];
+
+                const uint32_t nodeBits = nodeInfo.validQueueMask | (nodeInfo.preferredQueueMask << 8) |
+                                          (uint32_t(nodeInfo.workloadTypeMask) << 16) |
+                                          (nodeInfo.canBeEliminated << 24) |
+                                          ((!IsTransitionNode(iNode) && cmdInfos[iNode].IsNodeDeclBuiltIn()) << 25);
+
+                inputs.Add(nodeBits);
+                inputs.Add(node.barrierScope);
+                inputs.Add(uint32_t(node.outEdges.size()));
+
+                if (bHasAnyAtomicSubgraphs)
+                {
+                    inputs.Add(nodeAtomicSubgraphIndices[iNode]);
+                }
+
+                // In-edge order determines the order nodes become ready.
+                inputs.Add(uint32_t(node.inEdges.size()));
+
+                for (const Edge& inEdge : node.inEdges.Get(edges))
+                {
+                    inputs.Add(inEdge.src);
+                }
+
+                if (useCostModel)
+                {
+                    inputs.Add(nodeTimeCosts[iNode]);
+                }
+
+                inputs.Add(uint32_t(nodeInfo.resourceRefs.size()));
+
+                for (uint32_t resIdx : nodeInfo.resourceRefs.Get(nodeResourceRefs))
+                {
+                    const ResourceSchedulingInfo& resSchInfo = resourceSchInfos[resIdx];
+                    const ResourceInstance&       resInst    = resources[resIdx];
+
+                    // Temporal slices rotate every frame, identify them by declaration and relative layer instead.
+                    uint32_t resKey[2] = {resIdx, 0};
+
+                    if (resInst.isTemporalSlice)
+                    {
+                        const ResourceInstance& parent    = resources[resInst.resourceDeclId];
+                        const uint32_t          numLayers = parent.desc.temporalLayers;
+                        const uint32_t          layer     = resIdx - parent.temporalLayerOffset;
+
+                        resKey[0] = resInst.resourceDeclId;
+                        resKey[1] = (layer + numLayers - uint32_t(frameIndex % numLayers)) % numLayers + 1;
+                    }
+
+                    inputs.Add(resKey);
+                    inputs.Add(resSchInfo.aliasableSize);
+                    inputs.Add(resSchInfo.totalUserNodesCount);
+                }
+            }
+
+            if (bHasAnyAtomicSubgraphs)
+            {
+                for (uint32_t iSG = 0, numSGs = uint32_t(subgraphs.size()); iSG < numSGs; iSG++)
+                {
+                    inputs.Add(subgraphs[iSG].beginNode);
+                    inputs.Add(subgraphSchInfos[iSG].atomicParentId);
+                }
+            }
+        }
+
+        // Splits transitions that have command nodes scheduled between the last previous access and the next access
+        // of the subresource. The begin half is placed right after the last previous access and the end half right
+        // before the first next access. Transitions are only split if all their accesses are in the same command
+        // batch, so neither half has to wait for another queue.
+        RpsResult SplitTransitions(RenderGraph& renderGraph, Arena& scratchArena)
+        {
+            auto&      runtimeCmds = renderGraph.GetRuntimeCmdInfos();
+            auto&      cmdBatches  = renderGraph.GetCmdBatches();
+            const auto transitions = renderGraph.GetTransitions().crange_all();
+            const auto edges       = graph.GetEdges();
+
+            ArenaCheckPoint arenaCheckpoint{scratchArena};
+
+            const uint32_t numRuntimeCmds = uint32_t(runtimeCmds.size());
+
+            auto nodeRuntimeCmdIndices = scratchArena.NewArray<uint32_t>(nodes.size());
+            auto numCmdNodesBefore     = scratchArena.NewArray<uint32_t>(numRuntimeCmds + 1);
+
+            std::fill(nodeRuntimeCmdIndices.begin(), nodeRuntimeCmdIndices.end(), RPS_INDEX_NONE_U32);
+
+            numCmdNodesBefore[0] = 0;
+
+            for (uint32_t iCmd = 0; iCmd < numRuntimeCmds; iCmd++)
+            {
+                const RuntimeCmdInfo& runtimeCmd = runtimeCmds[iCmd];
+
+                if (!runtimeCmd.isTransition)
+                {
+                    nodeRuntimeCmdIndices[runtimeCmd.cmdId] = iCmd;
+                }
+                else if (runtimeCmd.HasTransitionInfo())
+                {
+                    nodeRuntimeCmdIndices[transitions[runtimeCmd.cmdId].nodeId] = iCmd;
+                }
+
+                numCmdNodesBefore[iCmd + 1] = numCmdNodesBefore[iCmd] + (runtimeCmd.isTransition ? 0 : 1);
+            }
+
+            // Both halves of a split transition, inserted before the runtime cmd at the given index.
+            struct SplitBarrierHalf
+            {
+                uint32_t insertBefore;
+                uint32_t transitionCmdIndex;
+                bool     bBegin;
+            };
+
+            ArenaVector<SplitBarrierHalf> splitBarrierHalves(&scratchArena);
+
+            auto splitTransitionMask = scratchArena.NewArray<bool>(numRuntimeCmds);
+            std::fill(splitTransitionMask.begin(), splitTransitionMask.end(), false);
+
+            for (const RpsCommandBatch& batch : cmdBatches)
+            {
+                const uint32_t batchEnd = batch.cmdBegin + batch.numCmds;
+
+                for (uint32_t iCmd = batch.cmdBegin; iCmd < batchEnd; iCmd++)
+                {
+                    if (!runtimeCmds[iCmd].HasTransitionInfo())
+                        continue;
+
+                    const Node& transNode = nodes[transitions[runtimeCmds[iCmd].cmdId].nodeId];
+
+                    // Transitions without a previous access in the frame start from the initial state and may carry
+                    // aliasing barriers, leave them in place.
+                    uint32_t beginIndex = RPS_INDEX_NONE_U32;
+                    uint32_t endIndex   = RPS_INDEX_NONE_U32;
+                    bool     bSameBatch = true;
+
+                    for (auto& inEdge : transNode.inEdges.Get(edges))
+                    {
+                        const uint32_t srcIndex = nodeRuntimeCmdIndices[inEdge.src];
+
+                        if (srcIndex != RPS_INDEX_NONE_U32)
+                        {
+                            bSameBatch &= (srcIndex >= batch.cmdBegin);
+                            beginIndex = (beginIndex == RPS_INDEX_NONE_U32) ? (srcIndex + 1)
+                                                                            : rpsMax(beginIndex, srcIndex + 1);
+                        }
+                    }
+
+                    for (auto& outEdge : transNode.outEdges.Get(edges))
+                    {
+                        const uint32_t dstIndex = nodeRuntimeCmdIndices[outEdge.dst];
+
+                        if (dstIndex != RPS_INDEX_NONE_U32)
+                        {
+                            bSameBatch &= (dstIndex < batchEnd);
+                            endIndex = rpsMin(endIndex, dstIndex);
+                        }
+                    }
+
+                    if (bSameBatch && (beginIndex != RPS_INDEX_NONE_U32) && (endIndex != RPS_INDEX_NONE_U32) &&
+                        (numCmdNodesBefore[endIndex] > numCmdNodesBefore[beginIndex]))
+                    {
+                        RPS_ASSERT((beginIndex <= iCmd) && (iCmd < endIndex));
+
+                        splitTransitionMask[iCmd] = true;
+
+                        RPS_CHECK_ALLOC(splitBarrierHalves.push_back(SplitBarrierHalf{beginIndex, iCmd, true}));
+                        RPS_CHECK_ALLOC(splitBarrierHalves.push_back(SplitBarrierHalf{endIndex, iCmd, false}));
+                    }
+                }
+            }
+
+            RPS_RETURN_OK_IF(splitBarrierHalves.empty());
+
+            std::sort(splitBarrierHalves.begin(),
+                      splitBarrierHalves.end(),
+                      [](const SplitBarrierHalf& a, const SplitBarrierHalf& b) {
+                          return (a.insertBefore < b.insertBefore) ||
+                                 ((a.insertBefore == b.insertBefore) && (a.transitionCmdIndex < b.transitionCmdIndex));
+                      });
+
+            ArenaVector<RuntimeCmdInfo> prevRuntimeCmds(&scratchArena);
+            RPS_CHECK_ALLOC(prevRuntimeCmds.resize(numRuntimeCmds));
+            std::copy(runtimeCmds.begin(), runtimeCmds.end(), prevRuntimeCmds.begin());
+
+            // Each split transition is replaced by its two halves.
+            const uint32_t numSplitTransitions = uint32_t(splitBarrierHalves.size() / 2);
+            RPS_CHECK_ALLOC(runtimeCmds.resize(numRuntimeCmds + numSplitTransitions));
+
+            // New index of the first runtime cmd inserted at each previous runtime cmd index.
+            auto newRuntimeCmdIndices = scratchArena.NewArray<uint32_t>(numRuntimeCmds + 1);
+
+            uint32_t iHalf    = 0;
+            uint32_t newIndex = 0;
+
+            for (uint32_t iCmd = 0; iCmd <= numRuntimeCmds; iCmd++)
+            {
+                newRuntimeCmdIndices[iCmd] = newIndex;
+
+                for (; (iHalf < splitBarrierHalves.size()) && (splitBarrierHalves[iHalf].insertBefore == iCmd); iHalf++)
+                {
+                    const SplitBarrierHalf& half = splitBarrierHalves[iHalf];
+
+                    RuntimeCmdInfo halfCmd{prevRuntimeCmds[half.transitionCmdIndex].cmdId, true};
+                    halfCmd.isSplitBarrierBegin = half.bBegin ? 1 : 0;
+                    halfCmd.isSplitBarrierEnd   = half.bBegin ? 0 : 1;
+
+                    runtimeCmds[newIndex++] = halfCmd;
+                }
+
+                if ((iCmd < numRuntimeCmds) && !splitTransitionMask[iCmd])
+                {
+                    runtimeCmds[newIndex++] = prevRuntimeCmds[iCmd];
+                }
+            }
+
+            RPS_ASSERT(newIndex == runtimeCmds.size());
+
+            // Halves are never inserted at the first cmd of a batch or after its last cmd.
+            for (RpsCommandBatch& batch : cmdBatches)
+            {
+                const uint32_t newCmdBegin = newRuntimeCmdIndices[batch.cmdBegin];
+
+                batch.numCmds  = newRuntimeCmdIndices[batch.cmdBegin + batch.numCmds] - newCmdBegin;
+                batch.cmdBegin = newCmdBegin;
+            }
+
+            return RPS_OK;
+        }
+
+        RpsResult CacheSchedule(const CacheInputs& scheduleInputs)
+        {
+            const auto& runtimeCmds          = m_renderGraph.GetRuntimeCmdInfos();
+            const auto& cmdBatches           = m_renderGraph.GetCmdBatches();
+            const auto& cmdBatchWaitFenceIds = m_renderGraph.GetCmdBatchWaitFenceIds();
+
+            m_scheduleCacheArena.Reset();
+            m_cachedRuntimeCmds.reset(&m_scheduleCacheArena);
+            m_cachedCmdBatches.reset(&m_scheduleCacheArena);
+            m_cachedCmdBatchWaitFenceIds.reset(&m_scheduleCacheArena);
+            m_cachedScheduleInputs.Reset(&m_scheduleCacheArena);
+
+            RPS_CHECK_ALLOC(m_cachedRuntimeCmds.resize(runtimeCmds.size()));
+            RPS_CHECK_ALLOC(m_cachedCmdBatches.resize(cmdBatches.size()));
+            RPS_CHECK_ALLOC(m_cachedCmdBatchWaitFenceIds.resize(cmdBatchWaitFenceIds.size()));
+            RPS_CHECK_ALLOC(m_cachedScheduleInputs.CopyFrom(scheduleInputs));
+
+            std::copy(runtimeCmds.begin(), runtimeCmds.end(), m_cachedRuntimeCmds.begin());
+            std::copy(cmdBatches.begin(), cmdBatches.end(), m_cachedCmdBatches.begin());
+            std::copy(cmdBatchWaitFenceIds.begin(), cmdBatchWaitFenceIds.end(), m_cachedCmdBatchWaitFenceIds.begin());
+
+            m_bScheduleCacheValid = true;
+
+            return RPS_OK;
+        }
+
+        RpsResult RestoreCachedSchedule()
+        {
+            auto& runtimeCmds          = m_renderGraph.GetRuntimeCmdInfos();
+            auto& cmdBatches           = m_renderGraph.GetCmdBatches();
+            auto& cmdBatchWaitFenceIds = m_renderGraph.GetCmdBatchWaitFenceIds();
+
+            RPS_CHECK_ALLOC(runtimeCmds.resize(m_cachedRuntimeCmds.size()));
+            RPS_CHECK_ALLOC(cmdBatches.resize(m_cachedCmdBatches.size()));
+            RPS_CHECK_ALLOC(cmdBatchWaitFenceIds.resize(m_cachedCmdBatchWaitFenceIds.size()));
+
+            std::copy(m_cachedRuntimeCmds.begin(), m_cachedRuntimeCmds.end(), runtimeCmds.begin());
+            std::copy(m_cachedCmdBatches.begin(), m_cachedCmdBatches.end(), cmdBatches.begin());
+            std::copy(
+                m_cachedCmdBatchWaitFenceIds.begin(), m_cachedCmdBatchWaitFenceIds.end(), cmdBatchWaitFenceIds.begin());
+
+            return RPS_OK;
+        }
+
+    private:
+        RenderGraph&  m_renderGraph;
+        TargetInfo    m_targetInfo;
+
+        Graph&                          graph;
+        ConstArrayRef<Node>             nodes;
+        ConstArrayRef<Subgraph>         subgraphs;
+        ConstArrayRef<ResourceInstance> resources;
+        ConstArrayRef<CmdInfo>          cmdInfos;
+
+        ArrayRef<NodeId, uint32_t>                 scheduledNodes;
+        ArrayRef<ReadyNodeInfo, uint32_t>          readyNodes;
+        ArrayRef<NodeSchedulingInfo, uint32_t>     nodeSchInfos;
+        ArrayRef<ResourceSchedulingInfo, uint32_t> resourceSchInfos;
+        ArrayRef<SubgraphSchedulingInfo, uint32_t> subgraphSchInfos;
+        ArrayRef<uint32_t, uint32_t>               nodeReadyDeps;
+        ArrayRef<uint32_t, uint32_t>               nodeAtomicSubgraphIndices;
+        ArenaVector<uint32_t>                      nodeResourceRefs;
+
+        uint64_t   maxNodeMemorySize = 0;
+
+        // Time estimation
+        ArrayRef<float, uint32_t>    nodeTimeCosts;
+        ArrayRef<float, uint32_t>    nodeReadyTimes;
+        ArrayRef<uint32_t, uint32_t> nodeCriticalPathScores;
+        bool                         useCostModel = false;
+
+        // Ready node queue
+        ArrayRef<ReadyNodeState, uint32_t>     readyNodeStates;
+        ArrayRef<ReadyNodeHeapLinks, uint32_t> scoreHeapLinks;
+        ArrayRef<ReadyNodeHeapLinks, uint32_t> readyIndexHeapLinks;
+        ArrayRef<uint32_t, uint32_t>           resourceUserOffsets;
+        ArrayRef<uint32_t, uint32_t>           resourceUserNodes;
+        ArenaVector<ReadyNodeBucket>           readyNodeBuckets;
+        ArenaVector<uint32_t>                  activeReadyNodeBuckets;
+        ArenaVector<uint32_t>                  freeReadyNodeBuckets;
+        ArrayRef<uint32_t, uint32_t>           readyNodeBucketHashSlots;  // First bucket with a key hashing to it.
+        uint32_t                               eliminableNodesHeapRoot = RPS_INDEX_NONE_U32;
+        bool                                   useReadyNodeQueue       = false;
+
+        uint32_t barrierBatchingBit    = BarrierScoreHighBit;
+        uint32_t memoryAllocScoreShift = MemoryScoreShift;
+        uint32_t contextScoreBits      = 0;
+        bool     hasAnyAtomicSubgraphs = false;
+
+        // Schedule of the last update, replayed with RPS_SCHEDULE_AVOID_RESCHEDULE_BIT.
+        Arena                        m_scheduleCacheArena;
+        ArenaVector<RuntimeCmdInfo>  m_cachedRuntimeCmds;
+        ArenaVector<RpsCommandBatch> m_cachedCmdBatches;
+        ArenaVector<uint32_t>        m_cachedCmdBatchWaitFenceIds;
+        CacheInputs                  m_cachedScheduleInputs;
+        bool                         m_bScheduleCacheValid = false;
     };
 }  // namespace rps
 
@@ -17,6 +17,11 @@ namespace rps
     class LifetimeAnalysisPhase : public IRenderGraphPhase
     {
     public:
+        virtual bool IsStructuralPhase() const override final
+        {
+            return true;
+        }
+
         virtual RpsResult Run(RenderGraphUpdateContext& context) override final
         {
             RPS_RETURN_OK_IF(context.renderGraph.GetCreateInfo().renderGraphFlags &
@@ -30,7 +35,7 @@ namespace rps
 
             ArenaCheckPoint arenaCheckpoint{context.scratchArena};
 
-            ArenaVector<uint32_t> resourceInstanceSubResOffset{resourceInstances.size(), &context.scratchArena};
+            ArenaVector<uint32_t> resourceInstanceSubResOffset{resourceInstances.size() + 1, &context.scratchArena};
 
             const uint32_t lastCmdId = runtimeCmds.empty() ? 0 : uint32_t(runtimeCmds.size() - 1);
 
@@ -49,6 +54,33 @@ namespace rps
                 totalSubResCount += resInst.numSubResources;
             }
 
+            resourceInstanceSubResOffset[resourceInstances.size()] = totalSubResCount;
+
+            // Sub-resource lifetimes only feed the diagnostic info and the memory budget report, so they are only
+            // collected when requested. They are laid out the same way as the sub-resource states.
+            const bool bSubResourceLifetimes = rpsAnyBitsSet(context.renderGraph.GetCreateInfo().renderGraphFlags,
+                                                             RPS_RENDER_GRAPH_SUBRESOURCE_LIFETIMES);
+
+            auto& subResLifetimes = context.renderGraph.GetSubResourceLifetimes();
+
+            if (bSubResourceLifetimes)
+            {
+                RPS_CHECK_ALLOC(subResLifetimes.resize(totalSubResCount));
+
+                for (size_t iRes = 0; iRes < resourceInstances.size(); iRes++)
+                {
+                    auto& resInst = resourceInstances[iRes];
+
+                    resInst.subResourceLifetimes =
+                        Span<RpsSubresourceLifetime>(resourceInstanceSubResOffset[iRes], resInst.numSubResources);
+
+                    auto lifetimes = resInst.subResourceLifetimes.Get(subResLifetimes);
+                    std::fill(lifetimes.begin(),
+                              lifetimes.end(),
+                              RpsSubresourceLifetime{resInst.lifetimeBegin, resInst.lifetimeEnd});
+                }
+            }
+
             if (runtimeCmds.empty())
             {
                 return RPS_OK;
@@ -59,87 +91,142 @@ namespace rps
 
             ArrayRef<SubResState> subResStates = context.scratchArena.NewArrayZeroed<SubResState>(totalSubResCount);
 
-            auto fnUpdateAccessRange = [&](uint32_t resourceIndex, uint32_t runtimeCmdIdx) {
-                auto& resInst         = resourceInstances[resourceIndex];
-                resInst.lifetimeBegin = rpsMin(resInst.lifetimeBegin, runtimeCmdIdx);
-                resInst.lifetimeEnd   = rpsMax(resInst.lifetimeEnd, runtimeCmdIdx);
-            };
+            // Bucket the accesses by resource once, in command order, so the analysis of a resource only visits its
+            // own accesses.
+            ArrayRef<uint32_t> resourceAccessOffsets =
+                context.scratchArena.NewArrayZeroed<uint32_t>(resourceInstances.size() + 1);
 
-            auto fnMarkPersistentSubres = [&]() {
-                for (uint32_t iRes = 0; iRes < resourceInstances.size(); iRes++)
+            auto fnForEachAccess = [&](auto&& fnVisit) {
+                for (uint32_t runtimeCmdIdx = 1; runtimeCmdIdx < (runtimeCmds.size() - 1); runtimeCmdIdx++)
                 {
-                    const auto& resInfo = resourceInstances[iRes];
-
-                    if (resInfo.IsPersistent())
+                    const auto& runtimeCmd = runtimeCmds[runtimeCmdIdx];
+                    if (runtimeCmd.isTransition)
                     {
-                        const uint32_t subResOffset = resourceInstanceSubResOffset[iRes];
-                        std::for_each(subResStates.begin() + subResOffset,
-                                      subResStates.begin() + subResOffset + resourceInstances[iRes].numSubResources,
-                                      [](SubResState& state) { state.Access(true, 0); });
+                        const auto& transitionInfo = transitions[runtimeCmd.GetTransitionId()];
+                        fnVisit(transitionInfo.access.resourceId, runtimeCmdIdx, RPS_INDEX_NONE_U32);
+                    }
+                    else
+                    {
+                        const auto accesses = context.renderGraph.GetCmdInfo(runtimeCmd.GetCmdId())->accesses;
+
+                        for (uint32_t iAccess = accesses.GetBegin(); iAccess < accesses.GetEnd(); iAccess++)
+                        {
+                            if (cmdInfos[iAccess].resourceId != RPS_RESOURCE_ID_INVALID)
+                            {
+                                fnVisit(cmdInfos[iAccess].resourceId, runtimeCmdIdx, iAccess);
+                            }
+                        }
                     }
                 }
             };
 
-            fnMarkPersistentSubres();
+            fnForEachAccess([&](uint32_t resourceIndex, uint32_t, uint32_t) {
+                resourceAccessOffsets[resourceIndex + 1]++;
+            });
 
-            // Forward pass:
-            for (uint32_t runtimeCmdIdx = 1; runtimeCmdIdx < (runtimeCmds.size() - 1); runtimeCmdIdx++)
+            for (size_t iRes = 0; iRes < resourceInstances.size(); iRes++)
             {
-                const auto& runtimeCmd = runtimeCmds[runtimeCmdIdx];
-                if (runtimeCmd.isTransition)
-                {
-                    const auto& transitionInfo = transitions[runtimeCmd.GetTransitionId()];
-                    fnUpdateAccessRange(transitionInfo.access.resourceId, runtimeCmdIdx);
-                }
-                else
+                resourceAccessOffsets[iRes + 1] += resourceAccessOffsets[iRes];
+            }
+
+            ArrayRef<ResourceAccessRef> resourceAccesses =
+                context.scratchArena.NewArray<ResourceAccessRef>(resourceAccessOffsets[resourceInstances.size()]);
+
+            {
+                ArrayRef<uint32_t> resourceAccessCursors =
+                    context.scratchArena.NewArray<uint32_t>(resourceInstances.size());
+                std::copy(
+                    resourceAccessOffsets.begin(), resourceAccessOffsets.end() - 1, resourceAccessCursors.begin());
+
+                fnForEachAccess([&](uint32_t resourceIndex, uint32_t runtimeCmdIdx, uint32_t accessIndex) {
+                    resourceAccesses[resourceAccessCursors[resourceIndex]++] = {runtimeCmdIdx, accessIndex};
+                });
+            }
+
+            // Sub-resource states and the lifetime of a resource only depend on the accesses to the resource itself,
+            // so resources are split into ranges analyzed independently (and in parallel if a task system is set).
+            auto fnAnalyzeResourceRange = [&](uint32_t resBegin, uint32_t resEnd) {
+                for (uint32_t iRes = resBegin; iRes < resEnd; iRes++)
                 {
-                    auto accessInfos = context.renderGraph.GetCmdInfo(runtimeCmd.GetCmdId())->accesses.Get(cmdInfos);
+                    auto& resInst = resourceInstances[iRes];
+
+                    const auto accessRefs = resourceAccesses.range(
+                        resourceAccessOffsets[iRes], resourceAccessOffsets[iRes + 1] - resourceAccessOffsets[iRes]);
+
+                    auto resSubResStates =
+                        subResStates.range(resourceInstanceSubResOffset[iRes], resInst.numSubResources);
+
+                    auto fnMarkPersistentSubres = [&]() {
+                        if (resInst.IsPersistent())
+                        {
+                            std::for_each(resSubResStates.begin(), resSubResStates.end(), [](SubResState& state) {
+                                state.Access(true, 0);
+                            });
+                        }
+                    };
+
+                    auto fnUpdateAccessRange = [&](const SubresourceRangePacked& range, uint32_t runtimeCmdIdx) {
+                        resInst.lifetimeBegin = rpsMin(resInst.lifetimeBegin, runtimeCmdIdx);
+                        resInst.lifetimeEnd   = rpsMax(resInst.lifetimeEnd, runtimeCmdIdx);
 
-                    for (auto& accessInfo : accessInfos)
+                        if (bSubResourceLifetimes)
+                        {
+                            UpdateSubResourceLifetimes(
+                                resInst, range, runtimeCmdIdx, resInst.subResourceLifetimes.Get(subResLifetimes));
+                        }
+                    };
+
+                    fnMarkPersistentSubres();
+
+                    // Forward pass:
+                    for (const ResourceAccessRef& accessRef : accessRefs)
                     {
-                        if (accessInfo.resourceId != RPS_RESOURCE_ID_INVALID)
+                        if (accessRef.accessIndex == RPS_INDEX_NONE_U32)
+                        {
+                            const auto& runtimeCmd     = runtimeCmds[accessRef.runtimeCmdIdx];
+                            const auto& transitionInfo = transitions[runtimeCmd.GetTransitionId()];
+
+                            fnUpdateAccessRange(transitionInfo.access.range, accessRef.runtimeCmdIdx);
+                        }
+                        else
                         {
-                            fnUpdateAccessRange(accessInfo.resourceId, runtimeCmdIdx);
+                            auto& accessInfo = cmdInfos[accessRef.accessIndex];
+
+                            fnUpdateAccessRange(accessInfo.range, accessRef.runtimeCmdIdx);
 
                             CheckAndUpdateSubresourceActiveMasks<ForwardPass>(pRuntimeDevice,
-                                                                              runtimeCmdIdx,
+                                                                              accessRef.runtimeCmdIdx,
                                                                               accessInfo,
-                                                                              resourceInstances[accessInfo.resourceId],
+                                                                              resInst,
                                                                               resourceInstanceSubResOffset.crange_all(),
                                                                               subResStates);
                         }
                     }
-                }
-            }
 
-            // Reverse pass:
-            std::fill(subResStates.begin(), subResStates.end(), SubResState{});
+                    // Reverse pass. The order of accesses within a command doesn't matter, see SubResState::Access.
+                    std::fill(resSubResStates.begin(), resSubResStates.end(), SubResState{});
 
-            fnMarkPersistentSubres();
-
-            for (uint32_t runtimeCmdIdx = uint32_t(runtimeCmds.size() - 2); runtimeCmdIdx > 0; runtimeCmdIdx--)
-            {
-                const auto& runtimeCmd = runtimeCmds[runtimeCmdIdx];
-                if (!runtimeCmd.isTransition)
-                {
-                    auto accessInfos = context.renderGraph.GetCmdInfo(runtimeCmd.GetCmdId())->accesses.Get(cmdInfos);
+                    fnMarkPersistentSubres();
 
-                    for (auto& accessInfo : accessInfos)
+                    for (auto iter = accessRefs.rbegin(); iter != accessRefs.rend(); ++iter)
                     {
-                        if (accessInfo.resourceId != RPS_RESOURCE_ID_INVALID)
+                        if (iter->accessIndex != RPS_INDEX_NONE_U32)
                         {
                             CheckAndUpdateSubresourceActiveMasks<ReversePass>(pRuntimeDevice,
-                                                                              runtimeCmdIdx,
-                                                                              accessInfo,
-                                                                              resourceInstances[accessInfo.resourceId],
+                                                                              iter->runtimeCmdIdx,
+                                                                              cmdInfos[iter->accessIndex],
+                                                                              resInst,
                                                                               resourceInstanceSubResOffset.crange_all(),
                                                                               subResStates);
                         }
                     }
                 }
-            }
 
-            return RPS_OK;
+                return RPS_OK;
+            };
+
+            return context.renderGraph.ParallelFor(
+                uint32_t(resourceInstances.size()), MinResourcesPerTask, fnAnalyzeResourceRange);
         }
 
     private:
@@ -174,6 +261,60 @@ namespace rps
             }
         };
 
+        // Accesses of a resource in command order, as an index into the command accesses or RPS_INDEX_NONE_U32 for
+        // the transition at runtimeCmdIdx.
+        struct ResourceAccessRef
+        {
+            uint32_t runtimeCmdIdx;
+            uint32_t accessIndex;
+        };
+
+        static constexpr uint32_t MinResourcesPerTask = 16;
+
+        static void UpdateSubResourceLifetimes(const ResourceInstance&          resInfo,
+                                               const SubresourceRangePacked&    range,
+                                               uint32_t                         currCmdIdx,
+                                               ArrayRef<RpsSubresourceLifetime> lifetimes)
+        {
+            auto fnUpdateLifetime = [currCmdIdx](RpsSubresourceLifetime& lifetime) {
+                lifetime.lifetimeBegin = rpsMin(lifetime.lifetimeBegin, currCmdIdx);
+                lifetime.lifetimeEnd   = rpsMax(lifetime.lifetimeEnd, currCmdIdx);
+            };
+
+            if (resInfo.numSubResources == 1)
+            {
+                fnUpdateLifetime(lifetimes[0]);
+                return;
+            }
+
+            RPS_ASSERT(resInfo.desc.IsImage());
+
+            const uint32_t resMipLevels    = resInfo.fullSubresourceRange.GetMipLevelCount();
+            const uint32_t subResPerAspect = resInfo.fullSubresourceRange.GetArrayLayerCount() * resMipLevels;
+            const uint32_t rangeMipLevels  = range.GetMipLevelCount();
+
+            uint32_t aspectSubResOffset = 0;
+
+            for (uint32_t aspectMask = resInfo.fullSubresourceRange.aspectMask; aspectMask != 0;
+                 aspectMask &= (aspectMask - 1))
+            {
+                const uint32_t currAspectBit = aspectMask & (~aspectMask + 1);
+
+                if (range.aspectMask & currAspectBit)
+                {
+                    for (uint32_t iArray = range.baseArrayLayer; iArray < range.arrayLayerEnd; iArray++)
+                    {
+                        auto mipLifetimes =
+                            lifetimes.range(aspectSubResOffset + iArray * resMipLevels + range.baseMipLevel,
+                                            rangeMipLevels);
+                        std::for_each(mipLifetimes.begin(), mipLifetimes.end(), fnUpdateLifetime);
+                    }
+                }
+
+                aspectSubResOffset += subResPerAspect;
+            }
+        }
+
         static constexpr bool ReversePass = true;
         static constexpr bool ForwardPass = false;
 
@@ -8,7 +8,14 @@
 #ifndef RPS_MEMORY_SCHEDULE_HPP
 #define RPS_MEMORY_SCHEDULE_HPP
 
+#include "runtime/common/rps_heap_allocation_index.hpp"
+#include "runtime/common/rps_heap_compaction.hpp"
+#include "runtime/common/rps_heap_range_sweep.hpp"
+#include "runtime/common/rps_memory_budget.hpp"
+#include "runtime/common/rps_memory_placement_cache.hpp"
+#include "runtime/common/rps_memory_placement_trials.hpp"
 #include "runtime/common/rps_render_graph.hpp"
+#include "runtime/common/rps_small_resource_pool.hpp"
 
 #include <algorithm>
 #include <numeric>
@@ -17,34 +24,141 @@ namespace rps
 {
     class MemorySchedulePhase : public IRenderGraphPhase
     {
-        RenderGraphUpdateContext* m_pContext = nullptr;
+        RenderGraphUpdateContext*  m_pContext            = nullptr;
+        RpsMemoryPlacementStrategy m_placementStrategy   = RPS_MEMORY_PLACEMENT_DEFAULT;
+        bool                       m_bSmallResourcePages = false;
+
+        // Fit used by CalculateResourcePlacement per memory type, valid during CalculateResourcePlacements.
+        MemoryTypeFitStrategies m_memTypeFitStrategies;
+
+        MemoryPlacementCache m_placementCache;
+        HeapCompaction       m_heapCompaction;
+
+        // Memory feedback of the schedules computed in the current update, see
+        // RpsRenderGraphCreateInfo::scheduleInfo.numMemoryFeedbackIterations.
+        static constexpr uint32_t MAX_MEMORY_FEEDBACK_WEIGHT = 64;
+
+        ArrayRef<uint32_t> m_bestMemoryFeedbackWeights;
+        uint64_t           m_bestMemoryFeedbackHeapSize  = UINT64_MAX;
+        uint32_t           m_bestMemoryFeedbackLevel     = 0;
+        uint32_t           m_memoryFeedbackBaseIteration = 0;
+        bool               m_bMemoryFeedbackFinalPass    = false;
 
     public:
         MemorySchedulePhase(RenderGraph& renderGraph)
+            : m_placementCache(renderGraph.GetDevice().Allocator())
+            , m_heapCompaction(renderGraph.GetDevice().Allocator())
+        {
+        }
+
+        // Compaction moves resources and releases heaps over several updates, so the phase has to keep running while
+        // it is in progress.
+        virtual bool IsStructuralPhase() const override final
         {
+            return !m_heapCompaction.IsCompacting();
         }
 
         virtual RpsResult Run(RenderGraphUpdateContext& context) override final
         {
-            m_pContext = &context;
+            m_pContext            = &context;
+            m_placementStrategy   = context.renderGraph.GetCreateInfo().memoryInfo.placementStrategy;
+            m_bSmallResourcePages = rpsAnyBitsSet(context.renderGraph.GetCreateInfo().renderGraphFlags,
+                                                  RPS_RENDER_GRAPH_SMALL_RESOURCE_PAGES);
+
+            const bool bUseAliasing = context.renderGraph.IsMemoryAliasingEnabled(*context.pUpdateInfo);
 
-            const bool bUseAliasing = !rpsAnyBitsSet(context.renderGraph.GetCreateInfo().renderGraphFlags,
-                                                     RPS_RENDER_GRAPH_NO_GPU_MEMORY_ALIASING);
+            // Aliasing is decided per update, but lifetimes are only known if the render graph analyzes them.
+            RPS_RETURN_ERROR_IF(bUseAliasing && rpsAnyBitsSet(context.renderGraph.GetCreateInfo().renderGraphFlags,
+                                                              RPS_RENDER_GRAPH_NO_LIFETIME_ANALYSIS),
+                                RPS_ERROR_INVALID_OPERATION);
+
+            const bool bCompactHeaps =
+                rpsAnyBitsSet(context.renderGraph.GetCreateInfo().renderGraphFlags, RPS_RENDER_GRAPH_COMPACT_HEAPS);
 
             // TODO: Make sure LifetimeAnalysis phase has run before current phase.
 
-            RPS_V_RETURN(CalculateResourcePlacements(context));
+            ArenaCheckPoint arenaCheckpoint{context.scratchArena};
 
-            // TODO: when implementing RPS_RENDER_GRAPH_NO_GPU_MEMORY_ALIASING as a dynamic flag
-            // we need to remove the IF below and call CalculateResourceAliasing each frame to ensure
-            // isAliased is always properly set for every resource instance.
-            if (bUseAliasing)
+            if (bCompactHeaps)
             {
-                RPS_V_RETURN(CalculateResourceAliasing(context));
+                RPS_V_RETURN(m_heapCompaction.UpdateHeapCompaction(context));
+            }
+
+            // Placement and aliasing only depend on the inputs gathered below. If they match the last update, the
+            // placements and isAliased flags stored in the resource instances are still valid.
+            CacheInputs placementInputs(&context.scratchArena);
+            MemoryPlacementCache::GatherInputs(placementInputs, context);
+            RPS_CHECK_ALLOC(placementInputs.IsValid());
+
+            if (m_placementCache.IsHit(placementInputs) && !m_heapCompaction.IsCompacting())
+            {
+                RPS_V_RETURN(m_placementCache.RestoreAliasingInfos(context));
             }
             else
             {
-                context.renderGraph.GetResourceAliasingInfos().clear();
+                m_placementCache.Invalidate();
+
+                m_heapCompaction.SetCompactedHeapUsages(
+                    bCompactHeaps
+                        ? context.scratchArena.NewArrayZeroed<uint64_t>(context.renderGraph.GetMemoryTypes().size())
+                        : ArrayRef<uint64_t>{});
+
+                // Keep the heaps as they were before placement, so a placement exceeding the budget or to be
+                // redone with memory feedback can be undone.
+                const bool bHasBudgets = (context.renderGraph.GetCreateInfo().memoryInfo.numHeaps > 0);
+
+                const bool bMemoryFeedback =
+                    (context.renderGraph.GetCreateInfo().scheduleInfo.numMemoryFeedbackIterations > 0) &&
+                    (context.numSchedulesComputed > 0);
+
+                ArrayRef<HeapInfo> heapsBeforePlacement;
+
+                if (bHasBudgets || bMemoryFeedback)
+                {
+                    const auto& heaps    = context.renderGraph.GetHeapInfos();
+                    heapsBeforePlacement = context.scratchArena.NewArray<HeapInfo>(heaps.size());
+                    RPS_CHECK_ALLOC(heaps.empty() || !heapsBeforePlacement.empty());
+                    std::copy(heaps.begin(), heaps.end(), heapsBeforePlacement.begin());
+                }
+
+                RPS_V_RETURN(CalculateResourcePlacements(context));
+
+                if (bHasBudgets)
+                {
+                    uint64_t       requiredSize      = 0;
+                    const uint32_t overBudgetMemType = FindMemoryTypeOverBudget(context, requiredSize);
+
+                    if (overBudgetMemType != RPS_INDEX_NONE_U32)
+                    {
+                        return OnMemoryBudgetExceeded(context, overBudgetMemType, requiredSize, heapsBeforePlacement);
+                    }
+                }
+
+                if (bMemoryFeedback)
+                {
+                    RPS_V_RETURN(UpdateMemoryFeedback(context));
+
+                    if (context.bRescheduleForMemoryFeedback)
+                    {
+                        return RestoreHeapsBeforePlacement(context, heapsBeforePlacement);
+                    }
+                }
+
+                if (bCompactHeaps)
+                {
+                    RPS_V_RETURN(m_heapCompaction.CheckHeapFragmentation(context));
+                }
+
+                if (bUseAliasing)
+                {
+                    RPS_V_RETURN(CalculateResourceAliasing(context));
+                }
+                else
+                {
+                    ClearResourceAliasing(context);
+                }
+
+                RPS_V_RETURN(m_placementCache.Store(context, placementInputs));
             }
 
             return RPS_OK;
@@ -52,89 +166,196 @@ namespace rps
 
     private:
 
-        struct AllocationIndexLessComparer
+        // Undoes the placement, then either requests the update to be scheduled again preferring memory saving, or
+        // reports the resources making up the peak usage if the schedule already prefers memory saving.
+        RpsResult OnMemoryBudgetExceeded(RenderGraphUpdateContext& context,
+                                         uint32_t                  memTypeIndex,
+                                         uint64_t                  requiredSize,
+                                         ConstArrayRef<HeapInfo>   heapsBeforePlacement)
         {
-            ConstArrayRef<ResourceInstance> resources;
+            RPS_V_RETURN(RestoreHeapsBeforePlacement(context, heapsBeforePlacement));
 
-            struct AllocInfo
-            {
-                RpsHeapPlacement        allocPlacement;
-                RpsGpuMemoryRequirement allocRequirement;
-            };
+            const RpsRenderGraphCreateInfo& createInfo = context.renderGraph.GetCreateInfo();
+
+            const RpsScheduleFlags scheduleFlags = (context.pUpdateInfo->scheduleFlags != RPS_SCHEDULE_UNSPECIFIED)
+                                                       ? context.pUpdateInfo->scheduleFlags
+                                                       : createInfo.scheduleInfo.scheduleFlags;
 
-            template <typename TAllocInfo>
-            bool operator()(const TAllocInfo& a, uint32_t idxB) const
+            if (!rpsAnyBitsSet(scheduleFlags, RPS_SCHEDULE_PREFER_MEMORY_SAVING_BIT))
             {
-                const auto& resB = resources[idxB];
+                context.bRescheduleForMemorySaving = true;
+                return RPS_OK;
+            }
 
-                if (a.allocPlacement.heapId < resB.allocPlacement.heapId)
-                    return true;
-                else if (a.allocPlacement.heapId > resB.allocPlacement.heapId)
-                    return false;
-                else if (a.allocPlacement.offset < resB.allocPlacement.offset)
-                    return true;
-                else if (a.allocPlacement.offset > resB.allocPlacement.offset)
-                    return false;
-                else if (a.allocRequirement.size < resB.allocRequirement.size)
-                    return true;
+            PrintMemoryBudgetReport(context, memTypeIndex, requiredSize);
 
-                return false;
-            }
+            return RPS_ERROR_OUT_OF_MEMORY;
+        }
 
-            bool operator()(uint32_t idxA, uint32_t idxB) const
+        RpsResult RestoreHeapsBeforePlacement(RenderGraphUpdateContext& context,
+                                              ConstArrayRef<HeapInfo>   heapsBeforePlacement)
+        {
+            auto& heaps = context.renderGraph.GetHeapInfos();
+
+            // Heaps are only appended or reused in place during placement, none are created yet.
+            RPS_CHECK_ALLOC(heaps.resize(heapsBeforePlacement.size()));
+            std::copy(heapsBeforePlacement.begin(), heapsBeforePlacement.end(), heaps.begin());
+
+            for (auto& resInst : context.renderGraph.GetResourceInstances())
             {
-                auto& resA = resources[idxA];
-                return (*this)(resA, idxB);
+                if (resInst.isPendingCreate)
+                {
+                    resInst.allocPlacement = {RPS_INDEX_NONE_U32, 0};
+                }
             }
-        };
 
-        bool InsertPreAllocatedResourceToSortedAllocationList(const HeapInfo&                 currHeap,
-                                                              ArenaVector<uint32_t>&          allocatedIndices,
-                                                              uint32_t                        resIndex,
-                                                              ConstArrayRef<ResourceInstance> resources)
+            return RPS_OK;
+        }
+
+        // Compares the heaps of the current schedule with the best schedule of this update. While the heaps do not
+        // grow, raises the feedback level and the weights of the resources live at the memory peak and requests
+        // another schedule. Once they grow or the iterations are used up, requests the best schedule once more
+        // unless it is the current one.
+        RpsResult UpdateMemoryFeedback(RenderGraphUpdateContext& context)
         {
-            const auto& currRes = resources[resIndex];
+            RenderGraph& renderGraph       = context.renderGraph;
+            auto         resourceInstances = renderGraph.GetResourceInstances().range_all();
 
-            auto& context = *m_pContext;
+            const uint32_t maxIterations = renderGraph.GetCreateInfo().scheduleInfo.numMemoryFeedbackIterations;
+            const uint32_t iteration     = context.memoryFeedbackIteration;
 
-            const bool bUseAliasing = !rpsAnyBitsSet(context.renderGraph.GetCreateInfo().renderGraphFlags,
-                                                     RPS_RENDER_GRAPH_NO_GPU_MEMORY_ALIASING);
+            if (iteration == 0)
+            {
+                m_bestMemoryFeedbackWeights = context.frameArena.NewArray<uint32_t>(resourceInstances.size());
+                RPS_CHECK_ALLOC(resourceInstances.empty() || !m_bestMemoryFeedbackWeights.empty());
+
+                m_bestMemoryFeedbackHeapSize  = UINT64_MAX;
+                m_bestMemoryFeedbackLevel     = 0;
+                m_memoryFeedbackBaseIteration = 0;
+                m_bMemoryFeedbackFinalPass    = false;
+
+                // The feedback of a previous update is kept for its schedule to be replayed. A changed graph starts
+                // over, so the result does not depend on the graphs scheduled before.
+                const bool bHasPrevFeedback =
+                    (renderGraph.GetMemoryFeedbackLevel() != 0) ||
+                    std::any_of(resourceInstances.begin(), resourceInstances.end(), [](const auto& resInst) {
+                        return resInst.memoryFeedbackWeight != 1;
+                    });
+
+                if (bHasPrevFeedback)
+                {
+                    renderGraph.SetMemoryFeedbackLevel(0);
 
-            RPS_ASSERT(!resources[resIndex].isPendingCreate);
-            RPS_ASSERT(currHeap.memTypeIndex == currRes.allocRequirement.memoryTypeIndex);
-            RPS_ASSERT(currHeap.alignment >= currRes.allocRequirement.alignment);
-            RPS_ASSERT(currHeap.size >= (currRes.allocPlacement.offset + currRes.allocRequirement.size));
+                    for (auto& resInst : resourceInstances)
+                    {
+                        resInst.memoryFeedbackWeight = 1;
+                    }
+
+                    m_memoryFeedbackBaseIteration        = 1;
+                    context.bRescheduleForMemoryFeedback = true;
 
-            if (currHeap.usedSize <= currRes.allocPlacement.offset)
+                    return RPS_OK;
+                }
+            }
+            else if (m_bMemoryFeedbackFinalPass)
             {
-                // Current resource offset is higher than occupied range in the heap,
-                // no need to check overlap against existing allocations.
-                InsertToSortedAllocationList(allocatedIndices, resIndex, resources);
+                return RPS_OK;
+            }
+
+            RPS_RETURN_ERROR_IF(m_bestMemoryFeedbackWeights.size() != resourceInstances.size(),
+                                RPS_ERROR_INTERNAL_ERROR);
 
-                return true;
+            uint64_t heapSize = 0;
+
+            for (const auto& heap : renderGraph.GetHeapInfos())
+            {
+                heapSize += (heap.memTypeIndex != RPS_INDEX_NONE_U32) ? GetHeapFootprint(heap) : 0;
             }
 
-            const uint64_t currResPlacementEnd = currRes.allocPlacement.offset + currRes.allocRequirement.size;
+            // On a tie, the earlier schedule is kept as it is closer to the requested schedule flags.
+            if (heapSize < m_bestMemoryFeedbackHeapSize)
+            {
+                m_bestMemoryFeedbackHeapSize = heapSize;
+                m_bestMemoryFeedbackLevel    = renderGraph.GetMemoryFeedbackLevel();
 
-            const AllocationIndexLessComparer comparer{resources};
+                for (uint32_t iRes = 0; iRes < resourceInstances.size(); iRes++)
+                {
+                    m_bestMemoryFeedbackWeights[iRes] = resourceInstances[iRes].memoryFeedbackWeight;
+                }
+            }
+
+            const uint32_t numFeedbackIterations = iteration - m_memoryFeedbackBaseIteration;
 
-            AllocationIndexLessComparer::AllocInfo checkRangeBegin = {{currRes.allocPlacement.heapId, 0}, {}};
-            AllocationIndexLessComparer::AllocInfo checkRangeEnd   = {
-                {currRes.allocPlacement.heapId, currResPlacementEnd}, {}};
+            if ((heapSize <= m_bestMemoryFeedbackHeapSize) && (numFeedbackIterations < maxIterations))
+            {
+                uint64_t       peakSize = 0;
+                const uint32_t peakCmd  = FindPeakMemoryUsage(context, RPS_INDEX_NONE_U32, peakSize);
 
-            auto checkRangeBeginIter =
-                std::upper_bound(allocatedIndices.begin(), allocatedIndices.end(), checkRangeBegin, comparer);
-            auto checkRangeEndIter =
-                std::upper_bound(checkRangeBeginIter, allocatedIndices.end(), checkRangeEnd, comparer);
+                const uint32_t numRuntimeCmds = uint32_t(renderGraph.GetRuntimeCmdInfos().size());
 
-            for (auto iter = checkRangeBeginIter; iter < checkRangeEndIter; ++iter)
+                for (auto& resInst : resourceInstances)
+                {
+                    if (IsPlacedResource(resInst, RPS_INDEX_NONE_U32, numRuntimeCmds) &&
+                        (resInst.lifetimeBegin <= peakCmd) && (peakCmd <= resInst.lifetimeEnd))
+                    {
+                        resInst.memoryFeedbackWeight =
+                            rpsMin(resInst.memoryFeedbackWeight * 2, MAX_MEMORY_FEEDBACK_WEIGHT);
+                    }
+                }
+
+                renderGraph.SetMemoryFeedbackLevel(renderGraph.GetMemoryFeedbackLevel() + 1);
+
+                context.bRescheduleForMemoryFeedback = true;
+            }
+            else
             {
-                const auto&    allocatedRes = resources[*iter];
-                const uint64_t allocatedResPlacementEnd =
-                    (allocatedRes.allocPlacement.offset + allocatedRes.allocRequirement.size);
+                m_bMemoryFeedbackFinalPass = true;
+
+                if (renderGraph.GetMemoryFeedbackLevel() != m_bestMemoryFeedbackLevel)
+                {
+                    renderGraph.SetMemoryFeedbackLevel(m_bestMemoryFeedbackLevel);
 
-                RPS_ASSERT(allocatedRes.allocPlacement.heapId == currRes.allocPlacement.heapId);
-                RPS_ASSERT(allocatedRes.allocPlacement.offset < currResPlacementEnd);
+                    for (uint32_t iRes = 0; iRes < resourceInstances.size(); iRes++)
+                    {
+                        resourceInstances[iRes].memoryFeedbackWeight = m_bestMemoryFeedbackWeights[iRes];
+                    }
+
+                    context.bRescheduleForMemoryFeedback = true;
+                }
+            }
+
+            return RPS_OK;
+        }
+
+        bool InsertPreAllocatedResource(const HeapInfo&                 currHeap,
+                                        HeapAllocationIndex&            allocations,
+                                        uint32_t                        resIndex,
+                                        ConstArrayRef<ResourceInstance> resources)
+        {
+            const auto& currRes = resources[resIndex];
+
+            RPS_ASSERT(!resources[resIndex].isPendingCreate);
+            RPS_ASSERT(currHeap.memTypeIndex == currRes.allocRequirement.memoryTypeIndex);
+            RPS_ASSERT(currHeap.alignment >= currRes.allocRequirement.alignment);
+            RPS_ASSERT(currHeap.size >= (currRes.allocPlacement.offset + currRes.allocRequirement.size));
+
+            return InsertPreAllocatedRange(
+                currHeap, allocations, HeapAllocationIndex::Allocation::FromResource(currRes));
+        }
+
+        bool InsertPreAllocatedRange(const HeapInfo&                        currHeap,
+                                     HeapAllocationIndex&                   allocations,
+                                     const HeapAllocationIndex::Allocation& range)
+        {
+            auto& context = *m_pContext;
+
+            const bool bUseAliasing = context.renderGraph.IsMemoryAliasingEnabled(*context.pUpdateInfo);
+
+            // If current range offset is higher than occupied range in the heap,
+            // no need to check overlap against existing allocations.
+            if (currHeap.usedSize > range.offset)
+            {
+                const uint64_t rangeEnd = range.offset + range.size;
 
                 // it is strictly not allowed for any two resources to ever overlap both in lifetime and heap
                 // placement.
@@ -142,33 +363,70 @@ namespace rps
                 // dynamic render graphs can cause 2d rect overlapping. overlap can occur when:
                 // - runtime cmd lifetimes change from previous graph.
                 // - a resource becomes temporarily unused (still declared) and a new allocation in the interim overlaps prev heap region.
-                const bool bLifetimesOverlap = bUseAliasing ? ((allocatedRes.lifetimeBegin <= currRes.lifetimeEnd) &&
-                                                               (currRes.lifetimeBegin <= allocatedRes.lifetimeEnd))
-                                                            : true;
-                if ((currRes.allocPlacement.offset < allocatedResPlacementEnd) && bLifetimesOverlap)
+                //
+                // Without aliasing, every allocation in the heap is treated as overlapping in lifetime.
+                const auto overlaps = allocations.QueryOverlaps(currHeap.index,
+                                                                bUseAliasing ? range.lifetimeBegin : 0,
+                                                                bUseAliasing ? range.lifetimeEnd : UINT32_MAX);
+
+                for (const auto& allocated : overlaps)
                 {
-                    return false;
+                    if ((range.offset < (allocated.offset + allocated.size)) && (allocated.offset < rangeEnd))
+                    {
+                        return false;
+                    }
                 }
             }
 
-            auto insertAt = std::upper_bound(checkRangeBeginIter, checkRangeEndIter, resIndex, comparer);
+            return allocations.Insert(currHeap.index, range);
+        }
 
-            RPS_ASSERT((insertAt == allocatedIndices.begin()) || !comparer(resIndex, *(insertAt - 1)));
-            RPS_ASSERT((insertAt == allocatedIndices.end()) || comparer(resIndex, *insertAt));
+        // Holds the page of a small resource placed by a previous update, creating the page if this is its first
+        // resident seen in the current update. Fails if either the page or the resource range is taken.
+        bool InsertPreAllocatedSmallResource(HeapInfo&            currHeap,
+                                             HeapAllocationIndex& allocations,
+                                             SmallResourcePool&   smallResPool,
+                                             uint32_t             resIndex,
+                                             bool                 bUseAliasing)
+        {
+            auto resourceInstances = m_pContext->renderGraph.GetResourceInstances().range_all();
 
-            allocatedIndices.insert(insertAt - allocatedIndices.begin(), resIndex);
+            const auto&    currRes    = resourceInstances[resIndex];
+            const uint64_t pageOffset = currRes.allocPlacement.offset & ~(SmallResourcePool::PAGE_SIZE - 1);
 
-            return true;
-        }
+            const uint64_t resEnd = currRes.allocPlacement.offset + currRes.allocRequirement.size;
 
-        void InsertToSortedAllocationList(ArenaVector<uint32_t>&          allocatedIndices,
-                                          uint32_t                        resIndex,
-                                          ConstArrayRef<ResourceInstance> resources)
-        {
-            auto upperBound = std::upper_bound(
-                allocatedIndices.begin(), allocatedIndices.end(), resIndex, AllocationIndexLessComparer{resources});
+            if (resEnd > (pageOffset + SmallResourcePool::PAGE_SIZE))
+            {
+                return false;
+            }
 
-            allocatedIndices.insert(upperBound - allocatedIndices.begin(), resIndex);
+            uint32_t pageIndex = smallResPool.FindPage(currHeap.index, pageOffset);
+
+            if (pageIndex == RPS_INDEX_NONE_U32)
+            {
+                if ((pageOffset + SmallResourcePool::PAGE_SIZE) > currHeap.size)
+                {
+                    return false;
+                }
+
+                const HeapAllocationIndex::Allocation pageRange = {
+                    pageOffset, SmallResourcePool::PAGE_SIZE, 0, UINT32_MAX};
+
+                if (!InsertPreAllocatedRange(currHeap, allocations, pageRange) ||
+                    !smallResPool.AddPage({currHeap.index, pageOffset}))
+                {
+                    return false;
+                }
+
+                currHeap.usedSize    = rpsMax(currHeap.usedSize, pageOffset + SmallResourcePool::PAGE_SIZE);
+                currHeap.maxUsedSize = rpsMax(currHeap.maxUsedSize, currHeap.usedSize);
+
+                pageIndex = smallResPool.GetNumPages() - 1;
+            }
+
+            return !smallResPool.HasResidentOverlap(pageIndex, resourceInstances, currRes, bUseAliasing) &&
+                   smallResPool.AddResident(pageIndex, resIndex);
         }
 
         RpsResult CalculateResourcePlacements(RenderGraphUpdateContext& context)
@@ -177,9 +435,9 @@ namespace rps
 
             auto& heaps = context.renderGraph.GetHeapInfos();
 
-            // TODO: to support a dynamic version of this flag, need to clear all allocPlacement for every res inst.
-            const bool bUseAliasing = !rpsAnyBitsSet(context.renderGraph.GetCreateInfo().renderGraphFlags,
-                                                     RPS_RENDER_GRAPH_NO_GPU_MEMORY_ALIASING);
+            // Placements held from an update with another aliasing mode are checked against the current one when
+            // they are inserted, so only the resources sharing memory they may no longer share are placed again.
+            const bool bUseAliasing = context.renderGraph.IsMemoryAliasingEnabled(*context.pUpdateInfo);
 
             auto resourceInstances = context.renderGraph.GetResourceInstances().range_all();
 
@@ -248,6 +506,34 @@ namespace rps
                 return (cmdIndexA < cmdIndexB);
             });
 
+            RPS_V_RETURN(m_memTypeFitStrategies.Init(
+                context.scratchArena, m_placementStrategy, uint32_t(context.renderGraph.GetMemoryTypes().size())));
+
+            // Places the resources of one memory type for a trial, which the caller undoes.
+            auto fnPlaceMemoryType = [&](uint32_t memType, ConstArrayRef<uint32_t> resIndices) {
+                size_t iIndex = 0;
+                return CalculateResourcePlacementsForMemoryType(memType, resIndices, iIndex, bUseAliasing);
+            };
+
+            if (m_heapCompaction.IsCalculatingCompactedHeapUsages())
+            {
+                RPS_V_RETURN(m_heapCompaction.CalculateCompactedHeapUsages(context.scratchArena,
+                                                                           heaps,
+                                                                           resourceInstances,
+                                                                           sortedResourceIndices.crange_all(),
+                                                                           fnPlaceMemoryType));
+            }
+
+            if ((m_placementStrategy == RPS_MEMORY_PLACEMENT_MIN_MEMORY) && bUseAliasing)
+            {
+                RPS_V_RETURN(SelectMinMemoryPlacementOrders(context.scratchArena,
+                                                            heaps,
+                                                            resourceInstances,
+                                                            sortedResourceIndices.range_all(),
+                                                            m_memTypeFitStrategies,
+                                                            fnPlaceMemoryType));
+            }
+
             // For each resource in sorted list, try allocate in a 2d rectangle ( width = cmd index span, height = size )
             uint32_t currHeapMemType = UINT32_MAX;
             for (size_t iIndex = 0, endIndex = sortedResourceIndices.size(); iIndex < endIndex; iIndex++)
@@ -273,9 +559,11 @@ namespace rps
 
             ArenaCheckPoint arenaCheckpoint{context.scratchArena};
 
-            // Ordered index list by (heap, offset, end), cleared when switching heap type
-            ArenaVector<uint32_t> allocatedIndices(&context.scratchArena);
-            allocatedIndices.reserve(sortedResourceIndices.size());
+            // Allocations of the current heap type, reset when switching heap type
+            HeapAllocationIndex allocations(&context.scratchArena);
+            RPS_CHECK_ALLOC(allocations.Reserve(sortedResourceIndices.size()));
+
+            SmallResourcePool smallResPool(&context.scratchArena);
 
             ArenaVector<uint32_t> pendingReallocIndices(&context.scratchArena);
             pendingReallocIndices.reserve(sortedResourceIndices.size());
@@ -283,8 +571,8 @@ namespace rps
             auto flushPendingReallocIndices = [&]() {
                 for (uint32_t pendingIdx : pendingReallocIndices)
                 {
-                    RPS_V_RETURN(
-                        CalculateResourcePlacement(currHeapMemType, allocatedIndices, pendingIdx, bUseAliasing));
+                    RPS_V_RETURN(CalculateResourcePlacement(
+                        currHeapMemType, allocations, smallResPool, pendingIdx, bUseAliasing));
                 }
                 pendingReallocIndices.clear();
                 return RPS_OK;
@@ -313,16 +601,20 @@ namespace rps
                 RPS_ASSERT((!currRes.isPendingCreate) ==
                            (currRes.hRuntimeResource && (currRes.allocPlacement.heapId != RPS_INDEX_NONE_U32)));
 
-                // Insert existing allocations into the allocatedIndices list and update the heap infos accordingly,
+                // Insert existing allocations into the allocation index and update the heap infos accordingly,
                 // in order to hold their placements.
                 if (!currRes.isPendingCreate)
                 {
                     HeapInfo& currHeap = heaps[currRes.allocPlacement.heapId];
 
-                    RPS_ASSERT(bLastResPreallocated || allocatedIndices.empty());
+                    RPS_ASSERT(bLastResPreallocated || (allocations.GetMaxHeapId() == RPS_INDEX_NONE_U32));
 
-                    if (InsertPreAllocatedResourceToSortedAllocationList(
-                            currHeap, allocatedIndices, iRes, resourceInstances))
+                    const bool bHeld =
+                        IsSmallResource(currRes.allocRequirement)
+                            ? InsertPreAllocatedSmallResource(currHeap, allocations, smallResPool, iRes, bUseAliasing)
+                            : InsertPreAllocatedResource(currHeap, allocations, iRes, resourceInstances);
+
+                    if (bHeld)
                     {
                         currHeap.usedSize =
                             rpsMax(currHeap.usedSize, currRes.allocPlacement.offset + currRes.allocRequirement.size);
@@ -348,7 +640,7 @@ namespace rps
                 }
 
                 RPS_V_RETURN(
-                    CalculateResourcePlacement(currHeapMemType, allocatedIndices, iRes, bUseAliasing));
+                    CalculateResourcePlacement(currHeapMemType, allocations, smallResPool, iRes, bUseAliasing));
             }
 
             RPS_V_RETURN(flushPendingReallocIndices());
@@ -356,16 +648,60 @@ namespace rps
             return RPS_OK;
         }
 
-        RpsResult CalculateResourcePlacement(uint32_t                  currHeapMemType,
-                                             ArenaVector<uint32_t>&    allocatedIndices,
-                                             uint32_t                  resIndex,
-                                             bool                      bUseAliasing)
+        RpsResult CalculateResourcePlacement(uint32_t             currHeapMemType,
+                                             HeapAllocationIndex& allocations,
+                                             SmallResourcePool&   smallResPool,
+                                             uint32_t             resIndex,
+                                             bool                 bUseAliasing)
+        {
+            auto resourceInstances = m_pContext->renderGraph.GetResourceInstances().range_all();
+            auto& currRes          = resourceInstances[resIndex];
+
+            if (IsSmallResource(currRes.allocRequirement))
+            {
+                return CalculateSmallResourcePlacement(
+                    currHeapMemType, allocations, smallResPool, resIndex, bUseAliasing);
+            }
+
+            RpsHeapPlacement placement;
+            RPS_V_RETURN(FindHeapPlacement(currHeapMemType,
+                                           allocations,
+                                           currRes.lifetimeBegin,
+                                           currRes.lifetimeEnd,
+                                           currRes.allocRequirement,
+                                           currRes.allocRequirement.alignment,
+                                           bUseAliasing,
+                                           placement));
+
+            currRes.allocPlacement = placement;
+
+            OccupyHeapRange(placement, currRes.allocRequirement);
+
+            // Track current range for placing later resources
+            RPS_CHECK_ALLOC(
+                allocations.Insert(placement.heapId, HeapAllocationIndex::Allocation::FromResource(currRes)));
+
+            return RPS_OK;
+        }
+
+        // Searches the heaps of currHeapMemType for a range fitting memRequirement that no allocation holds during
+        // [lifetimeBegin, lifetimeEnd], creating a new heap if none does. The offset of the range is aligned to
+        // offsetAlignment, while memRequirement.alignment is what the heap itself has to be aligned to.
+        RpsResult FindHeapPlacement(uint32_t                       currHeapMemType,
+                                    HeapAllocationIndex&           allocations,
+                                    uint32_t                       lifetimeBegin,
+                                    uint32_t                       lifetimeEnd,
+                                    const RpsGpuMemoryRequirement& memRequirement,
+                                    uint64_t                       offsetAlignment,
+                                    bool                           bUseAliasing,
+                                    RpsHeapPlacement&              outPlacement)
         {
             auto& context = *m_pContext;
 
-            auto& heaps             = context.renderGraph.GetHeapInfos();
-            auto  resourceInstances = context.renderGraph.GetResourceInstances().range_all();
-            auto& currRes           = resourceInstances[resIndex];
+            auto& heaps = context.renderGraph.GetHeapInfos();
+
+            // Allocations larger than the default heap size only go to dedicated heaps, and only they do.
+            const bool bDedicated = IsDedicatedAllocation(currHeapMemType, memRequirement.size);
 
             {
                 // Search for a valid range, for each existing resource allocated with current heap type:
@@ -375,95 +711,90 @@ namespace rps
                 uint64_t         fitness             = UINT64_MAX;  // Smaller is better
                 RpsHeapPlacement rangeCandidate;
 
-                // TODO: Allow choose first fit / best fit
+                // Candidates at or below this fitness end the search. First fit takes any range the resource fits in,
+                // best fit keeps looking for a perfect fit.
+                const uint64_t acceptedFitness = m_memTypeFitStrategies.GetAcceptedFitness(currHeapMemType);
 
                 if (bUseAliasing)
                 {
-                    // Filter allocated resources by command index range
-                    for (uint32_t iAllocated = 0, numAllocated = uint32_t(allocatedIndices.size());
-                         iAllocated < numAllocated;
-                         iAllocated++)
-                    {
-                        const uint32_t iResAllocated = allocatedIndices[iAllocated];
-                        const auto&    allocatedRes  = resourceInstances[iResAllocated];
+                    const uint32_t lastHeapIndex = allocations.GetMaxHeapId();
 
-                        RPS_ASSERT(allocatedRes.allocRequirement.memoryTypeIndex == currHeapMemType);
-
-                        // Before moving on to new heap, check any space left in current heap.
-                        if (allocatedRes.allocPlacement.heapId != currHeapIndex)
+                    // Visit heaps holding allocations of current heap type in order. Within a heap, only the
+                    // allocations with overlapping lifetimes constrain the space available for current resource.
+                    for (uint32_t heapIndex = 0, numHeapSlots = allocations.GetNumHeapSlots();
+                         (heapIndex < numHeapSlots) && (fitness > acceptedFitness);
+                         heapIndex++)
+                    {
+                        if (!allocations.HasAllocations(heapIndex) || m_heapCompaction.IsRetiringHeap(heapIndex) ||
+                            (IsDedicatedHeap(heaps[heapIndex]) != bDedicated))
                         {
-                            if (currHeapIndex != UINT32_MAX)
-                            {
-                                const auto& currHeap = heaps[currHeapIndex];
+                            continue;
+                        }
 
-                                // Check any space left in previous heap from last allocation to its top
-                                CheckReusableSpaceInHeap(prevRangeEndAligned,
-                                                         currHeap.size,
-                                                         currRes.allocRequirement,
-                                                         currHeapIndex,
-                                                         &fitness,
-                                                         &rangeCandidate);
+                        // Switch to next heap, reset states
+                        prevRangeEndAligned = 0;
+                        currHeapIndex       = heapIndex;
 
-                                // Size fits perfectly, no more search
-                                if (fitness == 0)
-                                    break;
-                            }
+                        const auto& currHeap = heaps[currHeapIndex];
 
-                            // Switch to next heap, reset states
-                            prevRangeEndAligned = 0;
-                            currHeapIndex       = allocatedRes.allocPlacement.heapId;
-                        }
+                        const auto overlaps =
+                            allocations.QuerySortedOverlaps(currHeapIndex, lifetimeBegin, lifetimeEnd);
 
-                        // If lifetimes overlap:
-                        if ((allocatedRes.lifetimeBegin <= currRes.lifetimeEnd) &&
-                            (currRes.lifetimeBegin <= allocatedRes.lifetimeEnd))
+                        for (const auto& allocated : overlaps)
                         {
                             // Only check if there is a gap between previous range end and current allocated resource start
-                            if (prevRangeEndAligned < allocatedRes.allocPlacement.offset)
+                            if (prevRangeEndAligned < allocated.offset)
                             {
-                                const auto& currHeap = heaps[currHeapIndex];
-
                                 CheckReusableSpaceInHeap(prevRangeEndAligned,
-                                                         allocatedRes.allocPlacement.offset,
-                                                         currRes.allocRequirement,
-                                                         currHeapIndex,
+                                                         allocated.offset,
+                                                         memRequirement,
+                                                         heaps[currHeapIndex],
                                                          &fitness,
                                                          &rangeCandidate);
 
-                                // Size fit perfectly, no more search
-                                if (fitness == 0)
+                                // Size fit perfectly (or fits at all for first fit), no more search
+                                if (fitness <= acceptedFitness)
                                     break;
                             }
 
-                            const uint64_t allocatedEnd =
-                                allocatedRes.allocPlacement.offset + allocatedRes.allocRequirement.size;
+                            const uint64_t allocatedEnd = allocated.offset + allocated.size;
 
                             prevRangeEndAligned =
-                                rpsMax(prevRangeEndAligned,
-                                       rpsAlignUp(allocatedEnd, uint64_t(currRes.allocRequirement.alignment)));
+                                rpsMax(prevRangeEndAligned, rpsAlignUp(allocatedEnd, offsetAlignment));
+                        }
+
+                        // Before moving on to new heap, check any space left in current heap from last allocation
+                        // to its top. The top of the last heap is only considered if nothing else fits.
+                        if ((fitness > acceptedFitness) && (currHeapIndex != lastHeapIndex))
+                        {
+                            CheckReusableSpaceInHeap(prevRangeEndAligned,
+                                                     currHeap.size,
+                                                     memRequirement,
+                                                     heaps[currHeapIndex],
+                                                     &fitness,
+                                                     &rangeCandidate);
                         }
                     }
                 }
                 else
                 {
-                    // Not using aliasing. Check last allocation for current heap
-                    if (!allocatedIndices.empty())
+                    // Not using aliasing. Check last heap used by current heap type.
+                    // Only check last heap for now. Can probably look through all allocated heaps with same type and scrape any space from top to limit
+                    currHeapIndex = allocations.GetMaxHeapId();
+                    RPS_ASSERT(prevRangeEndAligned == 0);
+
+                    while ((currHeapIndex != UINT32_MAX) &&
+                           (!allocations.HasAllocations(currHeapIndex) ||
+                            m_heapCompaction.IsRetiringHeap(currHeapIndex) ||
+                            (IsDedicatedHeap(heaps[currHeapIndex]) != bDedicated)))
                     {
-                        // Only check last allocation for now. Can probably look through all allocated heaps with same type and scrape any space from top to limit
-                        const auto& allocatedRes = resourceInstances[allocatedIndices.back()];
-
-                        RPS_ASSERT(allocatedRes.allocRequirement.memoryTypeIndex == currHeapMemType);
-
-                        // Before moving on to new heap, check any space left in current heap.
-                        currHeapIndex = allocatedRes.allocPlacement.heapId;
-                        RPS_ASSERT(prevRangeEndAligned == 0);
+                        currHeapIndex = (currHeapIndex > 0) ? (currHeapIndex - 1) : UINT32_MAX;
                     }
 
                     if (currHeapIndex != UINT32_MAX)
                     {
-                        prevRangeEndAligned = rpsMax(
-                            prevRangeEndAligned,
-                            rpsAlignUp(heaps[currHeapIndex].usedSize, uint64_t(currRes.allocRequirement.alignment)));
+                        prevRangeEndAligned =
+                            rpsMax(prevRangeEndAligned, rpsAlignUp(heaps[currHeapIndex].usedSize, offsetAlignment));
                     }
                 }
 
@@ -475,8 +806,8 @@ namespace rps
 
                     CheckReusableSpaceInHeap(prevRangeEndAligned,
                                              currHeap.size,
-                                             currRes.allocRequirement,
-                                             currHeapIndex,
+                                             memRequirement,
+                                             heaps[currHeapIndex],
                                              &fitness,
                                              &rangeCandidate);
                 }
@@ -484,8 +815,8 @@ namespace rps
                 // Did not find valid space, try grab an unused existing heap / create a new heap
                 if (fitness == UINT64_MAX)
                 {
-                    const uint32_t newHeapIdx = FindOrCreateFreeHeap(
-                        currHeapMemType, currRes.allocRequirement.size, currRes.allocRequirement.alignment);
+                    const uint32_t newHeapIdx =
+                        FindOrCreateFreeHeap(currHeapMemType, memRequirement.size, memRequirement.alignment);
 
                     RPS_ASSERT(newHeapIdx != UINT32_MAX);  // TODO
 
@@ -496,70 +827,126 @@ namespace rps
 
                     CheckReusableSpaceInHeap(prevRangeEndAligned,
                                              currHeap.size,
-                                             currRes.allocRequirement,
-                                             currHeapIndex,
+                                             memRequirement,
+                                             heaps[currHeapIndex],
                                              &fitness,
                                              &rangeCandidate);
                 }
 
                 RPS_RETURN_ERROR_IF(fitness == UINT64_MAX, RPS_ERROR_OUT_OF_MEMORY);
 
-                auto& selectedHeap = heaps[rangeCandidate.heapId];
+                outPlacement = rangeCandidate;
+            }
 
-                // Adjust alignment if RtHeap is not created yet.
-                if (!selectedHeap.hRuntimeHeap)
-                {
-                    selectedHeap.alignment = rpsMax(currRes.allocRequirement.alignment, selectedHeap.alignment);
-                }
+            return RPS_OK;
+        }
 
-                RPS_ASSERT(selectedHeap.alignment >= currRes.allocRequirement.alignment);
+        void OccupyHeapRange(const RpsHeapPlacement& placement, const RpsGpuMemoryRequirement& memRequirement)
+        {
+            auto& selectedHeap = m_pContext->renderGraph.GetHeapInfos()[placement.heapId];
 
-                currRes.allocPlacement = rangeCandidate;
+            // Adjust alignment if RtHeap is not created yet.
+            if (!selectedHeap.hRuntimeHeap)
+            {
+                selectedHeap.alignment = rpsMax(memRequirement.alignment, selectedHeap.alignment);
+            }
 
-                // Increase heap top if needed
-                selectedHeap.usedSize =
-                    rpsMax(selectedHeap.usedSize, rangeCandidate.offset + currRes.allocRequirement.size);
-                selectedHeap.maxUsedSize = rpsMax(selectedHeap.maxUsedSize, selectedHeap.usedSize);
+            RPS_ASSERT(selectedHeap.alignment >= memRequirement.alignment);
 
-                // Insert current range to allocatedIndices sorted
-                InsertToSortedAllocationList(allocatedIndices, resIndex, resourceInstances);
-            }
+            // Increase heap top if needed
+            selectedHeap.usedSize    = rpsMax(selectedHeap.usedSize, placement.offset + memRequirement.size);
+            selectedHeap.maxUsedSize = rpsMax(selectedHeap.maxUsedSize, selectedHeap.usedSize);
+        }
 
-            return RPS_OK;
+        bool IsSmallResource(const RpsGpuMemoryRequirement& memRequirement) const
+        {
+            return m_bSmallResourcePages && SmallResourcePool::IsSmallResource(memRequirement);
         }
 
-        void CheckReusableSpaceInHeap(uint64_t                      spaceBegin,
-                                      uint64_t                      spaceEnd,
-                                      const RpsGpuMemoryRequirement memRequirement,
-                                      uint32_t                      heapIndex,
-                                      uint64_t*                     pFitness,
-                                      RpsHeapPlacement*             pCandidate)
+        // Places a small resource in the first page (or best page, with best fit) with space free during its
+        // lifetime, or in a new page.
+        RpsResult CalculateSmallResourcePlacement(uint32_t             currHeapMemType,
+                                                  HeapAllocationIndex& allocations,
+                                                  SmallResourcePool&   smallResPool,
+                                                  uint32_t             resIndex,
+                                                  bool                 bUseAliasing)
         {
-            auto& heaps = m_pContext->renderGraph.GetHeapInfos();
+            auto        resourceInstances = m_pContext->renderGraph.GetResourceInstances().range_all();
+            auto&       currRes           = resourceInstances[resIndex];
+            const auto& heaps             = m_pContext->renderGraph.GetHeapInfos();
+
+            const uint64_t acceptedFitness = m_memTypeFitStrategies.GetAcceptedFitness(currHeapMemType);
 
-            auto& heapInfo = heaps[heapIndex];
+            uint64_t         fitness   = UINT64_MAX;
+            uint32_t         pageIndex = RPS_INDEX_NONE_U32;
+            RpsHeapPlacement rangeCandidate;
 
-            if ((heapInfo.hRuntimeHeap) && (heapInfo.alignment < memRequirement.alignment))
+            for (uint32_t iPage = 0; (iPage < smallResPool.GetNumPages()) && (fitness > acceptedFitness); iPage++)
             {
-                // Fail if runtime heap already exists but heap alignment is smaller than resource required alignment.
-                return;
-            }
+                const uint32_t pageHeapIndex = smallResPool.GetPagePlacement(iPage).heapId;
+
+                if (m_heapCompaction.IsRetiringHeap(pageHeapIndex))
+                {
+                    continue;
+                }
 
-            uint64_t newRangeEnd = spaceBegin + memRequirement.size;
+                const uint64_t prevFitness = fitness;
 
-            // Check if requiredSize can fit the space:
-            if (newRangeEnd <= spaceEnd)
+                smallResPool.FindSpaceInPage(
+                    iPage, resourceInstances, heaps[pageHeapIndex], currRes, bUseAliasing, &fitness, &rangeCandidate);
+
+                pageIndex = (fitness < prevFitness) ? iPage : pageIndex;
+            }
+
+            if (fitness == UINT64_MAX)
             {
-                uint64_t newFitness = spaceEnd - newRangeEnd;
+                // Pages are held for the whole frame, residents alias within the page instead. A page only needs the
+                // heap to be aligned for the resource it is created for, later residents are checked as they come.
+                const RpsGpuMemoryRequirement pageRequirement = {
+                    SmallResourcePool::PAGE_SIZE, currRes.allocRequirement.alignment, currHeapMemType};
 
-                if (newFitness < *pFitness)
-                {
-                    pCandidate->heapId = heapIndex;
-                    pCandidate->offset    = spaceBegin;
+                RPS_V_RETURN(FindHeapPlacement(currHeapMemType,
+                                               allocations,
+                                               0,
+                                               UINT32_MAX,
+                                               pageRequirement,
+                                               SmallResourcePool::PAGE_SIZE,
+                                               bUseAliasing,
+                                               rangeCandidate));
 
-                    *pFitness = newFitness;
-                }
+                OccupyHeapRange(rangeCandidate, pageRequirement);
+
+                const HeapAllocationIndex::Allocation pageRange = {
+                    rangeCandidate.offset, SmallResourcePool::PAGE_SIZE, 0, UINT32_MAX};
+
+                RPS_CHECK_ALLOC(allocations.Insert(rangeCandidate.heapId, pageRange));
+                RPS_CHECK_ALLOC(smallResPool.AddPage(rangeCandidate));
+
+                pageIndex = smallResPool.GetNumPages() - 1;
             }
+
+            currRes.allocPlacement = rangeCandidate;
+
+            OccupyHeapRange(rangeCandidate, currRes.allocRequirement);
+
+            RPS_CHECK_ALLOC(smallResPool.AddResident(pageIndex, resIndex));
+
+            return RPS_OK;
+        }
+
+        // Resources larger than the default heap size get heaps of their own sized to fit, which no smaller
+        // allocation is placed in. That keeps default sized heaps reusable and lets later large resources reuse the
+        // dedicated heaps.
+        bool IsDedicatedAllocation(uint32_t memTypeIndex, uint64_t size) const
+        {
+            const uint64_t defaultHeapSize = m_pContext->renderGraph.GetMemoryTypes()[memTypeIndex].defaultHeapSize;
+
+            return (defaultHeapSize > 0) && (size > defaultHeapSize);
+        }
+
+        bool IsDedicatedHeap(const HeapInfo& heap) const
+        {
+            return (heap.size != UINT64_MAX) && IsDedicatedAllocation(heap.memTypeIndex, heap.size);
         }
 
         uint32_t FindOrCreateFreeHeap(uint32_t memoryTypeIndex, uint64_t minSize, uint32_t minAlignment)
@@ -569,10 +956,12 @@ namespace rps
             for (size_t heapIdx = 0, numHeaps = heaps.size(); heapIdx < numHeaps; heapIdx++)
             {
                 const auto& heap = heaps[heapIdx];
-                // TODO: If allocation minSize > default heap size, we allocate a heap just fit the size.
-                // Need to make sure this heap is not grabbed by other smaller allocations, or check for a better solution.
+
+                // Allocations larger than the default heap size get a heap just fitting their size, which is not
+                // grabbed by smaller allocations.
                 if ((heap.memTypeIndex == memoryTypeIndex) && (heap.usedSize == 0) && (minSize <= heap.size) &&
-                    (minAlignment <= heap.alignment))
+                    (minAlignment <= heap.alignment) && !m_heapCompaction.IsRetiringHeap(uint32_t(heapIdx)) &&
+                    (IsDedicatedHeap(heap) == IsDedicatedAllocation(memoryTypeIndex, minSize)))
                 {
                     RPS_ASSERT(heap.hRuntimeHeap);
                     return uint32_t(heapIdx);
@@ -619,13 +1008,21 @@ namespace rps
             return newHeapIdx;
         }
 
-        struct HeapRangeUsage
+        // Resources may still be flagged as aliased by an update with aliasing enabled.
+        void ClearResourceAliasing(RenderGraphUpdateContext& context)
         {
-            uint64_t size;
-            uint64_t heapOffset;
-            uint32_t heapIndex;
-            uint32_t resourceIndex;
-        };
+            context.renderGraph.GetResourceAliasingInfos().clear();
+
+            for (auto& runtimeCmd : context.renderGraph.GetRuntimeCmdInfos())
+            {
+                runtimeCmd.aliasingInfos = {};
+            }
+
+            for (auto& resInst : context.renderGraph.GetResourceInstances())
+            {
+                resInst.isAliased = false;
+            }
+        }
 
         // Foreach command, update resource usage ranges & find alias
         RpsResult CalculateResourceAliasing(RenderGraphUpdateContext& context)
@@ -637,11 +1034,9 @@ namespace rps
 
             ArenaCheckPoint arenaCheckpoint{context.scratchArena};
 
-            ArenaVector<HeapRangeUsage> heapRangeUsages(&context.scratchArena);
-            heapRangeUsages.reserve(resourceInstances.size());
-
+            HeapRangeSweep heapRangeSweep(&context.scratchArena);
+            RPS_CHECK_ALLOC(heapRangeSweep.reserve(resourceInstances.size() * 2 + 1));
 
-            // TODO: Only check the resources referenced by current cmd? Do all resources starting at a cmd referenced by the cmd?
             ArenaVector<uint32_t> resourceIdxSortedByLifetimeStart(resourceInstances.size(), &context.scratchArena);
             std::iota(resourceIdxSortedByLifetimeStart.begin(), resourceIdxSortedByLifetimeStart.end(), 0);
             std::sort(resourceIdxSortedByLifetimeStart.begin(),
@@ -665,6 +1060,9 @@ namespace rps
             ArenaBitVector<> aliasingSrcBitMask(&context.scratchArena);
             RPS_CHECK_ALLOC(aliasingSrcBitMask.Resize(uint32_t(resourceInstances.size()), false));
 
+            ArenaBitVector<> aliasedBitMask(&context.scratchArena);
+            RPS_CHECK_ALLOC(aliasedBitMask.Resize(uint32_t(resourceInstances.size()), false));
+
             ArenaBitVector<> prevFrameAliasedMasks{&context.scratchArena,};
             RPS_CHECK_ALLOC(prevFrameAliasedMasks.Resize(resourceInstances.size()));
 
@@ -709,89 +1107,49 @@ namespace rps
                     currentResourceRange.size          = resInst.allocRequirement.size;
                     currentResourceRange.resourceIndex = resIndex;
 
-                    HeapRangeUsage complementParts[2];
+                    resInst.isAliased = false;
 
-                    uint32_t initialNumActiveRanges = uint32_t(heapRangeUsages.size());
+                    RPS_V_RETURN(heapRangeSweep.Place(currentResourceRange, [&](uint32_t srcResourceIdx) {
+                        ResourceAliasingInfo* pAliasingInfo = aliasingInfos.grow(1);
+                        RPS_CHECK_ALLOC(pAliasingInfo);
 
-                    resInst.isAliased = false;
+                        pAliasingInfo->srcResourceIndex = srcResourceIdx;
+                        pAliasingInfo->dstResourceIndex = resIndex;
+                        pAliasingInfo->srcDeactivating  = RPS_FALSE;
+                        pAliasingInfo->dstActivating    = RPS_FALSE;
+                        // dstActivating Will be set on the last aliasing info where current resIndex is dst.
 
-                    for (uint32_t iRange = 0; iRange < rpsMin(initialNumActiveRanges, uint32_t(heapRangeUsages.size()));
-                         iRange++)
-                    {
-                        if (heapRangeUsages[iRange].heapIndex != currentResourceRange.heapIndex)
+                        // First time seen src as aliasing src, deactivate
+                        bool bFirstTimeAsSrc = !aliasingSrcBitMask.ExchangeBit(srcResourceIdx, true);
+                        if (bFirstTimeAsSrc)
                         {
-                            continue;
+                            pAliasingInfo->srcDeactivating = RPS_TRUE;
+                            numDeactivatedRes++;
                         }
 
-                        uint32_t clipResultMask = 0;
+                        auto& srcResInfo = resourceInstances[srcResourceIdx];
 
-                        if (HeapRangeClip(
-                                &currentResourceRange, &heapRangeUsages[iRange], complementParts, clipResultMask))
+                        if (!srcResInfo.isAliased)
                         {
-                            const uint32_t currAliasingInfoIdx = uint32_t(aliasingInfos.size());
-
-                            const uint32_t srcResourceIdx = heapRangeUsages[iRange].resourceIndex;
-
-                            ResourceAliasingInfo* pAliasingInfo = aliasingInfos.grow(1);
-
-                            pAliasingInfo->srcResourceIndex = srcResourceIdx;
-                            pAliasingInfo->dstResourceIndex = resIndex;
-                            pAliasingInfo->srcDeactivating  = RPS_FALSE;
-                            pAliasingInfo->dstActivating    = RPS_FALSE;
-                            // dstActivating Will be set on the last aliasing info where current resIndex is dst.
-
-                            // First time seen src as aliasing src, deactivate
-                            bool bFirstTimeAsSrc = !aliasingSrcBitMask.ExchangeBit(srcResourceIdx, true);
-                            if (bFirstTimeAsSrc)
-                            {
-                                pAliasingInfo->srcDeactivating = RPS_TRUE;
-                                numDeactivatedRes++;
-                            }
-
-                            auto& srcResInfo = resourceInstances[srcResourceIdx];
-
-                            if (!srcResInfo.isAliased)
-                            {
-                                // Src resource is not aliased yet. May need to initialize it before first access.
-                                pendingAliasingSrcs.push_back(srcResourceIdx);
-                                srcResInfo.isAliased = true;
-
-                                RPS_ASSERT(!srcResInfo.IsPersistent());
-
-                                numAliasingRes++;
-                            }
-
-                            resInst.isAliased = true;
+                            // Src resource is not aliased yet. May need to initialize it before first access.
+                            pendingAliasingSrcs.push_back(srcResourceIdx);
+                            srcResInfo.isAliased = true;
+                            aliasedBitMask.SetBit(srcResourceIdx, true);
 
-                            RPS_ASSERT(!resInst.IsPersistent());
+                            RPS_ASSERT(!srcResInfo.IsPersistent());
 
-                            RPS_ASSERT((resInst.lifetimeBegin > srcResInfo.lifetimeEnd) ||
-                                        (resInst.lifetimeEnd < srcResInfo.lifetimeBegin));
+                            numAliasingRes++;
+                        }
 
-                            if (clipResultMask & 0x1)
-                            {
-                                heapRangeUsages[iRange] = complementParts[0];
+                        resInst.isAliased = true;
 
-                                if (clipResultMask & 0x2)
-                                {
-                                    heapRangeUsages.push_back(complementParts[1]);
-                                }
-                            }
-                            else if (clipResultMask == 0x2)
-                            {
-                                heapRangeUsages[iRange] = complementParts[1];
-                            }
-                            else  // fully overlap
-                            {
-                                heapRangeUsages[iRange] = heapRangeUsages.back();
-                                heapRangeUsages.pop_back();
+                        RPS_ASSERT(!resInst.IsPersistent());
 
-                                iRange--;
-                            }
-                        }
-                    }
+                        RPS_ASSERT((resInst.lifetimeBegin > srcResInfo.lifetimeEnd) ||
+                                   (resInst.lifetimeEnd < srcResInfo.lifetimeBegin));
 
-                    heapRangeUsages.push_back(currentResourceRange);
+                        return RPS_OK;
+                    }));
 
                     if (resInst.isAliased)
                     {
@@ -799,6 +1157,7 @@ namespace rps
                         RPS_ASSERT(aliasingInfos.back().dstResourceIndex == resIndex);
 
                         aliasingInfos.back().dstActivating = RPS_TRUE;
+                        aliasedBitMask.SetBit(resIndex, true);
                         numAliasingRes++;
                     }
                 }
@@ -846,31 +1205,35 @@ namespace rps
 
             uint32_t postambleAliasingInfoOffset = uint32_t(aliasingInfos.size());
 
+            // Aliased resources never used as an aliasing source, a word of the bit masks at a time.
+            const auto& aliasedBits     = aliasedBitMask.GetVector();
+            const auto& aliasingSrcBits = aliasingSrcBitMask.GetVector();
+
             uint32_t numAliasingResCounted = 0;
-            for (uint32_t iRes = 0, numRes = uint32_t(resourceInstances.size()); iRes < numRes; iRes++)
+            for (uint32_t iElement = 0, numElements = uint32_t(aliasedBits.size()); iElement < numElements; iElement++)
             {
-                const auto& resInst = resourceInstances[iRes];
+                uint64_t pendingBits = aliasedBits[iElement] & ~aliasingSrcBits[iElement];
 
-                // Persistent resource shouldn't be aliased.
-                RPS_ASSERT(!(resInst.IsPersistent() && resInst.isAliased));
+                numAliasingResCounted += rpsCountBits(uint32_t(aliasedBits[iElement])) +
+                                         rpsCountBits(uint32_t(aliasedBits[iElement] >> 32));
 
-                if (resInst.lifetimeBegin == ResourceInstance::LIFETIME_UNDEFINED)
+                for (; pendingBits != 0; pendingBits &= (pendingBits - 1))
                 {
-                    continue;
-                }
+                    const uint32_t iRes = iElement * ArenaBitVector<>::ELEMENT_NUM_BITS + rpsFirstBitLow(pendingBits);
+
+                    // Persistent resource shouldn't be aliased.
+                    RPS_ASSERT(resourceInstances[iRes].isAliased && !resourceInstances[iRes].IsPersistent());
 
-                if (resInst.isAliased && !aliasingSrcBitMask.GetBit(iRes))
-                {
                     ResourceAliasingInfo* pFrameEndAliasingInfo = aliasingInfos.grow(1);
-                    pFrameEndAliasingInfo->srcResourceIndex     = iRes;
-                    pFrameEndAliasingInfo->dstResourceIndex     = RPS_RESOURCE_ID_INVALID;
-                    pFrameEndAliasingInfo->srcDeactivating      = RPS_TRUE;
-                    pFrameEndAliasingInfo->dstActivating        = RPS_FALSE;
+                    RPS_CHECK_ALLOC(pFrameEndAliasingInfo);
+
+                    pFrameEndAliasingInfo->srcResourceIndex = iRes;
+                    pFrameEndAliasingInfo->dstResourceIndex = RPS_RESOURCE_ID_INVALID;
+                    pFrameEndAliasingInfo->srcDeactivating  = RPS_TRUE;
+                    pFrameEndAliasingInfo->dstActivating    = RPS_FALSE;
 
                     numDeactivatedRes++;
                 }
-
-                numAliasingResCounted += resInst.isAliased ? 1 : 0;
             }
 
             RPS_ASSERT(scheduledCmds.back().cmdId == CMD_ID_POSTAMBLE);
@@ -883,47 +1246,6 @@ namespace rps
 
             return RPS_OK;
         }
-
-        // Clip rhs with lhs, returns if clipping (intersection) happened, and output a bit mask of complement ranges:
-        // Bit 0: complements from rhs, that's less than lhs
-        // Bit 1: complements from rhs, that's greater than lhs
-        bool HeapRangeClip(const HeapRangeUsage* lhs,
-                           const HeapRangeUsage* rhs,
-                           HeapRangeUsage        rhsComplements[2],
-                           uint32_t&             complementMask)
-        {
-            complementMask = 0;
-
-            RPS_ASSERT(lhs->heapIndex == rhs->heapIndex);
-
-            const uint64_t lhsEnd = (lhs->heapOffset + lhs->size);
-            const uint64_t rhsEnd = (rhs->heapOffset + rhs->size);
-
-            if ((lhsEnd > rhs->heapOffset) && (lhs->heapOffset < rhsEnd))
-            {
-                if (lhs->heapOffset > rhs->heapOffset)
-                {
-                    rhsComplements[0].heapIndex     = rhs->heapIndex;
-                    rhsComplements[0].heapOffset    = rhs->heapOffset;
-                    rhsComplements[0].size          = lhs->heapOffset - rhs->heapOffset;
-                    rhsComplements[0].resourceIndex = rhs->resourceIndex;
-                    complementMask |= 0x1;
-                }
-
-                if (lhsEnd < rhsEnd)
-                {
-                    rhsComplements[1].heapIndex     = lhs->heapIndex;
-                    rhsComplements[1].heapOffset    = lhsEnd;
-                    rhsComplements[1].size          = rhsEnd - lhsEnd;
-                    rhsComplements[1].resourceIndex = rhs->resourceIndex;
-                    complementMask |= 0x2;
-                }
-
-                return true;
-            }
-
-            return false;
-        }
     };
 }
 
@@ -37,7 +37,7 @@ namespace rps
 
             // Initialize resource alloc info after access flags is known
             auto& resInstances = context.renderGraph.GetResourceInstances();
-            RPS_V_RETURN(m_pRuntimeDevice->InitializeResourceAllocInfos(resInstances.range_all()));
+            RPS_V_RETURN(InitResourceAllocInfos(resInstances.range_all()));
 
             m_pRuntimeBackend = nullptr;
             m_pRuntimeDevice  = nullptr;
@@ -259,9 +259,9 @@ namespace rps
                     pResInstance->temporalLayerOffset = newTemporalLayerOffset;
                 }
 
-                pendingResCount++;
+                const bool bNewInstance = (pResInstance->resourceDeclId == RPS_INDEX_NONE_U32);
 
-                if (pResInstance->resourceDeclId == RPS_INDEX_NONE_U32)
+                if (bNewInstance)
                 {
                     pResInstance->resourceDeclId = iRes;
                 }
@@ -276,6 +276,23 @@ namespace rps
                     bDescUpdated              = true;
                 }
 
+                // Subresource and alloc infos only depend on the desc and accesses, so unchanged instances keep theirs.
+                if (bDescUpdated || bNewInstance)
+                {
+                    pendingResCount++;
+                    pResInstance->isPendingAllocInfo = true;
+                }
+                else
+                {
+                    if (pendingResCount > 0)
+                    {
+                        RPS_V_RETURN(m_pRuntimeDevice->InitializeSubresourceInfos(
+                            resInstances.range(pendingResStart, pendingResCount)));
+                        pendingResCount = 0;
+                    }
+                    pendingResStart = iRes + 1;
+                }
+
                 if (bDescUpdated && !bIsParamResource)
                 {
                     pResInstance->InvalidateRuntimeResource(pRuntimeBackend);
@@ -321,6 +338,32 @@ namespace rps
             return RPS_OK;
         }
 
+        // Queries the runtime device for contiguous runs of resource instances whose desc or accesses changed since
+        // their alloc infos were last initialized, so steady state frames don't query any.
+        RpsResult InitResourceAllocInfos(ArrayRef<ResourceInstance> resInstances)
+        {
+            uint32_t pendingResStart = 0;
+
+            for (uint32_t iRes = 0, numRes = uint32_t(resInstances.size()); iRes <= numRes; iRes++)
+            {
+                if ((iRes < numRes) && resInstances[iRes].isPendingAllocInfo)
+                {
+                    resInstances[iRes].isPendingAllocInfo = false;
+                    continue;
+                }
+
+                if (iRes > pendingResStart)
+                {
+                    RPS_V_RETURN(m_pRuntimeDevice->InitializeResourceAllocInfos(
+                        resInstances.range(pendingResStart, iRes - pendingResStart)));
+                }
+
+                pendingResStart = iRes + 1;
+            }
+
+            return RPS_OK;
+        }
+
         // Checks if a temporal slice needs recreation. Certain properties such as image dimensions
         // may vary between temporal slices since just a single slice is updated when it is found to be different
         // to its parent.
@@ -396,6 +439,7 @@ namespace rps
                     temporalSlice.fullSubresourceRange = parentResInstance.fullSubresourceRange;
                     temporalSlice.numSubResources      = parentResInstance.numSubResources;
                     temporalSlice.allAccesses          = parentResInstance.allAccesses;
+                    temporalSlice.isPendingAllocInfo   = true;
                     if (!temporalSlice.isExternal)
                     {
                         temporalSlice.InvalidateRuntimeResource(context.renderGraph.GetRuntimeBackend());
@@ -896,6 +940,7 @@ namespace rps
 
             if (bPendingRecreate)
             {
+                resInstance.isPendingAllocInfo = true;
                 resInstance.InvalidateRuntimeResource(m_pRuntimeBackend);
             }
 
@@ -31,6 +31,8 @@ namespace rps
             auto resInfos    = renderGraph.GetResourceInstances().crange_all();
             auto resDecls    = renderGraph.GetBuilder().GetResourceDecls();
 
+            const auto& subResLifetimeInfos = renderGraph.GetSubResourceLifetimes();
+
             PrinterRef printer(context.renderGraph.GetDevice().Printer());
 
             printer("\nScheduled resources:");
@@ -56,6 +58,18 @@ namespace rps
                     resInfo.allAccesses.Print(printer);
 
                     printer("\n    lifetime : [%u - %u]", resInfo.lifetimeBegin, resInfo.lifetimeEnd);
+
+                    const auto subResLifetimes = resInfo.subResourceLifetimes.Get(subResLifetimeInfos);
+
+                    if (subResLifetimes.size() > 1)
+                    {
+                        printer("\n    subresource lifetimes :");
+
+                        for (const auto& lifetime : subResLifetimes)
+                        {
+                            printer(" [%u - %u]", lifetime.lifetimeBegin, lifetime.lifetimeEnd);
+                        }
+                    }
                 }
                 else
                 {
@@ -102,6 +116,11 @@ namespace rps
                     {
                         // TODO: Move transitions out
                         PrintTransitionInfo(context, printer, runtimeCmd.GetTransitionId());
+
+                        if (runtimeCmd.isSplitBarrierBegin || runtimeCmd.isSplitBarrierEnd)
+                        {
+                            printer(runtimeCmd.isSplitBarrierBegin ? " (split begin)" : " (split end)");
+                        }
                     }
                     else
                     {
@@ -0,0 +1,213 @@
+// Copyright (c) 2024 Advanced Micro Devices, Inc.
+//
+// This file is part of the AMD Render Pipeline Shaders SDK which is
+// released under the MIT LICENSE.
+//
+// See file LICENSE.txt for full license details.
+
+#ifndef RPS_HEAP_ALLOCATION_INDEX_HPP
+#define RPS_HEAP_ALLOCATION_INDEX_HPP
+
+#include "runtime/common/rps_render_graph.hpp"
+
+#include <algorithm>
+
+namespace rps
+{
+    // Allocations placed so far for the current memory type, grouped by heap. Each heap keeps an interval tree of
+    // its allocations keyed by lifetime (a treap ordered by lifetimeBegin, where every node also stores the max
+    // lifetimeEnd of its subtree), so finding the allocations a new resource may collide with is proportional to
+    // the number of lifetime overlaps instead of the number of allocations in the heap.
+    class HeapAllocationIndex
+    {
+    public:
+        // A heap range held during a lifetime, by a resource or by a small resource page.
+        struct Allocation
+        {
+            uint64_t offset;
+            uint64_t size;
+            uint32_t lifetimeBegin;
+            uint32_t lifetimeEnd;
+
+            static Allocation FromResource(const ResourceInstance& res)
+            {
+                return {res.allocPlacement.offset, res.allocRequirement.size, res.lifetimeBegin, res.lifetimeEnd};
+            }
+        };
+
+        HeapAllocationIndex(Arena* pArena)
+            : m_nodes(pArena)
+            , m_heapRoots(pArena)
+            , m_overlaps(pArena)
+        {
+        }
+
+        bool Reserve(size_t numAllocations)
+        {
+            return m_nodes.reserve(numAllocations) && m_overlaps.reserve(numAllocations);
+        }
+
+        bool Insert(uint32_t heapId, const Allocation& allocation)
+        {
+            if ((heapId >= m_heapRoots.size()) && !m_heapRoots.resize(heapId + 1, RPS_INDEX_NONE_U32))
+            {
+                return false;
+            }
+
+            const uint32_t nodeIndex = uint32_t(m_nodes.size());
+
+            Node newNode;
+            newNode.allocation  = allocation;
+            newNode.maxEnd      = allocation.lifetimeEnd;
+            newNode.priority    = HashPriority(nodeIndex);
+            newNode.children[0] = RPS_INDEX_NONE_U32;
+            newNode.children[1] = RPS_INDEX_NONE_U32;
+
+            if (!m_nodes.push_back(newNode))
+            {
+                return false;
+            }
+
+            m_heapRoots[heapId] = InsertNode(m_heapRoots[heapId], nodeIndex);
+            m_maxHeapId         = (m_maxHeapId == RPS_INDEX_NONE_U32) ? heapId : rpsMax(m_maxHeapId, heapId);
+
+            return true;
+        }
+
+        // Returns the allocations in heapId with lifetimes overlapping [lifetimeBegin, lifetimeEnd], in no
+        // particular order. The returned range is invalidated by the next query.
+        ConstArrayRef<Allocation> QueryOverlaps(uint32_t heapId, uint32_t lifetimeBegin, uint32_t lifetimeEnd)
+        {
+            m_overlaps.clear();
+
+            if (heapId < m_heapRoots.size())
+            {
+                CollectOverlaps(m_heapRoots[heapId], lifetimeBegin, lifetimeEnd);
+            }
+
+            return m_overlaps.crange_all();
+        }
+
+        // Same as QueryOverlaps, but ordered by (offset, size).
+        ConstArrayRef<Allocation> QuerySortedOverlaps(uint32_t heapId, uint32_t lifetimeBegin, uint32_t lifetimeEnd)
+        {
+            QueryOverlaps(heapId, lifetimeBegin, lifetimeEnd);
+
+            std::sort(m_overlaps.begin(), m_overlaps.end(), [](const Allocation& a, const Allocation& b) {
+                return (a.offset < b.offset) || ((a.offset == b.offset) && (a.size < b.size));
+            });
+
+            return m_overlaps.crange_all();
+        }
+
+        bool HasAllocations(uint32_t heapId) const
+        {
+            return (heapId < m_heapRoots.size()) && (m_heapRoots[heapId] != RPS_INDEX_NONE_U32);
+        }
+
+        uint32_t GetNumHeapSlots() const
+        {
+            return uint32_t(m_heapRoots.size());
+        }
+
+        uint32_t GetMaxHeapId() const
+        {
+            return m_maxHeapId;
+        }
+
+    private:
+        struct Node
+        {
+            Allocation allocation;
+            uint32_t   maxEnd;
+            uint32_t   priority;
+            uint32_t   children[2];
+        };
+
+        static uint32_t HashPriority(uint32_t value)
+        {
+            // Deterministic pseudo random priorities keep the tree balanced in expectation.
+            value ^= value >> 16;
+            value *= 0x7feb352du;
+            value ^= value >> 15;
+            value *= 0x846ca68bu;
+            value ^= value >> 16;
+            return value;
+        }
+
+        void UpdateMaxEnd(uint32_t nodeIndex)
+        {
+            Node& node  = m_nodes[nodeIndex];
+            node.maxEnd = node.allocation.lifetimeEnd;
+
+            for (uint32_t child : node.children)
+            {
+                if (child != RPS_INDEX_NONE_U32)
+                {
+                    node.maxEnd = rpsMax(node.maxEnd, m_nodes[child].maxEnd);
+                }
+            }
+        }
+
+        uint32_t InsertNode(uint32_t rootIndex, uint32_t nodeIndex)
+        {
+            if (rootIndex == RPS_INDEX_NONE_U32)
+            {
+                return nodeIndex;
+            }
+
+            const uint32_t side =
+                (m_nodes[nodeIndex].allocation.lifetimeBegin < m_nodes[rootIndex].allocation.lifetimeBegin) ? 0 : 1;
+
+            const uint32_t newChild           = InsertNode(m_nodes[rootIndex].children[side], nodeIndex);
+            m_nodes[rootIndex].children[side] = newChild;
+
+            if (m_nodes[newChild].priority > m_nodes[rootIndex].priority)
+            {
+                // Rotate the new child up to keep the heap order on priorities.
+                m_nodes[rootIndex].children[side]    = m_nodes[newChild].children[1 - side];
+                m_nodes[newChild].children[1 - side] = rootIndex;
+
+                UpdateMaxEnd(rootIndex);
+                UpdateMaxEnd(newChild);
+
+                return newChild;
+            }
+
+            UpdateMaxEnd(rootIndex);
+
+            return rootIndex;
+        }
+
+        void CollectOverlaps(uint32_t nodeIndex, uint32_t lifetimeBegin, uint32_t lifetimeEnd)
+        {
+            while ((nodeIndex != RPS_INDEX_NONE_U32) && (m_nodes[nodeIndex].maxEnd >= lifetimeBegin))
+            {
+                const Node& node = m_nodes[nodeIndex];
+
+                CollectOverlaps(node.children[0], lifetimeBegin, lifetimeEnd);
+
+                // Nodes in the right subtree begin no earlier than the current one.
+                if (node.allocation.lifetimeBegin > lifetimeEnd)
+                {
+                    break;
+                }
+
+                if (node.allocation.lifetimeEnd >= lifetimeBegin)
+                {
+                    m_overlaps.push_back(node.allocation);
+                }
+
+                nodeIndex = node.children[1];
+            }
+        }
+
+    private:
+        ArenaVector<Node>       m_nodes;
+        ArenaVector<uint32_t>   m_heapRoots;
+        ArenaVector<Allocation> m_overlaps;
+        uint32_t                m_maxHeapId = RPS_INDEX_NONE_U32;
+    };
+}  // namespace rps
+
+#endif  //RPS_HEAP_ALLOCATION_INDEX_HPP
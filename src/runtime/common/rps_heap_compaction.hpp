@@ -0,0 +1,295 @@
+// Copyright (c) 2024 Advanced Micro Devices, Inc.
+//
+// This file is part of the AMD Render Pipeline Shaders SDK which is
+// released under the MIT LICENSE.
+//
+// See file LICENSE.txt for full license details.
+
+#ifndef RPS_HEAP_COMPACTION_HPP
+#define RPS_HEAP_COMPACTION_HPP
+
+#include "runtime/common/rps_memory_budget.hpp"
+#include "runtime/common/rps_memory_placement_trials.hpp"
+
+#include <algorithm>
+
+namespace rps
+{
+    // Heap compaction state across updates, see RPS_RENDER_GRAPH_COMPACT_HEAPS.
+    class HeapCompaction
+    {
+        static constexpr uint32_t DEFAULT_COMPACTION_THRESHOLD_PERCENT = 25;
+        static constexpr uint32_t DEFAULT_MAX_COMPACTION_MOVES         = 16;
+
+        enum class HeapCompactionState
+        {
+            None,            // Heap is used for placement as usual.
+            Retiring,        // Resources are moved out of the heap, no new resources are placed in it.
+            PendingRelease,  // Heap is empty, waiting for the GPU to finish the frames using it.
+        };
+
+        struct HeapCompactionInfo
+        {
+            HeapCompactionState state;
+            uint64_t            emptyFrameIndex;  // Update in which a PendingRelease heap was found empty.
+        };
+
+        struct MemTypeCompactionInfo
+        {
+            bool     bCompacting;
+            uint64_t compactedSize;  // Heap size after the last compaction. Fragmentation is only checked once the
+                                     // heaps grew beyond it, so a layout that can't be compacted further is kept.
+        };
+
+    public:
+        HeapCompaction(const RpsAllocator& allocator)
+            : m_arena(allocator)
+            , m_heapCompactionInfos(&m_arena)
+            , m_memTypeCompactionInfos(&m_arena)
+        {
+        }
+
+        bool IsCompacting() const
+        {
+            return std::any_of(m_heapCompactionInfos.begin(), m_heapCompactionInfos.end(), [](const auto& info) {
+                return info.state != HeapCompactionState::None;
+            });
+        }
+
+        // Returns true if no new resources may be placed in the heap because it is being compacted.
+        bool IsRetiringHeap(uint32_t heapIndex) const
+        {
+            return (heapIndex < m_heapCompactionInfos.size()) &&
+                   (m_heapCompactionInfos[heapIndex].state != HeapCompactionState::None);
+        }
+
+        // Heap usage of a compacted placement per memory type, zero initialized, or empty if compaction is disabled.
+        // Must stay valid until CheckHeapFragmentation.
+        void SetCompactedHeapUsages(ArrayRef<uint64_t> compactedHeapUsages)
+        {
+            m_compactedHeapUsages = compactedHeapUsages;
+        }
+
+        bool IsCalculatingCompactedHeapUsages() const
+        {
+            return !m_compactedHeapUsages.empty();
+        }
+
+        // Releases the heaps the GPU has passed, then moves up to maxCompactionMovesPerUpdate resources out of
+        // retiring heaps by invalidating them, so they are placed again in the remaining heaps.
+        RpsResult UpdateHeapCompaction(RenderGraphUpdateContext& context)
+        {
+            auto& heaps             = context.renderGraph.GetHeapInfos();
+            auto  resourceInstances = context.renderGraph.GetResourceInstances().range_all();
+            auto  pRuntimeBackend   = context.renderGraph.GetRuntimeBackend();
+
+            const auto& memoryInfo = context.renderGraph.GetCreateInfo().memoryInfo;
+
+            RPS_CHECK_ALLOC(m_heapCompactionInfos.resize(heaps.size(), HeapCompactionInfo{}));
+            RPS_CHECK_ALLOC(
+                m_memTypeCompactionInfos.resize(context.renderGraph.GetMemoryTypes().size(), MemTypeCompactionInfo{}));
+
+            const uint64_t gpuCompletedFrameIndex = context.pUpdateInfo->gpuCompletedFrameIndex;
+
+            for (uint32_t iHeap = 0, numHeaps = uint32_t(heaps.size()); iHeap < numHeaps; iHeap++)
+            {
+                auto& compactionInfo = m_heapCompactionInfos[iHeap];
+
+                // Frames before the one that found the heap empty may still be using it.
+                if ((compactionInfo.state == HeapCompactionState::PendingRelease) &&
+                    (gpuCompletedFrameIndex != RPS_GPU_COMPLETED_FRAME_INDEX_NONE) &&
+                    ((gpuCompletedFrameIndex + 1) >= compactionInfo.emptyFrameIndex))
+                {
+                    pRuntimeBackend->ReleaseHeap(heaps[iHeap]);
+                    compactionInfo = {};
+                }
+            }
+
+            uint32_t movesLeft = (memoryInfo.maxCompactionMovesPerUpdate > 0) ? memoryInfo.maxCompactionMovesPerUpdate
+                                                                               : DEFAULT_MAX_COMPACTION_MOVES;
+
+            for (uint32_t iRes = 0; (iRes < resourceInstances.size()) && (movesLeft > 0); iRes++)
+            {
+                auto& resInst = resourceInstances[iRes];
+
+                if (!resInst.isExternal && !resInst.isPendingCreate &&
+                    (resInst.allocPlacement.heapId != RPS_INDEX_NONE_U32) &&
+                    (m_heapCompactionInfos[resInst.allocPlacement.heapId].state == HeapCompactionState::Retiring))
+                {
+                    resInst.InvalidateRuntimeResource(pRuntimeBackend);
+                    movesLeft--;
+                }
+            }
+
+            return RPS_OK;
+        }
+
+        // Places the resources of each memory type not being compacted as if none of them held a placement from a
+        // previous update, and records the resulting heap usage. Heaps and placements are restored afterwards.
+        // fnPlaceMemoryType(memTypeIndex, resIndices) places resIndices, all of memTypeIndex, in order.
+        template <typename TPlaceMemoryTypeFunc>
+        RpsResult CalculateCompactedHeapUsages(Arena&                     scratchArena,
+                                               ArenaVector<HeapInfo>&     heaps,
+                                               ArrayRef<ResourceInstance> resourceInstances,
+                                               ConstArrayRef<uint32_t>    sortedResourceIndices,
+                                               TPlaceMemoryTypeFunc       fnPlaceMemoryType)
+        {
+            ArenaCheckPoint arenaCheckpoint{scratchArena};
+
+            PlacementSnapshot     snapshot(&scratchArena);
+            ArenaVector<uint32_t> trialIndices(&scratchArena);
+
+            for (size_t rangeBegin = 0, rangeEnd = 0; rangeBegin < sortedResourceIndices.size(); rangeBegin = rangeEnd)
+            {
+                rangeEnd = FindMemoryTypeRangeEnd(resourceInstances, sortedResourceIndices, rangeBegin);
+
+                const uint32_t memType =
+                    resourceInstances[sortedResourceIndices[rangeBegin]].allocRequirement.memoryTypeIndex;
+
+                if (m_memTypeCompactionInfos[memType].bCompacting)
+                {
+                    continue;
+                }
+
+                auto range = sortedResourceIndices.range(rangeBegin, rangeEnd - rangeBegin);
+
+                RPS_V_RETURN(snapshot.Save(heaps, resourceInstances, range));
+
+                RPS_CHECK_ALLOC(trialIndices.resize(range.size()));
+                std::copy(range.begin(), range.end(), trialIndices.begin());
+
+                for (uint32_t iRes : range)
+                {
+                    resourceInstances[iRes].allocPlacement  = {RPS_INDEX_NONE_U32, 0};
+                    resourceInstances[iRes].isPendingCreate = true;
+                }
+
+                std::sort(trialIndices.begin(), trialIndices.end(), [&](uint32_t a, uint32_t b) {
+                    return PlacementOrderLess(PlacementOrder::Size, resourceInstances[a], resourceInstances[b]);
+                });
+
+                RPS_V_RETURN(fnPlaceMemoryType(memType, trialIndices.crange_all()));
+
+                for (const auto& heap : heaps)
+                {
+                    m_compactedHeapUsages[memType] += (heap.memTypeIndex == memType) ? heap.usedSize : 0;
+                }
+
+                RPS_V_RETURN(snapshot.Restore(heaps, resourceInstances, range));
+            }
+
+            return RPS_OK;
+        }
+
+        // Starts compacting the heaps of a memory type if they exceed the compacted heap usage by more than the
+        // threshold, and marks retiring heaps without resources left as pending release.
+        RpsResult CheckHeapFragmentation(RenderGraphUpdateContext& context)
+        {
+            const auto& heaps             = context.renderGraph.GetHeapInfos();
+            const auto  resourceInstances = context.renderGraph.GetResourceInstances().crange_all();
+            const auto  memoryTypes       = context.renderGraph.GetMemoryTypes();
+
+            const auto&    memoryInfo = context.renderGraph.GetCreateInfo().memoryInfo;
+            const uint64_t thresholdPercent =
+                (memoryInfo.compactionThresholdPercent > 0) ? memoryInfo.compactionThresholdPercent
+                                                            : DEFAULT_COMPACTION_THRESHOLD_PERCENT;
+
+            RPS_CHECK_ALLOC(m_heapCompactionInfos.resize(heaps.size(), HeapCompactionInfo{}));
+
+            ArenaCheckPoint arenaCheckpoint{context.scratchArena};
+
+            auto heapSizes     = context.scratchArena.NewArrayZeroed<uint64_t>(memoryTypes.size());
+            auto heapResCounts = context.scratchArena.NewArrayZeroed<uint32_t>(heaps.size());
+
+            for (const auto& resInst : resourceInstances)
+            {
+                if (resInst.allocPlacement.heapId != RPS_INDEX_NONE_U32)
+                {
+                    heapResCounts[resInst.allocPlacement.heapId]++;
+                }
+            }
+
+            for (uint32_t iHeap = 0, numHeaps = uint32_t(heaps.size()); iHeap < numHeaps; iHeap++)
+            {
+                const auto& heap = heaps[iHeap];
+
+                if (heap.memTypeIndex == UINT32_MAX)
+                {
+                    continue;
+                }
+
+                if (IsRetiringHeap(iHeap))
+                {
+                    auto& compactionInfo = m_heapCompactionInfos[iHeap];
+
+                    if ((compactionInfo.state == HeapCompactionState::Retiring) && (heapResCounts[iHeap] == 0))
+                    {
+                        compactionInfo.state           = HeapCompactionState::PendingRelease;
+                        compactionInfo.emptyFrameIndex = context.pUpdateInfo->frameIndex;
+                    }
+                }
+                else
+                {
+                    heapSizes[heap.memTypeIndex] += GetHeapFootprint(heap);
+                }
+            }
+
+            for (uint32_t iMemType = 0, numMemTypes = uint32_t(memoryTypes.size()); iMemType < numMemTypes; iMemType++)
+            {
+                auto& memTypeInfo = m_memTypeCompactionInfos[iMemType];
+
+                const bool bRetiringHeaps = std::any_of(heaps.begin(), heaps.end(), [&](const HeapInfo& heap) {
+                    return (heap.memTypeIndex == iMemType) && IsRetiringHeap(heap.index);
+                });
+
+                if (memTypeInfo.bCompacting)
+                {
+                    // Compaction ends once all retiring heaps are released.
+                    if (!bRetiringHeaps)
+                    {
+                        memTypeInfo.bCompacting   = false;
+                        memTypeInfo.compactedSize = heapSizes[iMemType];
+                    }
+                    continue;
+                }
+
+                // Heaps are at least defaultHeapSize large, so the compacted layout is too.
+                const uint64_t defaultHeapSize = memoryTypes[iMemType].defaultHeapSize;
+                const uint64_t compactedSize   = (defaultHeapSize > 0)
+                                                     ? rpsAlignUp(m_compactedHeapUsages[iMemType], defaultHeapSize)
+                                                     : m_compactedHeapUsages[iMemType];
+
+                if ((heapSizes[iMemType] > memTypeInfo.compactedSize) &&
+                    ((heapSizes[iMemType] * 100) > (compactedSize * (100 + thresholdPercent))))
+                {
+                    memTypeInfo.bCompacting = true;
+
+                    for (uint32_t iHeap = 0, numHeaps = uint32_t(heaps.size()); iHeap < numHeaps; iHeap++)
+                    {
+                        if (heaps[iHeap].memTypeIndex == iMemType)
+                        {
+                            // Resources just placed in the heap are moved out by later updates too.
+                            const bool bEmpty = (heapResCounts[iHeap] == 0);
+
+                            m_heapCompactionInfos[iHeap].state =
+                                bEmpty ? HeapCompactionState::PendingRelease : HeapCompactionState::Retiring;
+                            m_heapCompactionInfos[iHeap].emptyFrameIndex = context.pUpdateInfo->frameIndex;
+                        }
+                    }
+                }
+            }
+
+            return RPS_OK;
+        }
+
+    private:
+        Arena                              m_arena;
+        ArenaVector<HeapCompactionInfo>    m_heapCompactionInfos;
+        ArenaVector<MemTypeCompactionInfo> m_memTypeCompactionInfos;
+
+        // Heap usage of a compacted placement per memory type, valid during the update if compaction is enabled.
+        ArrayRef<uint64_t> m_compactedHeapUsages;
+    };
+}  // namespace rps
+
+#endif  //RPS_HEAP_COMPACTION_HPP
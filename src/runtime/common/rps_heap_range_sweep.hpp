@@ -0,0 +1,164 @@
+// Copyright (c) 2024 Advanced Micro Devices, Inc.
+//
+// This file is part of the AMD Render Pipeline Shaders SDK which is
+// released under the MIT LICENSE.
+//
+// See file LICENSE.txt for full license details.
+
+#ifndef RPS_HEAP_RANGE_SWEEP_HPP
+#define RPS_HEAP_RANGE_SWEEP_HPP
+
+#include "core/rps_core.hpp"
+#include "core/rps_util.hpp"
+
+#include <algorithm>
+
+namespace rps
+{
+    struct HeapRangeUsage
+    {
+        uint64_t size;
+        uint64_t heapOffset;
+        uint32_t heapIndex;
+        uint32_t resourceIndex;
+    };
+
+    // Clip rhs with lhs, returns if clipping (intersection) happened, and output a bit mask of complement ranges:
+    // Bit 0: complements from rhs, that's less than lhs
+    // Bit 1: complements from rhs, that's greater than lhs
+    static inline bool HeapRangeClip(const HeapRangeUsage* lhs,
+                                     const HeapRangeUsage* rhs,
+                                     HeapRangeUsage        rhsComplements[2],
+                                     uint32_t&             complementMask)
+    {
+        complementMask = 0;
+
+        RPS_ASSERT(lhs->heapIndex == rhs->heapIndex);
+
+        const uint64_t lhsEnd = (lhs->heapOffset + lhs->size);
+        const uint64_t rhsEnd = (rhs->heapOffset + rhs->size);
+
+        if ((lhsEnd > rhs->heapOffset) && (lhs->heapOffset < rhsEnd))
+        {
+            if (lhs->heapOffset > rhs->heapOffset)
+            {
+                rhsComplements[0].heapIndex     = rhs->heapIndex;
+                rhsComplements[0].heapOffset    = rhs->heapOffset;
+                rhsComplements[0].size          = lhs->heapOffset - rhs->heapOffset;
+                rhsComplements[0].resourceIndex = rhs->resourceIndex;
+                complementMask |= 0x1;
+            }
+
+            if (lhsEnd < rhsEnd)
+            {
+                rhsComplements[1].heapIndex     = lhs->heapIndex;
+                rhsComplements[1].heapOffset    = lhsEnd;
+                rhsComplements[1].size          = rhsEnd - lhsEnd;
+                rhsComplements[1].resourceIndex = rhs->resourceIndex;
+                complementMask |= 0x2;
+            }
+
+            return true;
+        }
+
+        return false;
+    }
+
+    // Tracks the last resource placed in each heap range, while sweeping the resources in the order their lifetimes
+    // begin. The ranges don't overlap and are sorted by heap and offset, so the ranges a new resource aliases are one
+    // run of them, found by a binary search.
+    class HeapRangeSweep
+    {
+    public:
+        HeapRangeSweep(Arena* pArena)
+            : m_ranges(pArena)
+        {
+        }
+
+        bool reserve(size_t numRanges)
+        {
+            return m_ranges.reserve(numRanges);
+        }
+
+        ConstArrayRef<HeapRangeUsage> GetRanges() const
+        {
+            return m_ranges.range_all();
+        }
+
+        // Places newRange over the ranges it overlaps, first calling fnOnOverlap(resourceIndex) for the resource of
+        // each of them, in heap order.
+        template <typename TOverlapFunc>
+        RpsResult Place(const HeapRangeUsage& newRange, TOverlapFunc fnOnOverlap)
+        {
+            // Resources without memory don't alias anything.
+            RPS_RETURN_OK_IF(newRange.size == 0);
+
+            const uint64_t newRangeEnd = newRange.heapOffset + newRange.size;
+
+            const uint32_t firstRange =
+                uint32_t(std::lower_bound(m_ranges.begin(),
+                                          m_ranges.end(),
+                                          newRange,
+                                          [](const HeapRangeUsage& range, const HeapRangeUsage& value) {
+                                              return (range.heapIndex < value.heapIndex) ||
+                                                     ((range.heapIndex == value.heapIndex) &&
+                                                      (range.heapOffset + range.size <= value.heapOffset));
+                                          }) -
+                         m_ranges.begin());
+
+            uint32_t endRange = firstRange;
+
+            for (; (endRange < m_ranges.size()) && (m_ranges[endRange].heapIndex == newRange.heapIndex) &&
+                   (m_ranges[endRange].heapOffset < newRangeEnd);
+                 endRange++)
+            {
+                RPS_V_RETURN(fnOnOverlap(m_ranges[endRange].resourceIndex));
+            }
+
+            // Replace the run with what is left of its first range before the new range, the new range and what is
+            // left of its last range after it.
+            HeapRangeUsage replacements[3];
+            uint32_t       numReplacements = 0;
+
+            HeapRangeUsage complementParts[2];
+            uint32_t       clipResultMask = 0;
+
+            if ((firstRange < endRange) &&
+                HeapRangeClip(&newRange, &m_ranges[firstRange], complementParts, clipResultMask) &&
+                (clipResultMask & 0x1))
+            {
+                replacements[numReplacements++] = complementParts[0];
+            }
+
+            replacements[numReplacements++] = newRange;
+
+            if ((firstRange < endRange) &&
+                HeapRangeClip(&newRange, &m_ranges[endRange - 1], complementParts, clipResultMask) &&
+                (clipResultMask & 0x2))
+            {
+                replacements[numReplacements++] = complementParts[1];
+            }
+
+            const uint32_t runSize = endRange - firstRange;
+
+            if (numReplacements > runSize)
+            {
+                RPS_CHECK_ALLOC(m_ranges.insert(endRange, replacements + runSize, numReplacements - runSize));
+            }
+            else if (numReplacements < runSize)
+            {
+                std::move(m_ranges.begin() + endRange, m_ranges.end(), m_ranges.begin() + firstRange + numReplacements);
+                RPS_CHECK_ALLOC(m_ranges.resize(m_ranges.size() - (runSize - numReplacements)));
+            }
+
+            std::copy(replacements, replacements + rpsMin(numReplacements, runSize), m_ranges.begin() + firstRange);
+
+            return RPS_OK;
+        }
+
+    private:
+        ArenaVector<HeapRangeUsage> m_ranges;
+    };
+}  // namespace rps
+
+#endif  //RPS_HEAP_RANGE_SWEEP_HPP
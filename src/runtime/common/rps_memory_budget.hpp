@@ -0,0 +1,201 @@
+// Copyright (c) 2024 Advanced Micro Devices, Inc.
+//
+// This file is part of the AMD Render Pipeline Shaders SDK which is
+// released under the MIT LICENSE.
+//
+// See file LICENSE.txt for full license details.
+
+#ifndef RPS_MEMORY_BUDGET_HPP
+#define RPS_MEMORY_BUDGET_HPP
+
+#include "runtime/common/rps_render_graph.hpp"
+#include "runtime/common/rps_runtime_device.hpp"
+
+#include <algorithm>
+
+namespace rps
+{
+    static inline uint64_t GetHeapFootprint(const HeapInfo& heap)
+    {
+        // Heaps not created yet or created by a backend not fixing their size grow up to maxUsedSize.
+        return (heap.size != UINT64_MAX) ? heap.size : heap.maxUsedSize;
+    }
+
+    static inline uint64_t GetHeapBudget(const RpsRenderGraphCreateInfo& createInfo, uint32_t memTypeIndex)
+    {
+        return (memTypeIndex < createInfo.memoryInfo.numHeaps)
+                   ? (uint64_t(createInfo.memoryInfo.heapBudgetMiBs[memTypeIndex]) << 20)
+                   : 0;
+    }
+
+    // Returns the first memory type whose heaps exceed its budget after placement, or RPS_INDEX_NONE_U32.
+    static inline uint32_t FindMemoryTypeOverBudget(const RenderGraphUpdateContext& context, uint64_t& requiredSize)
+    {
+        const auto& createInfo = context.renderGraph.GetCreateInfo();
+        const auto& heaps      = context.renderGraph.GetHeapInfos();
+
+        for (uint32_t iMemType = 0; iMemType < createInfo.memoryInfo.numHeaps; iMemType++)
+        {
+            const uint64_t budget = GetHeapBudget(createInfo, iMemType);
+
+            if (budget == 0)
+            {
+                continue;
+            }
+
+            requiredSize = 0;
+
+            for (const auto& heap : heaps)
+            {
+                requiredSize += (heap.memTypeIndex == iMemType) ? GetHeapFootprint(heap) : 0;
+            }
+
+            if (requiredSize > budget)
+            {
+                return iMemType;
+            }
+        }
+
+        return RPS_INDEX_NONE_U32;
+    }
+
+    static inline uint64_t GetAlignedAllocSize(const ResourceInstance& resInst)
+    {
+        return rpsAlignUp(resInst.allocRequirement.size, uint64_t(rpsMax(1u, resInst.allocRequirement.alignment)));
+    }
+
+    // Same selection as CalculateResourcePlacements, optionally restricted to a memory type.
+    static inline bool IsPlacedResource(const ResourceInstance& resInst, uint32_t memTypeIndex, uint32_t numRuntimeCmds)
+    {
+        return ((memTypeIndex == RPS_INDEX_NONE_U32) ||
+                (resInst.allocRequirement.memoryTypeIndex == memTypeIndex)) &&
+               !resInst.isExternal && !resInst.IsTemporalParent() && (resInst.allocRequirement.size > 0) &&
+               !resInst.HasEmptyLifetime() && (resInst.lifetimeEnd < numRuntimeCmds);
+    }
+
+    // Sweeps the lifetimes of the placed resources to find the command with the most memory live. Returns the
+    // index of the command, memTypeIndex RPS_INDEX_NONE_U32 counts all memory types.
+    static inline uint32_t FindPeakMemoryUsage(const RenderGraphUpdateContext& context,
+                                               uint32_t                        memTypeIndex,
+                                               uint64_t&                       peakSize)
+    {
+        ArenaCheckPoint arenaCheckpoint{context.scratchArena};
+
+        const auto resourceInstances = context.renderGraph.GetResourceInstances().crange_all();
+        const auto numRuntimeCmds    = uint32_t(context.renderGraph.GetRuntimeCmdInfos().size());
+
+        ArrayRef<uint64_t> liveBegins = context.scratchArena.NewArrayZeroed<uint64_t>(numRuntimeCmds + 1);
+        ArrayRef<uint64_t> liveEnds   = context.scratchArena.NewArrayZeroed<uint64_t>(numRuntimeCmds + 1);
+
+        peakSize = 0;
+
+        if (liveBegins.empty() || liveEnds.empty())
+        {
+            return 0;
+        }
+
+        for (const auto& resInst : resourceInstances)
+        {
+            if (IsPlacedResource(resInst, memTypeIndex, numRuntimeCmds))
+            {
+                liveBegins[resInst.lifetimeBegin] += GetAlignedAllocSize(resInst);
+                liveEnds[resInst.lifetimeEnd + 1] += GetAlignedAllocSize(resInst);
+            }
+        }
+
+        uint64_t liveSize = 0;
+        uint32_t peakCmd  = 0;
+
+        for (uint32_t iCmd = 0; iCmd < numRuntimeCmds; iCmd++)
+        {
+            liveSize = liveSize + liveBegins[iCmd] - liveEnds[iCmd];
+
+            if (liveSize > peakSize)
+            {
+                peakSize = liveSize;
+                peakCmd  = iCmd;
+            }
+        }
+
+        return peakCmd;
+    }
+
+    static inline void PrintMemoryBudgetReport(const RenderGraphUpdateContext& context,
+                                               uint32_t                        memTypeIndex,
+                                               uint64_t                        requiredSize)
+    {
+        ArenaCheckPoint arenaCheckpoint{context.scratchArena};
+
+        const auto resourceInstances = context.renderGraph.GetResourceInstances().crange_all();
+        const auto resDecls          = context.renderGraph.GetBuilder().GetResourceDecls();
+        const auto numRuntimeCmds    = uint32_t(context.renderGraph.GetRuntimeCmdInfos().size());
+
+        uint64_t       peakSize = 0;
+        const uint32_t peakCmd  = FindPeakMemoryUsage(context, memTypeIndex, peakSize);
+
+        ArenaVector<uint32_t> peakResIndices(&context.scratchArena);
+
+        for (uint32_t iRes = 0; iRes < resourceInstances.size(); iRes++)
+        {
+            const auto& resInst = resourceInstances[iRes];
+
+            if (IsPlacedResource(resInst, memTypeIndex, numRuntimeCmds) && (resInst.lifetimeBegin <= peakCmd) &&
+                (peakCmd <= resInst.lifetimeEnd))
+            {
+                peakResIndices.push_back(iRes);
+            }
+        }
+
+        std::sort(peakResIndices.begin(), peakResIndices.end(), [&](uint32_t a, uint32_t b) {
+            return GetAlignedAllocSize(resourceInstances[a]) > GetAlignedAllocSize(resourceInstances[b]);
+        });
+
+        PrinterRef printer(context.renderGraph.GetDevice().Printer());
+
+        printer("\nMemory budget exceeded for memory type %u ", memTypeIndex);
+        if (context.pRuntimeDevice)
+        {
+            context.pRuntimeDevice->DescribeMemoryType(memTypeIndex, printer);
+        }
+        printer("\n  required : %llu bytes, budget : %llu bytes",
+                (unsigned long long)requiredSize,
+                (unsigned long long)GetHeapBudget(context.renderGraph.GetCreateInfo(), memTypeIndex));
+        printer("\n  peak : cmd %u, %llu bytes live", peakCmd, (unsigned long long)peakSize);
+
+        for (uint32_t iRes : peakResIndices)
+        {
+            const auto& resInst = resourceInstances[iRes];
+
+            printer("\n    %u", iRes);
+            if (resInst.resourceDeclId < resDecls.size())
+            {
+                printer(" '");
+                resDecls[resInst.resourceDeclId].name.Print(printer);
+                printer("'");
+            }
+            printer(" : %llu bytes, lifetime [%u - %u]",
+                    (unsigned long long)GetAlignedAllocSize(resInst),
+                    resInst.lifetimeBegin,
+                    resInst.lifetimeEnd);
+
+            // A placed resource is activated as a whole, so the memory of its idle subresources can only be
+            // reclaimed by splitting it into separate resources. Point out the candidates.
+            const auto subResLifetimes =
+                resInst.subResourceLifetimes.Get(context.renderGraph.GetSubResourceLifetimes());
+
+            const auto numIdleSubResources =
+                std::count_if(subResLifetimes.begin(), subResLifetimes.end(), [&](const auto& lifetime) {
+                    return (lifetime.lifetimeBegin > peakCmd) || (lifetime.lifetimeEnd < peakCmd);
+                });
+
+            if (numIdleSubResources > 0)
+            {
+                printer(", %u of %u subresources idle",
+                        uint32_t(numIdleSubResources),
+                        uint32_t(subResLifetimes.size()));
+            }
+        }
+    }
+}  // namespace rps
+
+#endif  //RPS_MEMORY_BUDGET_HPP
@@ -0,0 +1,138 @@
+// Copyright (c) 2024 Advanced Micro Devices, Inc.
+//
+// This file is part of the AMD Render Pipeline Shaders SDK which is
+// released under the MIT LICENSE.
+//
+// See file LICENSE.txt for full license details.
+
+#ifndef RPS_MEMORY_PLACEMENT_CACHE_HPP
+#define RPS_MEMORY_PLACEMENT_CACHE_HPP
+
+#include "runtime/common/rps_render_graph.hpp"
+
+#include <algorithm>
+
+namespace rps
+{
+    // Placement and aliasing of the last update, reused if the placement inputs are unchanged. The placements and
+    // isAliased flags stay in the resource instances. Only the aliasing infos and the aliasing info ranges of the
+    // runtime cmds, both rebuilt every update, are stored.
+    class MemoryPlacementCache
+    {
+    public:
+        MemoryPlacementCache(const RpsAllocator& allocator)
+            : m_arena(allocator)
+            , m_aliasingInfos(&m_arena)
+            , m_cmdAliasingInfos(&m_arena)
+            , m_inputs(&m_arena)
+        {
+        }
+
+        // Gathers the state CalculateResourcePlacements and CalculateResourceAliasing read. The placement of a
+        // resource pending creation is recalculated anyway, so it is not an input. Since placement results and
+        // isAliased flags are written back to the same fields, an update that changes them misses the cache once
+        // more before settling.
+        static void GatherInputs(CacheInputs& inputs, const RenderGraphUpdateContext& context)
+        {
+            const auto& heaps             = context.renderGraph.GetHeapInfos();
+            const auto& resourceInstances = context.renderGraph.GetResourceInstances();
+
+            inputs.Add(uint32_t(context.renderGraph.GetRuntimeCmdInfos().size()));
+            inputs.Add(context.renderGraph.IsMemoryAliasingEnabled(*context.pUpdateInfo));
+            inputs.Add(uint32_t(heaps.size()));
+
+            for (const auto& heap : heaps)
+            {
+                inputs.Add(heap.memTypeIndex);
+                inputs.Add(heap.size);
+                inputs.Add(heap.alignment);
+                inputs.Add(bool(heap.hRuntimeHeap));
+            }
+
+            inputs.Add(uint32_t(resourceInstances.size()));
+
+            for (const auto& resInst : resourceInstances)
+            {
+                const uint32_t resBits = (resInst.isExternal << 0) | (resInst.IsTemporalParent() << 1) |
+                                         (resInst.isAliased << 2) | (resInst.isPendingCreate << 3) |
+                                         (bool(resInst.hRuntimeResource) << 4);
+
+                inputs.Add(resBits);
+                inputs.Add(resInst.lifetimeBegin);
+                inputs.Add(resInst.lifetimeEnd);
+                inputs.Add(resInst.allocRequirement.size);
+                inputs.Add(resInst.allocRequirement.alignment);
+                inputs.Add(resInst.allocRequirement.memoryTypeIndex);
+
+                if (!resInst.isPendingCreate)
+                {
+                    inputs.Add(resInst.allocPlacement.heapId);
+                    inputs.Add(resInst.allocPlacement.offset);
+                }
+            }
+        }
+
+        bool IsHit(const CacheInputs& inputs) const
+        {
+            return m_bValid && (m_inputs == inputs);
+        }
+
+        void Invalidate()
+        {
+            m_bValid = false;
+        }
+
+        RpsResult Store(const RenderGraphUpdateContext& context, const CacheInputs& inputs)
+        {
+            const auto& runtimeCmds   = context.renderGraph.GetRuntimeCmdInfos();
+            const auto& aliasingInfos = context.renderGraph.GetResourceAliasingInfos();
+
+            m_arena.Reset();
+            m_aliasingInfos.reset(&m_arena);
+            m_cmdAliasingInfos.reset(&m_arena);
+            m_inputs.Reset(&m_arena);
+
+            RPS_CHECK_ALLOC(m_aliasingInfos.resize(aliasingInfos.size()));
+            RPS_CHECK_ALLOC(m_cmdAliasingInfos.resize(runtimeCmds.size()));
+            RPS_CHECK_ALLOC(m_inputs.CopyFrom(inputs));
+
+            std::copy(aliasingInfos.begin(), aliasingInfos.end(), m_aliasingInfos.begin());
+
+            for (size_t iCmd = 0; iCmd < runtimeCmds.size(); iCmd++)
+            {
+                m_cmdAliasingInfos[iCmd] = runtimeCmds[iCmd].aliasingInfos;
+            }
+
+            m_bValid = true;
+
+            return RPS_OK;
+        }
+
+        RpsResult RestoreAliasingInfos(RenderGraphUpdateContext& context) const
+        {
+            auto  runtimeCmds   = context.renderGraph.GetRuntimeCmdInfos().range_all();
+            auto& aliasingInfos = context.renderGraph.GetResourceAliasingInfos();
+
+            RPS_RETURN_ERROR_IF(runtimeCmds.size() != m_cmdAliasingInfos.size(), RPS_ERROR_INTERNAL_ERROR);
+
+            RPS_CHECK_ALLOC(aliasingInfos.resize(m_aliasingInfos.size()));
+            std::copy(m_aliasingInfos.begin(), m_aliasingInfos.end(), aliasingInfos.begin());
+
+            for (size_t iCmd = 0; iCmd < runtimeCmds.size(); iCmd++)
+            {
+                runtimeCmds[iCmd].aliasingInfos = m_cmdAliasingInfos[iCmd];
+            }
+
+            return RPS_OK;
+        }
+
+    private:
+        Arena                                   m_arena;
+        ArenaVector<ResourceAliasingInfo>       m_aliasingInfos;
+        ArenaVector<Span<ResourceAliasingInfo>> m_cmdAliasingInfos;
+        CacheInputs                             m_inputs;
+        bool                                    m_bValid = false;
+    };
+}  // namespace rps
+
+#endif  //RPS_MEMORY_PLACEMENT_CACHE_HPP
@@ -0,0 +1,89 @@
+// Copyright (c) 2024 Advanced Micro Devices, Inc.
+//
+// This file is part of the AMD Render Pipeline Shaders SDK which is
+// released under the MIT LICENSE.
+//
+// See file LICENSE.txt for full license details.
+
+#ifndef RPS_MEMORY_PLACEMENT_STRATEGY_HPP
+#define RPS_MEMORY_PLACEMENT_STRATEGY_HPP
+
+#include "runtime/common/rps_render_graph.hpp"
+
+#include <algorithm>
+
+namespace rps
+{
+    // Fit used to search the heaps of each memory type for a free range. RPS_MEMORY_PLACEMENT_MIN_MEMORY starts out
+    // with best fit, the trial placements may then select first fit per memory type.
+    class MemoryTypeFitStrategies
+    {
+    public:
+        RpsResult Init(Arena& arena, RpsMemoryPlacementStrategy placementStrategy, uint32_t numMemoryTypes)
+        {
+            m_fitStrategies = arena.NewArray<RpsMemoryPlacementStrategy>(numMemoryTypes);
+            RPS_CHECK_ALLOC((numMemoryTypes == 0) || !m_fitStrategies.empty());
+
+            std::fill(m_fitStrategies.begin(),
+                      m_fitStrategies.end(),
+                      (placementStrategy == RPS_MEMORY_PLACEMENT_FIRST_FIT) ? RPS_MEMORY_PLACEMENT_FIRST_FIT
+                                                                           : RPS_MEMORY_PLACEMENT_BEST_FIT);
+
+            return RPS_OK;
+        }
+
+        RpsMemoryPlacementStrategy Get(uint32_t memTypeIndex) const
+        {
+            return m_fitStrategies[memTypeIndex];
+        }
+
+        void Set(uint32_t memTypeIndex, RpsMemoryPlacementStrategy fitStrategy)
+        {
+            m_fitStrategies[memTypeIndex] = fitStrategy;
+        }
+
+        // Candidates at or below this fitness end the search. First fit takes any range the resource fits in, best
+        // fit keeps looking for a perfect fit.
+        uint64_t GetAcceptedFitness(uint32_t memTypeIndex) const
+        {
+            return (m_fitStrategies[memTypeIndex] == RPS_MEMORY_PLACEMENT_FIRST_FIT) ? (UINT64_MAX - 1) : 0;
+        }
+
+    private:
+        ArrayRef<RpsMemoryPlacementStrategy> m_fitStrategies;
+    };
+
+    // Takes [spaceBegin, spaceEnd) of the heap as the placement candidate if memRequirement fits in it with less space
+    // left over than the current candidate. Smaller fitness is better.
+    static inline void CheckReusableSpaceInHeap(uint64_t                      spaceBegin,
+                                                uint64_t                      spaceEnd,
+                                                const RpsGpuMemoryRequirement memRequirement,
+                                                const HeapInfo&               heapInfo,
+                                                uint64_t*                     pFitness,
+                                                RpsHeapPlacement*             pCandidate)
+    {
+        if ((heapInfo.hRuntimeHeap) && (heapInfo.alignment < memRequirement.alignment))
+        {
+            // Fail if runtime heap already exists but heap alignment is smaller than resource required alignment.
+            return;
+        }
+
+        uint64_t newRangeEnd = spaceBegin + memRequirement.size;
+
+        // Check if requiredSize can fit the space:
+        if (newRangeEnd <= spaceEnd)
+        {
+            uint64_t newFitness = spaceEnd - newRangeEnd;
+
+            if (newFitness < *pFitness)
+            {
+                pCandidate->heapId = heapInfo.index;
+                pCandidate->offset = spaceBegin;
+
+                *pFitness = newFitness;
+            }
+        }
+    }
+}  // namespace rps
+
+#endif  //RPS_MEMORY_PLACEMENT_STRATEGY_HPP
@@ -0,0 +1,222 @@
+// Copyright (c) 2024 Advanced Micro Devices, Inc.
+//
+// This file is part of the AMD Render Pipeline Shaders SDK which is
+// released under the MIT LICENSE.
+//
+// See file LICENSE.txt for full license details.
+
+#ifndef RPS_MEMORY_PLACEMENT_TRIALS_HPP
+#define RPS_MEMORY_PLACEMENT_TRIALS_HPP
+
+#include "runtime/common/rps_memory_placement_strategy.hpp"
+
+#include <algorithm>
+
+namespace rps
+{
+    enum class PlacementOrder
+    {
+        Size,            // Size descending. Same as the order sorted by CalculateResourcePlacements.
+        Area,            // Size * lifetime length descending.
+        LifetimeLength,  // Lifetime length descending.
+        LifetimeBegin,   // Lifetime begin ascending.
+        Count,
+    };
+
+    static inline bool PlacementOrderLess(PlacementOrder          order,
+                                          const ResourceInstance& resA,
+                                          const ResourceInstance& resB)
+    {
+        const uint64_t sizeA =
+            rpsAlignUp(resA.allocRequirement.size, uint64_t(rpsMax(1u, resA.allocRequirement.alignment)));
+        const uint64_t sizeB =
+            rpsAlignUp(resB.allocRequirement.size, uint64_t(rpsMax(1u, resB.allocRequirement.alignment)));
+
+        const uint64_t lengthA = uint64_t(resA.lifetimeEnd - resA.lifetimeBegin) + 1;
+        const uint64_t lengthB = uint64_t(resB.lifetimeEnd - resB.lifetimeBegin) + 1;
+
+        switch (order)
+        {
+        case PlacementOrder::Area:
+            if ((sizeA * lengthA) != (sizeB * lengthB))
+                return (sizeA * lengthA) > (sizeB * lengthB);
+            break;
+        case PlacementOrder::LifetimeLength:
+            if (lengthA != lengthB)
+                return lengthA > lengthB;
+            break;
+        case PlacementOrder::LifetimeBegin:
+            if (resA.lifetimeBegin != resB.lifetimeBegin)
+                return resA.lifetimeBegin < resB.lifetimeBegin;
+            break;
+        default:
+            break;
+        }
+
+        if (sizeA != sizeB)
+            return sizeA > sizeB;
+
+        return resA.lifetimeBegin < resB.lifetimeBegin;
+    }
+
+    // Returns the end of the run of sortedResourceIndices starting at rangeBegin that share its memory type.
+    static inline size_t FindMemoryTypeRangeEnd(ConstArrayRef<ResourceInstance> resourceInstances,
+                                                ConstArrayRef<uint32_t>         sortedResourceIndices,
+                                                size_t                          rangeBegin)
+    {
+        const uint32_t memType = resourceInstances[sortedResourceIndices[rangeBegin]].allocRequirement.memoryTypeIndex;
+
+        size_t rangeEnd = rangeBegin + 1;
+
+        while ((rangeEnd < sortedResourceIndices.size()) &&
+               (resourceInstances[sortedResourceIndices[rangeEnd]].allocRequirement.memoryTypeIndex == memType))
+        {
+            rangeEnd++;
+        }
+
+        return rangeEnd;
+    }
+
+    // Heaps, placements and pending creation flags saved before a trial placement, so it can be undone.
+    class PlacementSnapshot
+    {
+    public:
+        PlacementSnapshot(Arena* pArena)
+            : m_heaps(pArena)
+            , m_placements(pArena)
+            , m_pendingCreates(pArena)
+        {
+        }
+
+        RpsResult Save(const ArenaVector<HeapInfo>&    heaps,
+                       ConstArrayRef<ResourceInstance> resourceInstances,
+                       ConstArrayRef<uint32_t>         resIndices)
+        {
+            RPS_CHECK_ALLOC(m_heaps.resize(heaps.size()));
+            std::copy(heaps.begin(), heaps.end(), m_heaps.begin());
+
+            RPS_CHECK_ALLOC(m_placements.resize(resIndices.size()));
+            RPS_CHECK_ALLOC(m_pendingCreates.resize(resIndices.size()));
+
+            for (size_t i = 0; i < resIndices.size(); i++)
+            {
+                m_placements[i]     = resourceInstances[resIndices[i]].allocPlacement;
+                m_pendingCreates[i] = resourceInstances[resIndices[i]].isPendingCreate;
+            }
+
+            return RPS_OK;
+        }
+
+        RpsResult Restore(ArenaVector<HeapInfo>&     heaps,
+                          ArrayRef<ResourceInstance> resourceInstances,
+                          ConstArrayRef<uint32_t>    resIndices) const
+        {
+            RPS_RETURN_ERROR_IF(resIndices.size() != m_placements.size(), RPS_ERROR_INTERNAL_ERROR);
+
+            RPS_CHECK_ALLOC(heaps.resize(m_heaps.size()));
+            std::copy(m_heaps.begin(), m_heaps.end(), heaps.begin());
+
+            for (size_t i = 0; i < resIndices.size(); i++)
+            {
+                resourceInstances[resIndices[i]].allocPlacement  = m_placements[i];
+                resourceInstances[resIndices[i]].isPendingCreate = m_pendingCreates[i];
+            }
+
+            return RPS_OK;
+        }
+
+    private:
+        ArenaVector<HeapInfo>         m_heaps;
+        ArenaVector<RpsHeapPlacement> m_placements;
+        ArenaVector<bool>             m_pendingCreates;
+    };
+
+    // For each memory type placed from scratch, packs its resources in every PlacementOrder with both best fit and
+    // first fit, then reorders sortedResourceIndices and selects the fit using the least heap memory. Heaps and
+    // placements are restored after each trial, the actual placement is done by the caller.
+    // fnPlaceMemoryType(memTypeIndex, resIndices) places resIndices, all of memTypeIndex, in order.
+    template <typename TPlaceMemoryTypeFunc>
+    RpsResult SelectMinMemoryPlacementOrders(Arena&                     scratchArena,
+                                             ArenaVector<HeapInfo>&     heaps,
+                                             ArrayRef<ResourceInstance> resourceInstances,
+                                             ArrayRef<uint32_t>         sortedResourceIndices,
+                                             MemoryTypeFitStrategies&   fitStrategies,
+                                             TPlaceMemoryTypeFunc       fnPlaceMemoryType)
+    {
+        ArenaCheckPoint arenaCheckpoint{scratchArena};
+
+        PlacementSnapshot     snapshot(&scratchArena);
+        ArenaVector<uint32_t> trialIndices(&scratchArena);
+        ArenaVector<uint32_t> bestIndices(&scratchArena);
+
+        for (size_t rangeBegin = 0, rangeEnd = 0; rangeBegin < sortedResourceIndices.size(); rangeBegin = rangeEnd)
+        {
+            rangeEnd = FindMemoryTypeRangeEnd(resourceInstances, sortedResourceIndices, rangeBegin);
+
+            const auto&    firstRes = resourceInstances[sortedResourceIndices[rangeBegin]];
+            const uint32_t memType  = firstRes.allocRequirement.memoryTypeIndex;
+
+            // Pre-allocated resources are sorted first. Skip the memory type if any placement is held, packing is
+            // only redone when the whole memory type is placed from scratch.
+            if (!firstRes.isPendingCreate || ((rangeEnd - rangeBegin) < 2))
+            {
+                continue;
+            }
+
+            auto range = sortedResourceIndices.range(rangeBegin, rangeEnd - rangeBegin);
+
+            RPS_V_RETURN(snapshot.Save(heaps, resourceInstances, range));
+
+            static constexpr RpsMemoryPlacementStrategy fitStrategyTrials[] = {RPS_MEMORY_PLACEMENT_BEST_FIT,
+                                                                               RPS_MEMORY_PLACEMENT_FIRST_FIT};
+
+            uint64_t                   bestHeapUsage   = UINT64_MAX;
+            RpsMemoryPlacementStrategy bestFitStrategy = RPS_MEMORY_PLACEMENT_BEST_FIT;
+
+            for (uint32_t iTrial = 0; iTrial < uint32_t(PlacementOrder::Count) * RPS_COUNTOF(fitStrategyTrials);
+                 iTrial++)
+            {
+                const PlacementOrder order = PlacementOrder(iTrial / RPS_COUNTOF(fitStrategyTrials));
+
+                fitStrategies.Set(memType, fitStrategyTrials[iTrial % RPS_COUNTOF(fitStrategyTrials)]);
+
+                RPS_CHECK_ALLOC(trialIndices.resize(range.size()));
+                std::copy(range.begin(), range.end(), trialIndices.begin());
+
+                if (order != PlacementOrder::Size)
+                {
+                    std::sort(trialIndices.begin(), trialIndices.end(), [&](uint32_t a, uint32_t b) {
+                        return PlacementOrderLess(order, resourceInstances[a], resourceInstances[b]);
+                    });
+                }
+
+                RPS_V_RETURN(fnPlaceMemoryType(memType, trialIndices.crange_all()));
+
+                uint64_t heapUsage = 0;
+                for (const auto& heap : heaps)
+                {
+                    heapUsage += (heap.memTypeIndex == memType) ? heap.usedSize : 0;
+                }
+
+                if (heapUsage < bestHeapUsage)
+                {
+                    bestHeapUsage   = heapUsage;
+                    bestFitStrategy = fitStrategies.Get(memType);
+                    RPS_CHECK_ALLOC(bestIndices.resize(trialIndices.size()));
+                    std::copy(trialIndices.begin(), trialIndices.end(), bestIndices.begin());
+                }
+
+                // Restore heaps and placements for the next trial.
+                RPS_V_RETURN(snapshot.Restore(heaps, resourceInstances, range));
+            }
+
+            std::copy(bestIndices.begin(), bestIndices.end(), range.begin());
+
+            fitStrategies.Set(memType, bestFitStrategy);
+        }
+
+        return RPS_OK;
+    }
+}  // namespace rps
+
+#endif  //RPS_MEMORY_PLACEMENT_TRIALS_HPP
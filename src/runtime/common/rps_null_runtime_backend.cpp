@@ -15,7 +15,7 @@ namespace rps
     {
         for (HeapInfo& heapInfo : heaps)
         {
-            if (heapInfo.hRuntimeHeap == RPS_NULL_HANDLE)
+            if ((heapInfo.hRuntimeHeap == RPS_NULL_HANDLE) && (heapInfo.memTypeIndex != UINT32_MAX))
             {
                 //Set dummy heap handle
                 ++m_heapCounter;
@@ -12,6 +12,8 @@
 #include "runtime/common/rps_rpsl_host.hpp"
 #include "runtime/common/rps_subprogram.hpp"
 
+#include <thread>
+
 namespace rps
 {
     RpsResult RenderGraph::Create(Device&                         device,
@@ -20,6 +22,10 @@ namespace rps
     {
         RPS_CHECK_ARGS(ppRenderGraph);
         RPS_CHECK_ARGS(!pCreateInfo || ((pCreateInfo->numPhases == 0) == (pCreateInfo->pPhases == nullptr)));
+        RPS_CHECK_ARGS(!pCreateInfo || !pCreateInfo->taskSystem.pfnEnqueueJob || pCreateInfo->taskSystem.pfnWaitJob);
+        RPS_CHECK_ARGS(!pCreateInfo || (pCreateInfo->memoryInfo.placementStrategy < RPS_MEMORY_PLACEMENT_COUNT));
+        RPS_CHECK_ARGS(!pCreateInfo || (pCreateInfo->memoryInfo.numHeaps == 0) ||
+                       (pCreateInfo->memoryInfo.heapBudgetMiBs != nullptr));
 
         auto allocInfo = AllocInfo::FromType<RenderGraph>();
 
@@ -51,9 +57,10 @@ namespace rps
             RPS_V_RETURN((*ppRenderGraph)->AddPhase<NullRuntimeBackend>(**ppRenderGraph));
         }
 
-        // TODO: Apply user settings
         (*ppRenderGraph)->m_memoryTypes = pRuntimeDevice->GetMemoryTypeInfos();
 
+        RPS_V_RETURN((*ppRenderGraph)->ApplyMemoryTypeSettings());
+
         return RPS_OK;
     }
 
@@ -73,19 +80,26 @@ namespace rps
         , m_createInfo(createInfo)
         , m_persistentArena(device.Allocator())
         , m_frameArena(device.Allocator())
+        , m_concurrentFrameArena(device.Allocator())
         , m_scratchArena(device.Allocator())
-        , m_graph(device, m_frameArena)
+        , m_structureArena(device.Allocator())
+        , m_graph(device, m_structureArena)
+        , m_structureInputs(&m_structureArena)
+        , m_structuralResStates(0, &m_structureArena)
+        , m_structuralAccessDiscardFlags(0, &m_structureArena)
         , m_phases(0, &m_persistentArena)
         , m_resourceCache(0, &m_persistentArena)
         , m_programInstances(0, &m_persistentArena)
         , m_cmds(0, &m_frameArena)
         , m_cmdAccesses(0, &m_frameArena)
-        , m_transitions(0, &m_frameArena)
+        , m_cmdTimeEstimates(0, &m_frameArena)
+        , m_transitions(0, &m_structureArena)
         , m_resourceFinalAccesses(0, &m_persistentArena)
-        , m_runtimeCmdInfos(0, &m_frameArena)
-        , m_cmdBatches(0, &m_frameArena)
-        , m_cmdBatchWaitFenceIds(0, &m_frameArena)
-        , m_aliasingInfos(0, &m_frameArena)
+        , m_subResourceLifetimes(0, &m_persistentArena)
+        , m_runtimeCmdInfos(0, &m_structureArena)
+        , m_cmdBatches(0, &m_structureArena)
+        , m_cmdBatchWaitFenceIds(0, &m_structureArena)
+        , m_aliasingInfos(0, &m_structureArena)
         , m_heaps(0, &m_persistentArena)
         , m_resourceClearValues(&m_persistentArena)
         , m_builder(*this, m_persistentArena, m_frameArena)
@@ -98,6 +112,30 @@ namespace rps
         m_diagData.heapInfos.reset(&m_diagInfoArena);
     }
 
+    RpsResult RenderGraph::ApplyMemoryTypeSettings()
+    {
+        const uint64_t defaultHeapSize = m_createInfo.memoryInfo.defaultHeapSize;
+
+        if ((defaultHeapSize == 0) || m_memoryTypes.empty())
+        {
+            return RPS_OK;
+        }
+
+        auto memoryTypesCopy = m_persistentArena.NewArray<RpsMemoryTypeInfo>(m_memoryTypes.size());
+        RPS_CHECK_ALLOC(!memoryTypesCopy.empty());
+
+        std::copy(m_memoryTypes.begin(), m_memoryTypes.end(), memoryTypesCopy.begin());
+
+        for (auto& memTypeInfo : memoryTypesCopy)
+        {
+            memTypeInfo.defaultHeapSize = defaultHeapSize;
+        }
+
+        m_memoryTypes = memoryTypesCopy;
+
+        return RPS_OK;
+    }
+
     RpsResult RenderGraph::OnInit(const RpsRenderGraphCreateInfo& createInfo)
     {
         RPS_ASSERT(m_pMainEntry == nullptr);
@@ -115,6 +153,17 @@ namespace rps
                       queueInfosCopy.begin());
         }
 
+        if (createInfo.memoryInfo.numHeaps > 0)
+        {
+            auto heapBudgetsCopy = m_persistentArena.NewArray<uint32_t>(createInfo.memoryInfo.numHeaps);
+            RPS_CHECK_ALLOC(!heapBudgetsCopy.empty());
+
+            m_createInfo.memoryInfo.heapBudgetMiBs = heapBudgetsCopy.data();
+            std::copy(createInfo.memoryInfo.heapBudgetMiBs,
+                      createInfo.memoryInfo.heapBudgetMiBs + createInfo.memoryInfo.numHeaps,
+                      heapBudgetsCopy.begin());
+        }
+
         RPS_V_RETURN(Subprogram::Create(m_device, &createInfo.mainEntryCreateInfo, &m_pMainEntry));
 
         m_pSignature = m_pMainEntry->GetSignature();
@@ -174,18 +223,13 @@ namespace rps
     RpsResult RenderGraph::UpdateImpl(const RpsRenderGraphUpdateInfo& updateInfo)
     {
         m_frameArena.Reset();
+        m_concurrentFrameArena.Reset();
         m_cmds.reset_keep_capacity(&m_frameArena);
         m_cmdAccesses.reset_keep_capacity(&m_frameArena);
-        m_transitions.reset_keep_capacity(&m_frameArena);
-        m_runtimeCmdInfos.reset_keep_capacity(&m_frameArena);
-        m_cmdBatches.reset_keep_capacity(&m_frameArena);
-        m_cmdBatchWaitFenceIds.reset_keep_capacity(&m_frameArena);
-        m_aliasingInfos.reset_keep_capacity(&m_frameArena);
+        m_cmdTimeEstimates.reset_keep_capacity(&m_frameArena);
 
         ArenaCheckPoint arenaCheckpoint{m_scratchArena};
 
-        m_graph.Reset();
-
         const RenderGraphSignature* const pSignature = m_pMainEntry->GetSignature();
 
         ArrayRef<RpsVariable, uint32_t> paramPtrs =
@@ -227,17 +271,356 @@ namespace rps
             RPS_V_RETURN(m_builder.End());
         }
 
+        RPS_V_RETURN(GatherCmdTimeEstimates(updateInfo));
+
+        // Randomized schedules are expected to differ every update, never reuse them.
+        const bool bIncrementalUpdate =
+            rpsAnyBitsSet(m_createInfo.renderGraphFlags, RPS_RENDER_GRAPH_INCREMENTAL_UPDATE) &&
+            !rpsAnyBitsSet(updateInfo.scheduleFlags | m_createInfo.scheduleInfo.scheduleFlags,
+                           RPS_SCHEDULE_RANDOM_ORDER_BIT);
+
+        CacheInputs structureInputs(&m_frameArena);
+
+        if (bIncrementalUpdate)
+        {
+            GatherStructureInputs(structureInputs, updateInfo);
+            RPS_CHECK_ALLOC(structureInputs.IsValid());
+        }
+
+        const bool bReuseStructure =
+            bIncrementalUpdate && m_bStructureInputsValid && (structureInputs == m_structureInputs);
+
+        m_bStructureReused = bReuseStructure;
+
+        if (!bReuseStructure)
+        {
+            m_bStructureInputsValid = false;
+
+            m_structureArena.Reset();
+            m_structureInputs.Reset(&m_structureArena);
+            m_transitions.reset_keep_capacity(&m_structureArena);
+            m_runtimeCmdInfos.reset_keep_capacity(&m_structureArena);
+            m_cmdBatches.reset_keep_capacity(&m_structureArena);
+            m_cmdBatchWaitFenceIds.reset_keep_capacity(&m_structureArena);
+            m_aliasingInfos.reset_keep_capacity(&m_structureArena);
+            m_structuralResStates.reset_keep_capacity(&m_structureArena);
+            m_structuralAccessDiscardFlags.reset_keep_capacity(&m_structureArena);
+
+            // Edge lists only need to be pooled while the graph is built, see Graph::Freeze.
+            m_graph.Reset(m_frameArena);
+        }
+
         RenderGraphUpdateContext updateContext = {
-            &updateInfo, *this, RuntimeDevice::Get(m_device), m_frameArena, m_scratchArena};
+            &updateInfo, *this, RuntimeDevice::Get(m_device), m_frameArena, m_scratchArena, false, false, 0, 0};
+
+        RpsRenderGraphUpdateInfo memorySavingUpdateInfo = {};
+
+        // Access flags before lifetime analysis adds discard flags to them, restored when rescheduling so the next
+        // analysis doesn't see discard flags derived from the previous schedule.
+        ArrayRef<RpsAccessFlags> accessFlagsBeforeSchedule;
+
+        auto fnSaveAccessFlags = [&]() {
+            RPS_RETURN_OK_IF(!accessFlagsBeforeSchedule.empty() || m_cmdAccesses.empty());
+
+            accessFlagsBeforeSchedule = m_scratchArena.NewArray<RpsAccessFlags>(m_cmdAccesses.size());
+            RPS_CHECK_ALLOC(!accessFlagsBeforeSchedule.empty());
+
+            for (size_t iAccess = 0; iAccess < m_cmdAccesses.size(); iAccess++)
+            {
+                accessFlagsBeforeSchedule[iAccess] = m_cmdAccesses[iAccess].access.accessFlags;
+            }
+
+            return RPS_OK;
+        };
+
+        auto fnRestoreAccessFlags = [&]() {
+            for (size_t iAccess = 0; iAccess < accessFlagsBeforeSchedule.size(); iAccess++)
+            {
+                m_cmdAccesses[iAccess].access.accessFlags = accessFlagsBeforeSchedule[iAccess];
+            }
+        };
 
-        for (auto& phase : m_phases)
+        bool     bStructuralStatesRestored   = false;
+        bool     bRescheduled                = false;
+        bool     bRescheduledForMemorySaving = false;
+        uint32_t schedulePhaseIndex          = RPS_INDEX_NONE_U32;
+
+        for (uint32_t iPhase = 0; iPhase < m_phases.size(); iPhase++)
         {
-            RPS_V_RETURN(phase->Run(updateContext));
+            IRenderGraphPhase* const pPhase = m_phases[iPhase];
+
+            if (pPhase->IsSchedulePhase() && (schedulePhaseIndex == RPS_INDEX_NONE_U32))
+            {
+                schedulePhaseIndex = iPhase;
+            }
+
+            if (bReuseStructure && !bRescheduled && pPhase->IsStructuralPhase())
+            {
+                if (!bStructuralStatesRestored)
+                {
+                    RPS_V_RETURN(fnSaveAccessFlags());
+                    RestoreStructuralResourceStates();
+                    bStructuralStatesRestored = true;
+                }
+                continue;
+            }
+
+            if (iPhase == schedulePhaseIndex)
+            {
+                RPS_V_RETURN(fnSaveAccessFlags());
+            }
+
+            RPS_V_RETURN(pPhase->Run(updateContext));
+
+            // A phase found the schedule exceeds the memory budget. Schedule once more preferring memory saving and
+            // run the following phases again on the new schedule.
+            if (updateContext.bRescheduleForMemorySaving)
+            {
+                RPS_RETURN_ERROR_IF(bRescheduledForMemorySaving || (schedulePhaseIndex == RPS_INDEX_NONE_U32),
+                                    RPS_ERROR_OUT_OF_MEMORY);
+
+                const RpsScheduleFlags scheduleFlags = (updateInfo.scheduleFlags != RPS_SCHEDULE_UNSPECIFIED)
+                                                           ? updateInfo.scheduleFlags
+                                                           : m_createInfo.scheduleInfo.scheduleFlags;
+
+                memorySavingUpdateInfo               = updateInfo;
+                memorySavingUpdateInfo.scheduleFlags = scheduleFlags | RPS_SCHEDULE_PREFER_MEMORY_SAVING_BIT;
+
+                updateContext.pUpdateInfo                = &memorySavingUpdateInfo;
+                updateContext.bRescheduleForMemorySaving = false;
+
+                bRescheduledForMemorySaving = true;
+                bRescheduled                = true;
+                iPhase                      = schedulePhaseIndex - 1;
+
+                fnRestoreAccessFlags();
+            }
+            else if (updateContext.bRescheduleForMemoryFeedback)
+            {
+                // The phase requesting it bounds the number of iterations.
+                RPS_RETURN_ERROR_IF(schedulePhaseIndex == RPS_INDEX_NONE_U32, RPS_ERROR_INTERNAL_ERROR);
+
+                updateContext.bRescheduleForMemoryFeedback = false;
+                updateContext.memoryFeedbackIteration++;
+
+                bRescheduled = true;
+                iPhase       = schedulePhaseIndex - 1;
+
+                fnRestoreAccessFlags();
+            }
+        }
+
+        m_numSchedulesComputed = updateContext.numSchedulesComputed;
+
+        // The frame arena is reset before the structure is reused.
+        if (!bReuseStructure && !m_graph.IsFrozen())
+        {
+            RPS_V_RETURN(m_graph.Freeze());
+        }
+
+        if (bIncrementalUpdate && !bReuseStructure)
+        {
+            RPS_V_RETURN(CacheStructuralResourceStates());
+
+            RPS_CHECK_ALLOC(m_structureInputs.CopyFrom(structureInputs));
+            m_bStructureInputsValid = true;
+        }
+
+        return RPS_OK;
+    }
+
+    RpsResult RenderGraph::GatherCmdTimeEstimates(const RpsRenderGraphUpdateInfo& updateInfo)
+    {
+        const RpsNodeTimeEstimator* pEstimator = updateInfo.pNodeTimeEstimator;
+
+        RPS_RETURN_OK_IF(!pEstimator);
+        RPS_CHECK_ARGS(pEstimator->pfnEstimateNodeTime);
+
+        RPS_CHECK_ALLOC(m_cmdTimeEstimates.resize(m_cmds.size(), 0.0f));
+
+        for (uint32_t cmdId = 0, numCmds = uint32_t(m_cmds.size()); cmdId < numCmds; cmdId++)
+        {
+            const CmdInfo& cmdInfo = m_cmds[cmdId];
+
+            if (cmdInfo.IsNodeDeclBuiltIn() || !cmdInfo.pNodeDecl)
+                continue;
+
+            const float estimate =
+                pEstimator->pfnEstimateNodeTime(pEstimator->pContext, cmdId, cmdInfo.pNodeDecl->name.str);
+
+            // Also catches NaN.
+            m_cmdTimeEstimates[cmdId] = (estimate > 0.0f) ? estimate : 0.0f;
         }
 
         return RPS_OK;
     }
 
+    void RenderGraph::GatherStructureInputs(CacheInputs& inputs, const RpsRenderGraphUpdateInfo& updateInfo) const
+    {
+        inputs.Add(updateInfo.scheduleFlags);
+        inputs.Add(updateInfo.diagnosticFlags);
+        inputs.Add(IsMemoryAliasingEnabled(updateInfo));
+        inputs.Add(uint32_t(m_cmds.size()));
+
+        // Commands and the arguments which determine their accesses.
+        for (const CmdInfo& cmdInfo : m_cmds)
+        {
+            inputs.Add(cmdInfo.nodeDeclIndex);
+
+            if (cmdInfo.nodeDeclIndex == uint32_t(RPS_BUILTIN_NODE_SUBGRAPH_BEGIN))
+            {
+                inputs.Add(cmdInfo.subgraphFlags);
+            }
+            else
+            {
+                inputs.Add(bool(cmdInfo.bPreferAsync));
+            }
+
+            if (!cmdInfo.pNodeDecl || !cmdInfo.pCmdDecl)
+                continue;
+
+            const auto nodeParams = cmdInfo.pNodeDecl->params;
+            const auto args       = cmdInfo.pCmdDecl->args;
+
+            for (uint32_t iParam = 0, numParams = uint32_t(rpsMin(nodeParams.size(), args.size())); iParam < numParams;
+                 iParam++)
+            {
+                const auto& paramDecl = nodeParams[iParam];
+
+                if (paramDecl.access.accessFlags == RPS_ACCESS_UNKNOWN)
+                    continue;
+
+                inputs.Add(paramDecl.access);
+
+                if (args[iParam])
+                {
+                    inputs.AddBytes(args[iParam], paramDecl.GetSize());
+                }
+                else
+                {
+                    inputs.Add(0u);
+                }
+            }
+        }
+
+        // Time estimates only steer the scheduler, but a schedule based on stale estimates must not be reused.
+        inputs.Add(uint32_t(m_cmdTimeEstimates.size()));
+        inputs.AddBytes(m_cmdTimeEstimates.data(), m_cmdTimeEstimates.size() * sizeof(float));
+
+        for (const NodeDependency& dep : m_builder.GetExplicitDependencies())
+        {
+            inputs.Add(dep);
+        }
+
+        const auto resDecls = m_builder.GetResourceDecls();
+        inputs.Add(uint32_t(resDecls.size()));
+
+        for (const ResourceDecl& resDecl : resDecls)
+        {
+            if (resDecl.desc)
+            {
+                inputs.Add(ResourceDescPacked(*static_cast<const ResourceDesc*>(resDecl.desc)));
+            }
+            else
+            {
+                inputs.Add(0u);
+            }
+        }
+
+        // Resource states carried over from the previous update, which feed into the structural phases.
+        inputs.Add(uint32_t(m_resourceCache.size()));
+
+        for (const ResourceInstance& resInstance : m_resourceCache)
+        {
+            inputs.Add(resInstance.desc);
+            inputs.Add(resInstance.allAccesses);
+            inputs.Add(resInstance.prevFinalAccess);
+            inputs.Add(resInstance.temporalLayerOffset);
+            inputs.Add(uint32_t((resInstance.isExternal ? 1u : 0u) | (resInstance.isPendingCreate ? 2u : 0u)));
+
+            // The active temporal slice rotates every frame, so are the transitions referring to it.
+            if (resInstance.IsTemporalParent())
+            {
+                inputs.Add(updateInfo.frameIndex % resInstance.desc.temporalLayers);
+            }
+        }
+    }
+
+    RpsResult RenderGraph::CacheStructuralResourceStates()
+    {
+        RPS_CHECK_ALLOC(m_structuralResStates.resize(m_resourceCache.size()));
+
+        for (uint32_t iRes = 0, numRes = uint32_t(m_resourceCache.size()); iRes < numRes; iRes++)
+        {
+            m_structuralResStates[iRes].initialAccess = m_resourceCache[iRes].initialAccess;
+            m_structuralResStates[iRes].finalAccesses = m_resourceCache[iRes].finalAccesses;
+        }
+
+        static constexpr RpsAccessFlags DiscardAccessFlags =
+            RPS_ACCESS_DISCARD_DATA_BEFORE_BIT | RPS_ACCESS_DISCARD_DATA_AFTER_BIT |
+            RPS_ACCESS_STENCIL_DISCARD_DATA_BEFORE_BIT | RPS_ACCESS_STENCIL_DISCARD_DATA_AFTER_BIT;
+
+        // Lifetime analysis adds discard flags to the accesses, which are rebuilt every frame.
+        RPS_CHECK_ALLOC(m_structuralAccessDiscardFlags.resize(m_cmdAccesses.size()));
+
+        for (uint32_t iAccess = 0, numAccesses = uint32_t(m_cmdAccesses.size()); iAccess < numAccesses; iAccess++)
+        {
+            m_structuralAccessDiscardFlags[iAccess] = m_cmdAccesses[iAccess].access.accessFlags & DiscardAccessFlags;
+        }
+
+        return RPS_OK;
+    }
+
+    void RenderGraph::RestoreStructuralResourceStates()
+    {
+        RPS_ASSERT(m_structuralResStates.size() == m_resourceCache.size());
+
+        for (uint32_t iRes = 0, numRes = uint32_t(m_resourceCache.size()); iRes < numRes; iRes++)
+        {
+            m_resourceCache[iRes].SetInitialAccess(m_structuralResStates[iRes].initialAccess);
+            m_resourceCache[iRes].finalAccesses = m_structuralResStates[iRes].finalAccesses;
+        }
+
+        // Same structure inputs imply the same command accesses in the same order.
+        RPS_ASSERT(m_structuralAccessDiscardFlags.size() == m_cmdAccesses.size());
+
+        for (uint32_t iAccess = 0, numAccesses = uint32_t(m_cmdAccesses.size()); iAccess < numAccesses; iAccess++)
+        {
+            m_cmdAccesses[iAccess].access.accessFlags |= m_structuralAccessDiscardFlags[iAccess];
+        }
+
+        // View infos of the reused transitions point to builder data of a previous frame.
+        for (auto& transition : m_transitions)
+        {
+            transition.access.pViewInfo = nullptr;
+        }
+    }
+
+    uint32_t RenderGraph::GetNumParallelTasks(uint32_t numItems, uint32_t minItemsPerTask) const
+    {
+        const RpsTaskSystem& taskSystem = m_createInfo.taskSystem;
+
+        if (!taskSystem.pfnEnqueueJob)
+        {
+            return 1;
+        }
+
+        const uint32_t numWorkerThreads =
+            (taskSystem.numWorkerThreads > 0) ? taskSystem.numWorkerThreads : std::thread::hardware_concurrency();
+
+        return rpsMax(1u, rpsMin(numWorkerThreads, numItems / rpsMax(1u, minItemsPerTask)));
+    }
+
+    void RenderGraph::RunParallelJob(PFN_rpsTask pfnTask, void* pTaskContext, uint32_t numTasks) const
+    {
+        const RpsTaskSystem& taskSystem = m_createInfo.taskSystem;
+
+        RPS_ASSERT(taskSystem.pfnEnqueueJob && taskSystem.pfnWaitJob);
+
+        void* hJob = taskSystem.pfnEnqueueJob(taskSystem.pUserContext, pfnTask, pTaskContext, numTasks);
+        taskSystem.pfnWaitJob(taskSystem.pUserContext, hJob);
+    }
+
     RpsResult RenderGraph::RecordCommands(const RpsRenderGraphRecordCommandInfo& recordInfo) const
     {
         RPS_RETURN_ERROR_IF(RPS_FAILED(m_status), RPS_ERROR_INVALID_OPERATION);
@@ -245,6 +628,128 @@ namespace rps
         return m_pBackend->RecordCommands(*this, recordInfo);
     }
 
+    RpsResult RenderGraph::Execute(const RpsRenderGraphExecuteInfo& executeInfo)
+    {
+        RPS_RETURN_ERROR_IF(RPS_FAILED(m_status), RPS_ERROR_INVALID_OPERATION);
+
+        ArenaCheckPoint arenaCheckpoint{m_scratchArena};
+
+        struct RecordJob
+        {
+            uint32_t cmdBegin;
+            uint32_t numCmds;
+        };
+
+        const uint32_t minCostPerCmdBuffer = rpsMax(1u, executeInfo.minRecordCostPerCmdBuffer);
+
+        // Transitions and the pre/postamble are cheap to record compared to node callbacks.
+        auto fnGetCmdCost = [&](const RuntimeCmdInfo& runtimeCmdInfo) -> uint32_t {
+            if (runtimeCmdInfo.isTransition || (runtimeCmdInfo.cmdId >= m_cmds.size()))
+            {
+                return 0;
+            }
+
+            return executeInfo.pfnGetCmdRecordCostCb
+                       ? executeInfo.pfnGetCmdRecordCostCb(executeInfo.pUserContext, runtimeCmdInfo.cmdId)
+                       : 1;
+        };
+
+        ArenaVector<RecordJob>               jobs(&m_scratchArena);
+        ArenaVector<RpsRuntimeCommandBuffer> jobCmdBufs(&m_scratchArena);
+        ArenaVector<uint32_t>                batchJobOffsets(&m_scratchArena);
+        ArenaVector<uint32_t>                cmdCosts(&m_scratchArena);
+
+        RPS_CHECK_ALLOC(batchJobOffsets.reserve(m_cmdBatches.size() + 1));
+
+        // Split each batch into jobs of roughly equal recording cost.
+        for (const RpsCommandBatch& batch : m_cmdBatches)
+        {
+            const uint32_t jobOffset = uint32_t(jobs.size());
+            batchJobOffsets.push_back(jobOffset);
+
+            RPS_CHECK_ALLOC(cmdCosts.resize(batch.numCmds));
+
+            uint64_t totalCost = 0;
+
+            for (uint32_t iCmd = 0; iCmd < batch.numCmds; iCmd++)
+            {
+                cmdCosts[iCmd] = fnGetCmdCost(m_runtimeCmdInfos[batch.cmdBegin + iCmd]);
+                totalCost += cmdCosts[iCmd];
+            }
+
+            if (batch.numCmds == 0)
+            {
+                continue;
+            }
+
+            const uint32_t numJobs =
+                GetNumParallelTasks(uint32_t(rpsMin(totalCost, uint64_t(UINT32_MAX))), minCostPerCmdBuffer);
+
+            uint32_t jobCmdBegin = 0;
+            uint64_t accumCost   = 0;
+
+            for (uint32_t iCmd = 0; iCmd < batch.numCmds; iCmd++)
+            {
+                accumCost += cmdCosts[iCmd];
+
+                const uint32_t numJobsDone      = uint32_t(jobs.size()) - jobOffset;
+                const uint64_t jobCostThreshold = totalCost * (numJobsDone + 1) / numJobs;
+
+                const bool bIsLastCmd = (iCmd + 1 == batch.numCmds);
+
+                if (bIsLastCmd || ((numJobsDone + 1 < numJobs) && (accumCost >= jobCostThreshold)))
+                {
+                    RPS_CHECK_ALLOC(jobs.push_back({batch.cmdBegin + jobCmdBegin, iCmd + 1 - jobCmdBegin}));
+                    jobCmdBegin = iCmd + 1;
+                }
+            }
+
+            const uint32_t numBatchJobs = uint32_t(jobs.size()) - jobOffset;
+
+            RpsRuntimeCommandBuffer* pCmdBufs = jobCmdBufs.grow(numBatchJobs);
+            RPS_CHECK_ALLOC(pCmdBufs);
+
+            RPS_V_RETURN(executeInfo.pfnAcquireRuntimeCmdBufCb(
+                executeInfo.pUserContext, batch.queueIndex, numBatchJobs, pCmdBufs));
+        }
+
+        batchJobOffsets.push_back(uint32_t(jobs.size()));
+
+        RPS_V_RETURN(ParallelFor(uint32_t(jobs.size()), 1, [&](uint32_t jobBegin, uint32_t jobEnd) {
+            for (uint32_t iJob = jobBegin; iJob < jobEnd; iJob++)
+            {
+                RpsRenderGraphRecordCommandInfo recordInfo = {};
+                recordInfo.hCmdBuffer                      = jobCmdBufs[iJob];
+                recordInfo.pUserContext                    = executeInfo.pUserContext;
+                recordInfo.frameIndex                      = executeInfo.frameIndex;
+                recordInfo.cmdBeginIndex                   = jobs[iJob].cmdBegin;
+                recordInfo.numCmds                         = jobs[iJob].numCmds;
+                recordInfo.flags                           = executeInfo.recordFlags;
+
+                RPS_V_RETURN(m_pBackend->RecordCommands(*this, recordInfo));
+            }
+            return RPS_OK;
+        }));
+
+        for (uint32_t iBatch = 0, numBatches = uint32_t(m_cmdBatches.size()); iBatch < numBatches; iBatch++)
+        {
+            const RpsCommandBatch& batch      = m_cmdBatches[iBatch];
+            const uint32_t         jobOffset  = batchJobOffsets[iBatch];
+            const uint32_t         numCmdBufs = batchJobOffsets[iBatch + 1] - jobOffset;
+
+            RPS_V_RETURN(executeInfo.pfnSubmitRuntimeCmdBufCb(
+                executeInfo.pUserContext,
+                batch.queueIndex,
+                numCmdBufs ? &jobCmdBufs[jobOffset] : nullptr,
+                numCmdBufs,
+                batch.numWaitFences ? &m_cmdBatchWaitFenceIds[batch.waitFencesBegin] : nullptr,
+                batch.numWaitFences,
+                batch.signalFenceIndex));
+        }
+
+        return RPS_OK;
+    }
+
     RpsResult RenderGraph::GetDiagnosticInfo(RpsRenderGraphDiagnosticInfo&     diagInfos,
                                              RpsRenderGraphDiagnosticInfoFlags diagnosticFlags)
     {
@@ -258,12 +763,14 @@ namespace rps
             RPS_V_RETURN(UpdateDiagCache());
         }
 
-        diagInfos.numResourceInfos   = uint32_t(m_diagData.resourceInfos.size());
-        diagInfos.numHeapInfos       = uint32_t(m_diagData.heapInfos.size());
-        diagInfos.numCommandInfos    = uint32_t(m_diagData.cmdInfos.size());
-        diagInfos.pResourceDiagInfos = m_diagData.resourceInfos.data();
-        diagInfos.pCmdDiagInfos      = m_diagData.cmdInfos.data();
-        diagInfos.pHeapDiagInfos     = m_diagData.heapInfos.data();
+        diagInfos.numResourceInfos     = uint32_t(m_diagData.resourceInfos.size());
+        diagInfos.numHeapInfos         = uint32_t(m_diagData.heapInfos.size());
+        diagInfos.numCommandInfos      = uint32_t(m_diagData.cmdInfos.size());
+        diagInfos.pResourceDiagInfos   = m_diagData.resourceInfos.data();
+        diagInfos.pCmdDiagInfos        = m_diagData.cmdInfos.data();
+        diagInfos.pHeapDiagInfos       = m_diagData.heapInfos.data();
+        diagInfos.isStructureReused    = m_bStructureReused;
+        diagInfos.numSchedulesComputed = m_numSchedulesComputed;
 
         return RPS_OK;
     }
@@ -372,6 +879,7 @@ RpsResult rpsRenderGraphUpdate(RpsRenderGraph hRenderGraph, const RpsRenderGraph
     RPS_CHECK_ARGS(hRenderGraph != RPS_NULL_HANDLE);
     RPS_CHECK_ARGS(pUpdateInfo != nullptr);
     RPS_CHECK_ARGS((pUpdateInfo->gpuCompletedFrameIndex + 1) <= pUpdateInfo->frameIndex);
+    RPS_CHECK_ARGS(pUpdateInfo->memoryAliasingMode < RPS_MEMORY_ALIASING_MODE_COUNT);
 
     auto pRenderGraph = rps::FromHandle(hRenderGraph);
 
@@ -428,6 +936,15 @@ RpsResult rpsRenderGraphRecordCommands(RpsRenderGraph hRenderGraph, const RpsRen
     return rps::FromHandle(hRenderGraph)->RecordCommands(*pRecordRange);
 }
 
+RpsResult rpsRenderGraphExecute(RpsRenderGraph hRenderGraph, const RpsRenderGraphExecuteInfo* pExecuteInfo)
+{
+    RPS_CHECK_ARGS(hRenderGraph != RPS_NULL_HANDLE);
+    RPS_CHECK_ARGS(pExecuteInfo != nullptr);
+    RPS_CHECK_ARGS(pExecuteInfo->pfnAcquireRuntimeCmdBufCb && pExecuteInfo->pfnSubmitRuntimeCmdBufCb);
+
+    return rps::FromHandle(hRenderGraph)->Execute(*pExecuteInfo);
+}
+
 RpsResult rpsRenderGraphGetDiagnosticInfo(RpsRenderGraph                    hRenderGraph,
                                           RpsRenderGraphDiagnosticInfo*     pInfo,
                                           RpsRenderGraphDiagnosticInfoFlags diagnosticFlags)
@@ -487,6 +1004,17 @@ RpsResult rpsCmdGetNodeName(const RpsCmdCallbackContext* pContext, const char**
     return RPS_OK;
 }
 
+RpsResult rpsCmdGetNodeId(const RpsCmdCallbackContext* pContext, RpsNodeId* pNodeId)
+{
+    RPS_CHECK_ARGS(pContext && pNodeId);
+
+    auto pBackendContext = rps::RuntimeCmdCallbackContext::Get(pContext);
+
+    *pNodeId = pBackendContext->cmdId;
+
+    return RPS_OK;
+}
+
 RpsResult rpsCmdGetParamDesc(const RpsCmdCallbackContext* pContext, RpsParamId paramId, RpsParameterDesc* pDesc)
 {
     RPS_CHECK_ARGS(pContext && pDesc);
@@ -21,6 +21,8 @@
 #include "runtime/common/rps_render_graph_builder.hpp"
 #include "runtime/common/rps_subprogram.hpp"
 
+#include <atomic>
+
 namespace rps
 {
     class RenderGraph;
@@ -47,30 +49,33 @@ namespace rps
 
     struct ResourceInstance
     {
-        uint32_t                resourceDeclId      = RPS_INDEX_NONE_U32;
-        uint32_t                temporalLayerOffset = RPS_INDEX_NONE_U32;
-        ResourceDescPacked      desc                = {};
-        SubresourceRangePacked  fullSubresourceRange;
-        uint32_t                numSubResources = 0;
-        uint32_t                clearValueId    = RPS_INDEX_NONE_U32;
-        AccessAttr              allAccesses     = {};
-        AccessAttr              initialAccess   = {};
-        AccessAttr              prevFinalAccess = {};
-        Span<FinalAccessInfo>   finalAccesses   = {};
-        uint32_t                lifetimeBegin   = UINT32_MAX;
-        uint32_t                lifetimeEnd     = UINT32_MAX;
-        bool                    isTemporalSlice : 1;
-        bool                    isFirstTemporalSlice : 1;
-        bool                    isExternal : 1;
-        bool                    isAliased : 1;
-        bool                    isPendingCreate : 1;
-        bool                    isPendingInit : 1;
-        bool                    isMutableFormat : 1;
-        bool                    bBufferFormattedWrite : 1;
-        bool                    bBufferFormattedRead : 1;
-        RpsGpuMemoryRequirement allocRequirement = {0, 0, RPS_INDEX_NONE_U32};
-        RpsHeapPlacement        allocPlacement   = {RPS_INDEX_NONE_U32, 0};
-        RpsRuntimeResource      hRuntimeResource = {};
+        uint32_t                     resourceDeclId      = RPS_INDEX_NONE_U32;
+        uint32_t                     temporalLayerOffset = RPS_INDEX_NONE_U32;
+        ResourceDescPacked           desc                = {};
+        SubresourceRangePacked       fullSubresourceRange;
+        uint32_t                     numSubResources      = 0;
+        uint32_t                     clearValueId         = RPS_INDEX_NONE_U32;
+        AccessAttr                   allAccesses          = {};
+        AccessAttr                   initialAccess        = {};
+        AccessAttr                   prevFinalAccess      = {};
+        Span<FinalAccessInfo>        finalAccesses        = {};
+        uint32_t                     lifetimeBegin        = UINT32_MAX;
+        uint32_t                     lifetimeEnd          = UINT32_MAX;
+        Span<RpsSubresourceLifetime> subResourceLifetimes = {};
+        uint32_t                     memoryFeedbackWeight = 1;
+        bool                         isTemporalSlice : 1;
+        bool                         isFirstTemporalSlice : 1;
+        bool                         isExternal : 1;
+        bool                         isAliased : 1;
+        bool                         isPendingCreate : 1;
+        bool                         isPendingInit : 1;
+        bool                         isPendingAllocInfo : 1;
+        bool                         isMutableFormat : 1;
+        bool                         bBufferFormattedWrite : 1;
+        bool                         bBufferFormattedRead : 1;
+        RpsGpuMemoryRequirement      allocRequirement = {0, 0, RPS_INDEX_NONE_U32};
+        RpsHeapPlacement             allocPlacement   = {RPS_INDEX_NONE_U32, 0};
+        RpsRuntimeResource           hRuntimeResource = {};
 
         static constexpr uint32_t LIFETIME_UNDEFINED = UINT32_MAX;
 
@@ -81,6 +86,7 @@ namespace rps
             , isAliased(false)
             , isPendingCreate(false)
             , isPendingInit(false)
+            , isPendingAllocInfo(true)
             , isMutableFormat(false)
             , bBufferFormattedWrite(false)
             , bBufferFormattedRead(false)
@@ -229,6 +235,14 @@ namespace rps
         RuntimeDevice*                  pRuntimeDevice;
         Arena&                          frameArena;
         Arena&                          scratchArena;
+        // Set by a phase to request the update to be scheduled again with RPS_SCHEDULE_PREFER_MEMORY_SAVING_BIT.
+        bool                            bRescheduleForMemorySaving;
+        // Set by a phase to request the update to be scheduled again with the updated memory feedback weights.
+        bool                            bRescheduleForMemoryFeedback;
+        // Number of times the update was scheduled again for memory feedback.
+        uint32_t                        memoryFeedbackIteration;
+        // Number of schedules computed, not replayed, by the schedule phase in this update.
+        uint32_t                        numSchedulesComputed;
     };
 
     static constexpr uint32_t CMD_ID_PREAMBLE  = 0x7FFFFFFE;
@@ -239,6 +253,10 @@ namespace rps
         uint32_t                   cmdId : 31;
         uint32_t                   isTransition : 1;
         Span<ResourceAliasingInfo> aliasingInfos = {};
+        // A split transition is issued twice with the same transition id: the begin half right after the last
+        // previous access of the subresource, and the end half right before the next access.
+        uint32_t                   isSplitBarrierBegin : 1;
+        uint32_t                   isSplitBarrierEnd : 1;
 
         RuntimeCmdInfo()
             : RuntimeCmdInfo(0, false)
@@ -248,6 +266,8 @@ namespace rps
         RuntimeCmdInfo(uint32_t inCmdId, bool inIsTransition)
             : cmdId(inCmdId)
             , isTransition(inIsTransition ? 1 : 0)
+            , isSplitBarrierBegin(0)
+            , isSplitBarrierEnd(0)
         {
         }
 
@@ -314,6 +334,19 @@ namespace rps
             return nullptr;
         }
 
+        // Returns true if the phase output only depends on the render graph structure, i.e. the phase can be
+        // skipped and its previous output reused when the structure didn't change since the last update.
+        virtual bool IsStructuralPhase() const
+        {
+            return false;
+        }
+
+        // Returns true if the phase schedules the commands. Phases requesting a reschedule are run again from here.
+        virtual bool IsSchedulePhase() const
+        {
+            return false;
+        }
+
         void Destroy()
         {
             OnDestroy();
@@ -381,6 +414,9 @@ namespace rps
 
         virtual void DestroyRuntimeResourceDeferred(ResourceInstance& resource) = 0;
 
+        // Destroys the runtime heap and marks the heap info as unused. The caller must ensure the GPU is done with it.
+        void ReleaseHeap(HeapInfo& heap);
+
         RenderGraph& GetRenderGraph() const
         {
             return m_renderGraph;
@@ -580,6 +616,8 @@ namespace rps
 
         RpsResult RecordCommands(const RpsRenderGraphRecordCommandInfo& recordInfo) const;
 
+        RpsResult Execute(const RpsRenderGraphExecuteInfo& executeInfo);
+
         RpsResult GetDiagnosticInfo(RpsRenderGraphDiagnosticInfo& diagInfos, RpsRenderGraphDiagnosticInfoFlags diagnosticFlags);
 
         static constexpr uint32_t INVALID_TRANSITION = 0;
@@ -593,10 +631,20 @@ namespace rps
 
         RpsResult OnInit(const RpsRenderGraphCreateInfo& createInfo);
 
+        RpsResult ApplyMemoryTypeSettings();
+
         void OnDestroy();
 
         RpsResult UpdateImpl(const RpsRenderGraphUpdateInfo& buildInfo);
 
+        void GatherStructureInputs(CacheInputs& inputs, const RpsRenderGraphUpdateInfo& updateInfo) const;
+
+        RpsResult GatherCmdTimeEstimates(const RpsRenderGraphUpdateInfo& updateInfo);
+
+        RpsResult CacheStructuralResourceStates();
+
+        void RestoreStructuralResourceStates();
+
         RpsResult UpdateDiagCache();
 
         RpsResult AllocateDiagnosticInfo();
@@ -611,6 +659,10 @@ namespace rps
 
         void GatherHeapDiagnosticInfo(RpsHeapDiagnosticInfo& dst, const rps::HeapInfo& src);
 
+        uint32_t GetNumParallelTasks(uint32_t numItems, uint32_t minItemsPerTask) const;
+
+        void RunParallelJob(PFN_rpsTask pfnTask, void* pTaskContext, uint32_t numTasks) const;
+
     public:
 
         const Device& GetDevice() const
@@ -623,6 +675,47 @@ namespace rps
             return m_createInfo;
         }
 
+        // Calls fnRange(begin, end) for ranges covering [0, numItems), each containing at least minItemsPerTask
+        // items. Ranges run in parallel on the task system if one was provided at creation, otherwise fnRange is
+        // called once for the whole range on the current thread.
+        // Returns the first failure result of fnRange, or RPS_OK.
+        template <typename TFunc>
+        RpsResult ParallelFor(uint32_t numItems, uint32_t minItemsPerTask, TFunc&& fnRange) const
+        {
+            const uint32_t numTasks = GetNumParallelTasks(numItems, minItemsPerTask);
+
+            if (numTasks <= 1)
+            {
+                return fnRange(0u, numItems);
+            }
+
+            struct ParallelForJob
+            {
+                typename std::remove_reference<TFunc>::type* pFnRange;
+                uint32_t                                       numItems;
+                uint32_t                                       numTasks;
+                std::atomic<RpsResult>                         result;
+            } job = {&fnRange, numItems, numTasks, {RPS_OK}};
+
+            RunParallelJob(
+                [](void* pTaskContext, uint32_t taskIndex) {
+                    auto&          job   = *static_cast<ParallelForJob*>(pTaskContext);
+                    const uint32_t begin = uint32_t(uint64_t(job.numItems) * taskIndex / job.numTasks);
+                    const uint32_t end   = uint32_t(uint64_t(job.numItems) * (taskIndex + 1) / job.numTasks);
+
+                    const RpsResult taskResult = (*job.pFnRange)(begin, end);
+                    if (RPS_FAILED(taskResult))
+                    {
+                        RpsResult expected = RPS_OK;
+                        job.result.compare_exchange_strong(expected, taskResult);
+                    }
+                },
+                &job,
+                numTasks);
+
+            return job.result.load();
+        }
+
         Subprogram* GetMainEntry() const
         {
             return m_pMainEntry;
@@ -693,6 +786,16 @@ namespace rps
             return m_resourceFinalAccesses;
         }
 
+        ArenaVector<RpsSubresourceLifetime>& GetSubResourceLifetimes()
+        {
+            return m_subResourceLifetimes;
+        }
+
+        const ArenaVector<RpsSubresourceLifetime>& GetSubResourceLifetimes() const
+        {
+            return m_subResourceLifetimes;
+        }
+
         ArenaVector<HeapInfo>& GetHeapInfos()
         {
             return m_heaps;
@@ -718,6 +821,32 @@ namespace rps
             return m_cmds;
         }
 
+        // Per cmd GPU time estimates of the current update, empty if no estimator was provided.
+        ConstArrayRef<float> GetCmdTimeEstimates() const
+        {
+            return m_cmdTimeEstimates.range_all();
+        }
+
+        // Number of memory feedback iterations applied to the schedule, see
+        // RpsRenderGraphCreateInfo::scheduleInfo.numMemoryFeedbackIterations.
+        uint32_t GetMemoryFeedbackLevel() const
+        {
+            return m_memoryFeedbackLevel;
+        }
+
+        void SetMemoryFeedbackLevel(uint32_t level)
+        {
+            m_memoryFeedbackLevel = level;
+        }
+
+        // Whether GPU memory is aliased in an update, see RpsRenderGraphUpdateInfo::memoryAliasingMode.
+        bool IsMemoryAliasingEnabled(const RpsRenderGraphUpdateInfo& updateInfo) const
+        {
+            return (updateInfo.memoryAliasingMode == RPS_MEMORY_ALIASING_DEFAULT)
+                       ? !rpsAnyBitsSet(m_createInfo.renderGraphFlags, RPS_RENDER_GRAPH_NO_GPU_MEMORY_ALIASING)
+                       : (updateInfo.memoryAliasingMode == RPS_MEMORY_ALIASING_ENABLED);
+        }
+
         ArenaVector<CmdAccessInfo>& GetCmdAccessInfos()
         {
             return m_cmdAccesses;
@@ -850,10 +979,11 @@ namespace rps
             return m_pBackend;
         }
 
+        // Frame lifetime allocation which is safe to call from multiple recording threads concurrently.
         template<typename T>
-        T* FrameAlloc()
+        T* ConcurrentFrameAlloc()
         {
-            return static_cast<T*>(m_frameArena.AlignedAlloc(sizeof(T), alignof(T)));
+            return m_concurrentFrameArena.New<T>();
         }
 
         static AccessAttr CalcPreviousAccess(uint32_t                      prevTransitionId,
@@ -893,22 +1023,42 @@ namespace rps
         RpsRenderGraphCreateInfo m_createInfo;
         Arena                    m_persistentArena;
         Arena                    m_frameArena;
+        ConcurrentArena          m_concurrentFrameArena;
         Arena                    m_scratchArena;
+        Arena                    m_structureArena;
         Graph                    m_graph;
         RpsResult                m_status = RPS_OK;
 
+        // Resource states written by structural phases, restored when those phases are skipped.
+        struct StructuralResourceState
+        {
+            AccessAttr            initialAccess;
+            Span<FinalAccessInfo> finalAccesses;
+        };
+
+        CacheInputs                          m_structureInputs;
+        bool                                 m_bStructureInputsValid = false;
+        bool                                 m_bStructureReused      = false;
+        uint32_t                             m_numSchedulesComputed  = 0;
+        ArenaVector<StructuralResourceState> m_structuralResStates;
+        ArenaVector<RpsAccessFlags>          m_structuralAccessDiscardFlags;  // Per m_cmdAccesses element.
+
         const RenderGraphSignature* m_pSignature = nullptr;
         Subprogram*                 m_pMainEntry = nullptr;
 
         ConstArrayRef<RpsMemoryTypeInfo> m_memoryTypes;
 
-        ArenaVector<IRenderGraphPhase*> m_phases;
-        ArenaVector<ResourceInstance>   m_resourceCache;
-        ArenaVector<ProgramInstance*>   m_programInstances;
-        ArenaVector<CmdInfo>            m_cmds;
-        ArenaVector<CmdAccessInfo>      m_cmdAccesses;
-        ArenaVector<TransitionInfo>     m_transitions;
-        ArenaVector<FinalAccessInfo>    m_resourceFinalAccesses;
+        uint32_t m_memoryFeedbackLevel = 0;
+
+        ArenaVector<IRenderGraphPhase*>     m_phases;
+        ArenaVector<ResourceInstance>       m_resourceCache;
+        ArenaVector<ProgramInstance*>       m_programInstances;
+        ArenaVector<CmdInfo>                m_cmds;
+        ArenaVector<CmdAccessInfo>          m_cmdAccesses;
+        ArenaVector<float>                  m_cmdTimeEstimates;
+        ArenaVector<TransitionInfo>         m_transitions;
+        ArenaVector<FinalAccessInfo>        m_resourceFinalAccesses;
+        ArenaVector<RpsSubresourceLifetime> m_subResourceLifetimes;
 
         RuntimeBackend* m_pBackend = nullptr;
 
@@ -29,6 +29,13 @@ namespace rps
         dst.allocRequirement = src.allocRequirement;
         dst.allocPlacement   = src.allocPlacement;
         dst.hRuntimeResource = src.hRuntimeResource;
+
+        const auto subResLifetimes = src.subResourceLifetimes.Get(m_subResourceLifetimes);
+        const auto dstLifetimes    = m_diagInfoArena.NewArray<RpsSubresourceLifetime>(subResLifetimes.size());
+        std::copy_n(subResLifetimes.begin(), dstLifetimes.size(), dstLifetimes.begin());
+
+        dst.numSubresourceLifetimes = uint32_t(dstLifetimes.size());
+        dst.pSubresourceLifetimes   = dstLifetimes.empty() ? nullptr : dstLifetimes.data();
     }
 
     void RenderGraph::GatherCmdDiagnosticInfo(RpsCmdDiagnosticInfo& dst, const RuntimeCmdInfo& src, uint32_t cmdIndex)
@@ -50,6 +57,8 @@ namespace rps
             dst.transition.nextAccess = transInfo.access.access;
             transInfo.access.range.Get(dst.transition.range);
             dst.transition.resourceIndex = transInfo.access.resourceId;
+            dst.transition.isSplitBegin  = src.isSplitBarrierBegin;
+            dst.transition.isSplitEnd    = src.isSplitBarrierEnd;
         }
     }
 
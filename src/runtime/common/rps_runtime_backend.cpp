@@ -81,12 +81,25 @@ namespace rps
         DestroyHeaps(m_renderGraph.GetHeapInfos().range_all());
     }
 
+    void RuntimeBackend::ReleaseHeap(HeapInfo& heap)
+    {
+        DestroyHeaps({&heap, 1});
+
+        const uint32_t heapIndex = heap.index;
+
+        heap              = {};
+        heap.memTypeIndex = UINT32_MAX;
+        heap.index        = heapIndex;
+    }
+
     RpsResult RuntimeBackend::CloneContext(const RuntimeCmdCallbackContext& context,
                                            RpsRuntimeCommandBuffer          hNewCmdBuffer,
                                            const RpsCmdCallbackContext**    ppNewContext) const
     {
-        auto pNewContext = m_renderGraph.FrameAlloc<RuntimeCmdCallbackContext>();
-        *pNewContext     = context;
+        auto pNewContext = m_renderGraph.ConcurrentFrameAlloc<RuntimeCmdCallbackContext>();
+        RPS_CHECK_ALLOC(pNewContext);
+
+        *pNewContext = context;
 
         pNewContext->hCommandBuffer    = hNewCmdBuffer;
         pNewContext->bIsPrimaryContext = false;
@@ -97,6 +97,13 @@ namespace rps
             return RPS_IMAGE_ASPECT_UNKNOWN;
         }
 
+        // If the backend can't issue the begin and end halves of a split barrier separately, transitions are not split
+        // even with RPS_SCHEDULE_ALLOW_SPLIT_BARRIERS_BIT.
+        virtual bool SupportsSplitBarriers() const
+        {
+            return true;
+        }
+
         virtual void PrepareRenderGraphCreation(RpsRenderGraphCreateInfo& renderGraphCreateInfo) const
         {
             //Memory aliasing always requires lifetime analysis
@@ -0,0 +1,176 @@
+// Copyright (c) 2024 Advanced Micro Devices, Inc.
+//
+// This file is part of the AMD Render Pipeline Shaders SDK which is
+// released under the MIT LICENSE.
+//
+// See file LICENSE.txt for full license details.
+
+#ifndef RPS_SMALL_RESOURCE_POOL_HPP
+#define RPS_SMALL_RESOURCE_POOL_HPP
+
+#include "runtime/common/rps_memory_placement_strategy.hpp"
+
+#include <algorithm>
+
+namespace rps
+{
+    // Resources smaller than a page are sub-allocated from pages held for the whole frame, instead of each taking a
+    // heap range of its own. This keeps them out of the ranges larger resources alias in, and packs them tightly.
+    // Within a page, resources with disjoint lifetimes alias. A pool holds the pages of the memory type being placed.
+    class SmallResourcePool
+    {
+    public:
+        static constexpr uint64_t PAGE_SIZE = 64 * 1024;
+
+        SmallResourcePool(Arena* pArena)
+            : m_pages(pArena)
+            , m_nextResidents(pArena)
+            , m_overlaps(pArena)
+        {
+        }
+
+        static bool IsSmallResource(const RpsGpuMemoryRequirement& memRequirement)
+        {
+            return (memRequirement.size < PAGE_SIZE) && (memRequirement.alignment < PAGE_SIZE);
+        }
+
+        uint32_t GetNumPages() const
+        {
+            return uint32_t(m_pages.size());
+        }
+
+        const RpsHeapPlacement& GetPagePlacement(uint32_t pageIndex) const
+        {
+            return m_pages[pageIndex].placement;
+        }
+
+        // Returns the index of the page at pageOffset in the heap, or RPS_INDEX_NONE_U32.
+        uint32_t FindPage(uint32_t heapIndex, uint64_t pageOffset) const
+        {
+            auto pageIter = std::find_if(m_pages.begin(), m_pages.end(), [&](const Page& page) {
+                return (page.placement.heapId == heapIndex) && (page.placement.offset == pageOffset);
+            });
+
+            return (pageIter != m_pages.end()) ? uint32_t(pageIter - m_pages.begin()) : RPS_INDEX_NONE_U32;
+        }
+
+        bool AddPage(const RpsHeapPlacement& placement)
+        {
+            return m_pages.push_back({placement, RPS_INDEX_NONE_U32});
+        }
+
+        bool AddResident(uint32_t pageIndex, uint32_t resIndex)
+        {
+            if ((resIndex >= m_nextResidents.size()) && !m_nextResidents.resize(resIndex + 1, RPS_INDEX_NONE_U32))
+            {
+                return false;
+            }
+
+            auto& page = m_pages[pageIndex];
+
+            m_nextResidents[resIndex] = page.firstResident;
+            page.firstResident        = resIndex;
+
+            return true;
+        }
+
+        // Returns true if a resident of the page overlaps the placement of currRes during its lifetime. Without
+        // aliasing, all residents are live at the same time.
+        bool HasResidentOverlap(uint32_t                        pageIndex,
+                                ConstArrayRef<ResourceInstance> resourceInstances,
+                                const ResourceInstance&         currRes,
+                                bool                            bUseAliasing) const
+        {
+            const uint64_t resEnd = currRes.allocPlacement.offset + currRes.allocRequirement.size;
+
+            for (uint32_t iResident = m_pages[pageIndex].firstResident; iResident != RPS_INDEX_NONE_U32;
+                 iResident          = m_nextResidents[iResident])
+            {
+                const auto& resident = resourceInstances[iResident];
+
+                const bool bLifetimeOverlap = !bUseAliasing || ((resident.lifetimeBegin <= currRes.lifetimeEnd) &&
+                                                                (currRes.lifetimeBegin <= resident.lifetimeEnd));
+
+                if (bLifetimeOverlap && (currRes.allocPlacement.offset < (resident.allocPlacement.offset +
+                                                                          resident.allocRequirement.size)) &&
+                    (resident.allocPlacement.offset < resEnd))
+                {
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+        // Searches the page for a range free during the lifetime of currRes, see CheckReusableSpaceInHeap.
+        void FindSpaceInPage(uint32_t                        pageIndex,
+                             ConstArrayRef<ResourceInstance> resourceInstances,
+                             const HeapInfo&                 heap,
+                             const ResourceInstance&         currRes,
+                             bool                            bUseAliasing,
+                             uint64_t*                       pFitness,
+                             RpsHeapPlacement*               pCandidate)
+        {
+            const auto& page = m_pages[pageIndex];
+
+            m_overlaps.clear();
+
+            for (uint32_t iResident = page.firstResident; iResident != RPS_INDEX_NONE_U32;
+                 iResident          = m_nextResidents[iResident])
+            {
+                const auto& resident = resourceInstances[iResident];
+
+                const bool bLifetimeOverlap = (resident.lifetimeBegin <= currRes.lifetimeEnd) &&
+                                              (currRes.lifetimeBegin <= resident.lifetimeEnd);
+
+                if (!bUseAliasing || bLifetimeOverlap)
+                {
+                    m_overlaps.push_back(iResident);
+                }
+            }
+
+            std::sort(m_overlaps.begin(), m_overlaps.end(), [&](uint32_t a, uint32_t b) {
+                return resourceInstances[a].allocPlacement.offset < resourceInstances[b].allocPlacement.offset;
+            });
+
+            const uint64_t pageEnd = page.placement.offset + PAGE_SIZE;
+
+            uint64_t prevRangeEndAligned = page.placement.offset;
+
+            for (uint32_t iResident : m_overlaps)
+            {
+                const auto& resident = resourceInstances[iResident];
+
+                if (prevRangeEndAligned < resident.allocPlacement.offset)
+                {
+                    CheckReusableSpaceInHeap(prevRangeEndAligned,
+                                             resident.allocPlacement.offset,
+                                             currRes.allocRequirement,
+                                             heap,
+                                             pFitness,
+                                             pCandidate);
+                }
+
+                prevRangeEndAligned =
+                    rpsMax(prevRangeEndAligned,
+                           rpsAlignUp(resident.allocPlacement.offset + resident.allocRequirement.size,
+                                      uint64_t(currRes.allocRequirement.alignment)));
+            }
+
+            CheckReusableSpaceInHeap(prevRangeEndAligned, pageEnd, currRes.allocRequirement, heap, pFitness, pCandidate);
+        }
+
+    private:
+        struct Page
+        {
+            RpsHeapPlacement placement;
+            uint32_t         firstResident;
+        };
+
+        ArenaVector<Page>     m_pages;
+        ArenaVector<uint32_t> m_nextResidents;  // Next resident in the same page, per resource instance.
+        ArenaVector<uint32_t> m_overlaps;
+    };
+}  // namespace rps
+
+#endif  //RPS_SMALL_RESOURCE_POOL_HPP
@@ -192,7 +192,8 @@ namespace rps
                                       prevAccess,
                                       currTrans.access.access,
                                       resInstance,
-                                      currTrans.access.range);
+                                      currTrans.access.range,
+                                      GetSplitBarrierFlags(cmd));
                     }
                 }
                 else if (cmd.cmdId == CMD_ID_POSTAMBLE)
@@ -243,7 +244,8 @@ namespace rps
                               prevAccess,
                               currTrans.access.access,
                               resInstance,
-                              currTrans.access.range);
+                              currTrans.access.range,
+                              GetSplitBarrierFlags(cmd));
             }
 
             currBatch.lateBarriers.SetEnd(uint32_t(m_barriers.size()));
@@ -416,11 +418,19 @@ namespace rps
         }
 
     private:
+        static D3D12_RESOURCE_BARRIER_FLAGS GetSplitBarrierFlags(const RuntimeCmdInfo& cmd)
+        {
+            return cmd.isSplitBarrierBegin ? D3D12_RESOURCE_BARRIER_FLAG_BEGIN_ONLY
+                                           : (cmd.isSplitBarrierEnd ? D3D12_RESOURCE_BARRIER_FLAG_END_ONLY
+                                                                    : D3D12_RESOURCE_BARRIER_FLAG_NONE);
+        }
+
         void AppendBarrier(ID3D12Resource*              pResource,
                            const RpsAccessAttr&         prevAccess,
                            const RpsAccessAttr&         currAccess,
                            const ResourceInstance&      resInfo,
-                           const SubresourceRangePacked range)
+                           const SubresourceRangePacked range,
+                           D3D12_RESOURCE_BARRIER_FLAGS splitFlags = D3D12_RESOURCE_BARRIER_FLAG_NONE)
         {
             auto stateBefore = CalcD3D12State(prevAccess);
             auto stateAfter  = CalcD3D12State(currAccess);
@@ -437,7 +447,7 @@ namespace rps
                 auto* pBarriers = m_barriers.grow(isFullRes ? 1 : range.GetNumSubresources());
 
                 pBarriers[0].Type                   = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
-                pBarriers[0].Flags                  = D3D12_RESOURCE_BARRIER_FLAG_NONE;
+                pBarriers[0].Flags                  = splitFlags;
                 pBarriers[0].Transition.pResource   = pResource;
                 pBarriers[0].Transition.StateBefore = stateBefore;
                 pBarriers[0].Transition.StateAfter  = stateAfter;
@@ -474,8 +484,10 @@ namespace rps
                 }
             }
             else if ((stateBefore == D3D12_RESOURCE_STATE_UNORDERED_ACCESS) &&
-                     (stateAfter == D3D12_RESOURCE_STATE_UNORDERED_ACCESS))
+                     (stateAfter == D3D12_RESOURCE_STATE_UNORDERED_ACCESS) &&
+                     (splitFlags != D3D12_RESOURCE_BARRIER_FLAG_BEGIN_ONLY))
             {
+                // UAV barriers can't be split, issue them at the end of the split.
                 auto* pBarrier = m_barriers.grow(1);
 
                 pBarrier->Type          = D3D12_RESOURCE_BARRIER_TYPE_UAV;
@@ -101,7 +101,13 @@ namespace rps
                     const auto prevAccess =
                         RenderGraph::CalcPreviousAccess(currTrans.prevTransition, transitions, resInstance);
 
-                    AppendBarrier(resInstance, prevAccess, currTrans.access.access, false, currTrans.access.range);
+                    AppendBarrier(resInstance,
+                                  prevAccess,
+                                  currTrans.access.access,
+                                  false,
+                                  currTrans.access.range,
+                                  cmd.isSplitBarrierBegin,
+                                  cmd.isSplitBarrierEnd);
                 }
                 else if (cmd.cmdId == CMD_ID_POSTAMBLE)
                 {
@@ -126,7 +132,7 @@ namespace rps
                                               // TODO: For non-external resource, set no access/sync + initial layout?
                                               resInstance.initialAccess,
                                               false,
-                                              transitions[finalAccess.prevTransition].access.range);
+                                              finalAccess.range);
                             }
                         }
                     }
@@ -587,7 +593,9 @@ namespace rps
                            const RpsAccessAttr&         prevAccess,
                            const RpsAccessAttr&         currAccess,
                            bool                         bDiscard,
-                           const SubresourceRangePacked range)
+                           const SubresourceRangePacked range,
+                           bool                         bSplitBegin = false,
+                           bool                         bSplitEnd   = false)
         {
             // TODO: Make a texture-only version of CalcD3D12AccessInfo
             auto beforeAccessInfo = CalcD3D12AccessInfo(prevAccess);
@@ -613,6 +621,16 @@ namespace rps
                 return;
             }
 
+            // Both halves of a split barrier keep the same access and layout, only the sync scopes are split.
+            if (bSplitBegin)
+            {
+                afterAccessInfo.sync = D3D12_BARRIER_SYNC_SPLIT;
+            }
+            else if (bSplitEnd)
+            {
+                beforeAccessInfo.sync = D3D12_BARRIER_SYNC_SPLIT;
+            }
+
             if (resInfo.desc.IsImage())
             {
                 D3D12_TEXTURE_BARRIER* pBarrier = m_textureBarriers.grow(1);
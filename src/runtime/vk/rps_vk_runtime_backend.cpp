@@ -946,6 +946,9 @@ namespace rps
             RPS_VK_API_CALL(vkCreateBufferView(device.GetVkDevice(), &vkCreateInfo, nullptr, &dstBufView)));
     }
 
+    // Minimum number of views created by a single task when a task system is available.
+    static constexpr uint32_t MinViewsPerTask = 64;
+
     RpsResult VKRuntimeBackend::CreateImageViews(const RenderGraphUpdateContext& context,
                                                  ConstArrayRef<uint32_t>         accessIndices)
     {
@@ -959,27 +962,30 @@ namespace rps
 
         RPS_CHECK_ALLOC(currResources.imageViews.resize(accessIndices.size()));
 
-        uint32_t imgViewIndex = 0;
-        VkImage  hImage       = VK_NULL_HANDLE;
+        // Each view only writes its own slots, so views can be created in parallel.
+        return context.renderGraph.ParallelFor(
+            uint32_t(accessIndices.size()), MinViewsPerTask, [&](uint32_t viewBegin, uint32_t viewEnd) {
+                VkImage hImage = VK_NULL_HANDLE;
 
-        for (auto accessIndex : accessIndices)
-        {
-            auto& access = cmdAccesses[accessIndex];
+                for (uint32_t imgViewIndex = viewBegin; imgViewIndex < viewEnd; imgViewIndex++)
+                {
+                    const uint32_t accessIndex = accessIndices[imgViewIndex];
 
-            const auto& resource = resourceInstances[access.resourceId];
-            FromHandle(hImage, resource.hRuntimeResource);
+                    auto& access = cmdAccesses[accessIndex];
 
-            m_imageViewLayouts[imgViewIndex] = GetTrackedImageLayoutInfo(resource, access);
+                    const auto& resource = resourceInstances[access.resourceId];
+                    FromHandle(hImage, resource.hRuntimeResource);
 
-            VkImageView& hImgView = currResources.imageViews[imgViewIndex];
-            RPS_V_RETURN(CreateImageView(m_device, hImage, resource, access, hImgView));
+                    m_imageViewLayouts[imgViewIndex] = GetTrackedImageLayoutInfo(resource, access);
 
-            m_accessToDescriptorMap[accessIndex] = imgViewIndex;
+                    VkImageView& hImgView = currResources.imageViews[imgViewIndex];
+                    RPS_V_RETURN(CreateImageView(m_device, hImage, resource, access, hImgView));
 
-            imgViewIndex++;
-        }
+                    m_accessToDescriptorMap[accessIndex] = imgViewIndex;
+                }
 
-        return RPS_OK;
+                return RPS_OK;
+            });
     }
 
     RpsResult VKRuntimeBackend::CreateBufferViews(const RenderGraphUpdateContext& context,
@@ -993,25 +999,27 @@ namespace rps
 
         RPS_CHECK_ALLOC(currResources.bufferViews.resize(accessIndices.size()));
 
-        uint32_t bufViewIndex = 0;
-        VkBuffer hBuffer      = VK_NULL_HANDLE;
+        return context.renderGraph.ParallelFor(
+            uint32_t(accessIndices.size()), MinViewsPerTask, [&](uint32_t viewBegin, uint32_t viewEnd) {
+                VkBuffer hBuffer = VK_NULL_HANDLE;
 
-        for (auto accessIndex : accessIndices)
-        {
-            auto& access = cmdAccesses[accessIndex];
+                for (uint32_t bufViewIndex = viewBegin; bufViewIndex < viewEnd; bufViewIndex++)
+                {
+                    const uint32_t accessIndex = accessIndices[bufViewIndex];
 
-            const auto& resource = resourceInstances[access.resourceId];
-            FromHandle(hBuffer, resource.hRuntimeResource);
+                    auto& access = cmdAccesses[accessIndex];
 
-            VkBufferView& hBufView = currResources.bufferViews[bufViewIndex];
-            RPS_V_RETURN(CreateBufferView(m_device, hBuffer, resource, access, hBufView));
+                    const auto& resource = resourceInstances[access.resourceId];
+                    FromHandle(hBuffer, resource.hRuntimeResource);
 
-            m_accessToDescriptorMap[accessIndex] = bufViewIndex;
+                    VkBufferView& hBufView = currResources.bufferViews[bufViewIndex];
+                    RPS_V_RETURN(CreateBufferView(m_device, hBuffer, resource, access, hBufView));
 
-            bufViewIndex++;
-        }
+                    m_accessToDescriptorMap[accessIndex] = bufViewIndex;
+                }
 
-        return RPS_OK;
+                return RPS_OK;
+            });
     }
 
     static constexpr bool StencilOp    = true;
@@ -1430,6 +1438,7 @@ namespace rps
         {
             auto& cmd = transitionRangeCmds[idx];
             RPS_ASSERT(cmd.isTransition);
+            RPS_ASSERT(!cmd.isSplitBarrierBegin && !cmd.isSplitBarrierEnd);
 
             // For aliased resources, wait on deactivating final access pipeline stages.
             for (auto& aliasing : cmd.aliasingInfos.Get(aliasingInfos))
@@ -60,6 +60,12 @@ namespace rps
                    ((aspectMask & VK_IMAGE_ASPECT_STENCIL_BIT) ? RPS_IMAGE_ASPECT_STENCIL : RPS_IMAGE_ASPECT_UNKNOWN);
         }
 
+        // Split barriers would need VkEvents, barriers are always issued as a whole.
+        virtual bool SupportsSplitBarriers() const override final
+        {
+            return false;
+        }
+
     public:
         VkDevice GetVkDevice() const
         {
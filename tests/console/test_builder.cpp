@@ -9,7 +9,17 @@
 
 #include "rps/rps.h"
 
+#include "runtime/common/rps_runtime_device.hpp"
+
 #include "utils/rps_test_common.h"
+#include "utils/rps_test_render_graph_fixture.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
 
 extern "C" {
 
@@ -219,3 +229,2157 @@ TEST_CASE("BuildGraphUsingCApiCommon")
 
     rpsTestUtilDestroyDevice(device);
 }
+
+// Records the access flags and resources of all resource arguments, in recording order.
+struct AccessFlagsRecorder
+{
+    std::vector<RpsAccessFlags> accessFlags;
+    std::vector<RpsResourceId>  resourceIds;
+
+    static void RecordNode(const RpsCmdCallbackContext* pContext)
+    {
+        auto pThis = static_cast<AccessFlagsRecorder*>(pContext->pUserRecordContext);
+
+        for (uint32_t iArg = 0; iArg < pContext->numArgs; iArg++)
+        {
+            RpsResourceAccessInfo accessInfo = {};
+            REQUIRE_RPS_OK(rpsCmdGetArgResourceAccessInfo(pContext, iArg, &accessInfo));
+            pThis->accessFlags.push_back(accessInfo.access.accessFlags);
+            pThis->resourceIds.push_back(accessInfo.resourceId);
+        }
+    }
+
+    std::vector<RpsAccessFlags> Record(RpsRenderGraph hRenderGraph)
+    {
+        RpsRenderGraphBatchLayout batchLayout = {};
+        REQUIRE_RPS_OK(rpsRenderGraphGetBatchLayout(hRenderGraph, &batchLayout));
+
+        accessFlags.clear();
+        resourceIds.clear();
+
+        for (uint32_t iBatch = 0; iBatch < batchLayout.numCmdBatches; iBatch++)
+        {
+            RpsRenderGraphRecordCommandInfo recordInfo = {};
+            recordInfo.pUserContext                    = this;
+            recordInfo.cmdBeginIndex                   = batchLayout.pCmdBatches[iBatch].cmdBegin;
+            recordInfo.numCmds                         = batchLayout.pCmdBatches[iBatch].numCmds;
+            REQUIRE_RPS_OK(rpsRenderGraphRecordCommands(hRenderGraph, &recordInfo));
+        }
+
+        return accessFlags;
+    }
+};
+
+// A transient buffer written and read once, whose accesses get discard flags from lifetime analysis.
+static RpsResult buildDiscardAccessGraph(RpsRenderGraphBuilder hBuilder, const RpsConstant*, uint32_t)
+{
+    using namespace rps;
+
+    const AccessAttr uavAccess(RPS_ACCESS_UNORDERED_ACCESS_BIT, RPS_SHADER_STAGE_CS);
+    const AccessAttr srvAccess(RPS_ACCESS_SHADER_RESOURCE_BIT, RPS_SHADER_STAGE_CS);
+
+    // Resource parameters, so the callbacks can query the accesses of their arguments.
+    RpsNodeDeclId writeNode = rpsRenderGraphDeclareDynamicNode(
+        hBuilder,
+        "Write",
+        RPS_NODE_DECL_COMPUTE_BIT,
+        {ParameterDesc::Make<BufferView>(uavAccess, "dst", RPS_PARAMETER_FLAG_RESOURCE_BIT)});
+
+    RpsNodeDeclId readNode = rpsRenderGraphDeclareDynamicNode(
+        hBuilder,
+        "Read",
+        RPS_NODE_DECL_COMPUTE_BIT,
+        {ParameterDesc::Make<BufferView>(srvAccess, "src", RPS_PARAMETER_FLAG_RESOURCE_BIT),
+         ParameterDesc::Make<BufferView>(uavAccess, "dst", RPS_PARAMETER_FLAG_RESOURCE_BIT)});
+
+    ResourceDesc* pBufferDesc = rpsRenderGraphAllocateData<ResourceDesc>(hBuilder);
+    BufferView*   pViews      = static_cast<BufferView*>(
+        rpsRenderGraphAllocateDataAligned(hBuilder, sizeof(BufferView) * 2, alignof(BufferView)));
+    REQUIRE(pBufferDesc);
+    REQUIRE(pViews);
+
+    *pBufferDesc = ResourceDesc::Buffer(64 * 1024);
+    pViews[0]    = BufferView{rpsRenderGraphDeclareResource(hBuilder, "Temp", 0, pBufferDesc)};
+    pViews[1]    = BufferView{rpsRenderGraphDeclareResource(hBuilder, "Result", 1, pBufferDesc)};
+
+    rpsRenderGraphAddNode(
+        hBuilder, writeNode, 0, &AccessFlagsRecorder::RecordNode, nullptr, RPS_CMD_CALLBACK_FLAG_NONE, {&pViews[0]});
+
+    rpsRenderGraphAddNode(hBuilder,
+                          readNode,
+                          1,
+                          &AccessFlagsRecorder::RecordNode,
+                          nullptr,
+                          RPS_CMD_CALLBACK_FLAG_NONE,
+                          {&pViews[0], &pViews[1]});
+
+    return RPS_OK;
+}
+
+TEST_CASE("IncrementalUpdate")
+{
+    const RpsResourceDesc backBufferResDesc = rpsTestUtilMakeBackBufferDesc(1280, 720);
+    PrivateUpdateInfo     privateUpdateInfo = {1280, 720, RPS_TRUE, RPS_TRUE};
+
+    RpsTestRenderGraphFixture fixture("RenderToTexture_Incremental", &buildRenderToTextureCpp);
+    fixture.AddBackBufferParam(&backBufferResDesc);
+    fixture.AddParam("userContext", &privateUpdateInfo);
+    fixture.createInfo.renderGraphFlags = RPS_RENDER_GRAPH_INCREMENTAL_UPDATE;
+    REQUIRE_RPS_OK(fixture.CreateRenderGraph());
+
+    auto fnGetDiagInfo = [&]() {
+        RpsRenderGraphDiagnosticInfo diagInfo = {};
+        REQUIRE_RPS_OK(rpsRenderGraphGetDiagnosticInfo(
+            fixture.hRenderGraph, &diagInfo, RPS_RENDER_GRAPH_DIAGNOSTIC_INFO_DEFAULT));
+        return diagInfo;
+    };
+
+    auto fnGetRuntimeCmdCount = [&]() { return fnGetDiagInfo().numCommandInfos; };
+    auto fnIsStructureReused  = [&]() { return fnGetDiagInfo().isStructureReused; };
+
+    auto fnGetBatchCount = [&]() {
+        RpsRenderGraphBatchLayout batchLayout = {};
+        REQUIRE_RPS_OK(rpsRenderGraphGetBatchLayout(fixture.hRenderGraph, &batchLayout));
+        return batchLayout.numCmdBatches;
+    };
+
+    // The update after a structural change also changes the resource states carried over to the next one, so the
+    // structure is reused starting from the second update after it.
+    auto fnUpdate = [&](bool bExpectReused) {
+        REQUIRE_RPS_OK(fixture.Update());
+        REQUIRE(bool(fnIsStructureReused()) == bExpectReused);
+        fixture.updateInfo.frameIndex++;
+    };
+
+    // Steady state frames must produce the same schedule as the first, fully processed one.
+    fnUpdate(false);
+    const uint32_t fullCmdCount   = fnGetRuntimeCmdCount();
+    const uint32_t fullBatchCount = fnGetBatchCount();
+
+    fnUpdate(false);
+
+    for (uint32_t iFrame = 0; iFrame < 3; iFrame++)
+    {
+        fnUpdate(true);
+        REQUIRE(fullCmdCount == fnGetRuntimeCmdCount());
+        REQUIRE(fullBatchCount == fnGetBatchCount());
+    }
+
+    // Structural changes must invalidate the reused schedule.
+    privateUpdateInfo.bUseOffscreenRT = RPS_FALSE;
+    fnUpdate(false);
+    REQUIRE(fullCmdCount != fnGetRuntimeCmdCount());
+
+    privateUpdateInfo.bUseOffscreenRT = RPS_TRUE;
+    fnUpdate(false);
+    fnUpdate(false);
+    REQUIRE(fullCmdCount == fnGetRuntimeCmdCount());
+
+    for (uint32_t iFrame = 0; iFrame < 3; iFrame++)
+    {
+        fnUpdate(true);
+        REQUIRE(fullCmdCount == fnGetRuntimeCmdCount());
+        REQUIRE(fullBatchCount == fnGetBatchCount());
+    }
+
+    fixture.Destroy();
+}
+
+TEST_CASE("IncrementalUpdateAccessFlags")
+{
+    static constexpr RpsAccessFlags DiscardFlags =
+        RPS_ACCESS_DISCARD_DATA_BEFORE_BIT | RPS_ACCESS_DISCARD_DATA_AFTER_BIT;
+
+    RpsTestRenderGraphFixture fixture("DiscardAccesses_Incremental", &buildDiscardAccessGraph);
+    fixture.createInfo.scheduleInfo.scheduleFlags = RPS_SCHEDULE_DISABLE_DEAD_CODE_ELIMINATION_BIT;
+    fixture.createInfo.renderGraphFlags           = RPS_RENDER_GRAPH_INCREMENTAL_UPDATE;
+    REQUIRE_RPS_OK(fixture.CreateRenderGraph());
+
+    AccessFlagsRecorder recorder;
+
+    auto fnIsStructureReused = [&]() {
+        RpsRenderGraphDiagnosticInfo diagInfo = {};
+        REQUIRE_RPS_OK(rpsRenderGraphGetDiagnosticInfo(
+            fixture.hRenderGraph, &diagInfo, RPS_RENDER_GRAPH_DIAGNOSTIC_INFO_DEFAULT));
+        return diagInfo.isStructureReused;
+    };
+
+    // Resource states carried over from previous updates take a few updates to settle, see IncrementalUpdate.
+    std::vector<RpsAccessFlags> fullAccessFlags;
+
+    REQUIRE_RPS_OK(fixture.Update());
+
+    while (!fnIsStructureReused())
+    {
+        REQUIRE(fixture.updateInfo.frameIndex < 8);
+        fullAccessFlags = recorder.Record(fixture.hRenderGraph);
+
+        fixture.updateInfo.frameIndex++;
+        REQUIRE_RPS_OK(fixture.Update());
+    }
+
+    // Write, then read and write.
+    REQUIRE(fullAccessFlags.size() == 3);
+    REQUIRE(std::any_of(fullAccessFlags.begin(), fullAccessFlags.end(), [](RpsAccessFlags flags) {
+        return (flags & DiscardFlags) != 0;
+    }));
+
+    // Reused frames skip lifetime analysis but must record the same accesses as a full update.
+    for (uint32_t iFrame = 0; iFrame < 3; iFrame++)
+    {
+        REQUIRE(fnIsStructureReused());
+        REQUIRE(fullAccessFlags == recorder.Record(fixture.hRenderGraph));
+
+        fixture.updateInfo.frameIndex++;
+        REQUIRE_RPS_OK(fixture.Update());
+    }
+
+    fixture.Destroy();
+}
+
+TEST_CASE("AvoidReschedule")
+{
+    const RpsResourceDesc backBufferResDesc = rpsTestUtilMakeBackBufferDesc(1280, 720);
+    PrivateUpdateInfo     privateUpdateInfo = {1280, 720, RPS_TRUE, RPS_TRUE};
+
+    RpsQueueFlags queueFlags[] = {RPS_QUEUE_FLAG_GRAPHICS, RPS_QUEUE_FLAG_COMPUTE, RPS_QUEUE_FLAG_COPY};
+
+    RpsTestRenderGraphFixture fixture("RenderToTexture_AvoidReschedule", &buildRenderToTextureCpp);
+    fixture.AddBackBufferParam(&backBufferResDesc);
+    fixture.AddParam("userContext", &privateUpdateInfo);
+    fixture.createInfo.scheduleInfo.numQueues     = RPS_TEST_COUNTOF(queueFlags);
+    fixture.createInfo.scheduleInfo.pQueueInfos   = queueFlags;
+    fixture.createInfo.scheduleInfo.scheduleFlags = RPS_SCHEDULE_AVOID_RESCHEDULE_BIT;
+    REQUIRE_RPS_OK(fixture.CreateRenderGraph());
+
+    auto fnGetBatches = [&]() {
+        RpsRenderGraphBatchLayout batchLayout = {};
+        REQUIRE_RPS_OK(rpsRenderGraphGetBatchLayout(fixture.hRenderGraph, &batchLayout));
+        return std::vector<RpsCommandBatch>(batchLayout.pCmdBatches,
+                                            batchLayout.pCmdBatches + batchLayout.numCmdBatches);
+    };
+
+    auto fnBatchesEqual = [](const std::vector<RpsCommandBatch>& lhs, const std::vector<RpsCommandBatch>& rhs) {
+        return (lhs.size() == rhs.size()) &&
+               std::equal(lhs.begin(), lhs.end(), rhs.begin(), [](const auto& a, const auto& b) {
+                   return (a.queueIndex == b.queueIndex) && (a.cmdBegin == b.cmdBegin) &&
+                          (a.numCmds == b.numCmds) && (a.numWaitFences == b.numWaitFences) &&
+                          (a.signalFenceIndex == b.signalFenceIndex);
+               });
+    };
+
+    auto fnGetNumSchedulesComputed = [&]() {
+        RpsRenderGraphDiagnosticInfo diagInfo = {};
+        REQUIRE_RPS_OK(rpsRenderGraphGetDiagnosticInfo(
+            fixture.hRenderGraph, &diagInfo, RPS_RENDER_GRAPH_DIAGNOSTIC_INFO_DEFAULT));
+        return diagInfo.numSchedulesComputed;
+    };
+
+    REQUIRE_RPS_OK(fixture.Update());
+    REQUIRE(fnGetNumSchedulesComputed() == 1);
+    const auto fullBatches = fnGetBatches();
+
+    // Unchanged inputs replay the cached schedule.
+    for (uint32_t iFrame = 1; iFrame < 4; iFrame++)
+    {
+        fixture.updateInfo.frameIndex = iFrame;
+        REQUIRE_RPS_OK(fixture.Update());
+        REQUIRE(fnGetNumSchedulesComputed() == 0);
+        REQUIRE(fnBatchesEqual(fullBatches, fnGetBatches()));
+    }
+
+    // Changed inputs must be rescheduled.
+    privateUpdateInfo.bUseOffscreenRT = RPS_FALSE;
+    fixture.updateInfo.frameIndex++;
+    REQUIRE_RPS_OK(fixture.Update());
+    REQUIRE(fnGetNumSchedulesComputed() == 1);
+    REQUIRE(!fnBatchesEqual(fullBatches, fnGetBatches()));
+
+    privateUpdateInfo.bUseOffscreenRT = RPS_TRUE;
+    fixture.updateInfo.frameIndex++;
+    REQUIRE_RPS_OK(fixture.Update());
+    REQUIRE(fnGetNumSchedulesComputed() == 1);
+    REQUIRE(fnBatchesEqual(fullBatches, fnGetBatches()));
+
+    fixture.updateInfo.frameIndex++;
+    REQUIRE_RPS_OK(fixture.Update());
+    REQUIRE(fnGetNumSchedulesComputed() == 0);
+
+    // A full reschedule must match the replayed schedule.
+    fixture.updateInfo.scheduleFlags = RPS_SCHEDULE_DEFAULT;
+    fixture.updateInfo.frameIndex++;
+    REQUIRE_RPS_OK(fixture.Update());
+    REQUIRE(fnGetNumSchedulesComputed() == 1);
+    REQUIRE(fnBatchesEqual(fullBatches, fnGetBatches()));
+
+    fixture.Destroy();
+}
+
+struct RandomGraphInfo
+{
+    uint32_t seed;
+    uint32_t numNodes;
+    uint32_t numResources;
+};
+
+static void RecordScheduledNodeId(const RpsCmdCallbackContext* pContext)
+{
+    RpsNodeId nodeId = RPS_CMD_ID_INVALID;
+    REQUIRE_RPS_OK(rpsCmdGetNodeId(pContext, &nodeId));
+
+    static_cast<std::vector<RpsNodeId>*>(pContext->pUserRecordContext)->push_back(nodeId);
+}
+
+// Nodes of all queue types reading and writing random buffers of random sizes.
+static RpsResult buildRandomGraph(RpsRenderGraphBuilder hBuilder, const RpsConstant* ppArgs, uint32_t numArgs)
+{
+    using namespace rps;
+
+    REQUIRE(numArgs == 1);
+
+    const RandomGraphInfo* pGraphInfo = static_cast<const RandomGraphInfo*>(ppArgs[0]);
+
+    const AccessAttr psSrvAccess(RPS_ACCESS_SHADER_RESOURCE_BIT, RPS_SHADER_STAGE_PS);
+    const AccessAttr psUavAccess(RPS_ACCESS_UNORDERED_ACCESS_BIT, RPS_SHADER_STAGE_PS);
+    const AccessAttr csSrvAccess(RPS_ACCESS_SHADER_RESOURCE_BIT, RPS_SHADER_STAGE_CS);
+    const AccessAttr csUavAccess(RPS_ACCESS_UNORDERED_ACCESS_BIT, RPS_SHADER_STAGE_CS);
+    const AccessAttr copySrcAccess(RPS_ACCESS_COPY_SRC_BIT, RPS_SHADER_STAGE_NONE);
+    const AccessAttr copyDstAccess(RPS_ACCESS_COPY_DEST_BIT, RPS_SHADER_STAGE_NONE);
+
+    const RpsNodeDeclId nodeDecls[] = {
+        rpsRenderGraphDeclareDynamicNode(
+            hBuilder,
+            "Graphics",
+            RPS_NODE_DECL_GRAPHICS_BIT,
+            {ParameterDesc::Make<BufferView>(psSrvAccess, "src", RPS_PARAMETER_FLAG_OPTIONAL_BIT),
+             ParameterDesc::Make<BufferView>(psUavAccess, "dst")}),
+        rpsRenderGraphDeclareDynamicNode(
+            hBuilder,
+            "Compute",
+            RPS_NODE_DECL_COMPUTE_BIT,
+            {ParameterDesc::Make<BufferView>(csSrvAccess, "src", RPS_PARAMETER_FLAG_OPTIONAL_BIT),
+             ParameterDesc::Make<BufferView>(csUavAccess, "dst")}),
+        rpsRenderGraphDeclareDynamicNode(
+            hBuilder,
+            "AsyncCompute",
+            RPS_NODE_DECL_COMPUTE_BIT | RPS_NODE_DECL_PREFER_ASYNC,
+            {ParameterDesc::Make<BufferView>(csSrvAccess, "src", RPS_PARAMETER_FLAG_OPTIONAL_BIT),
+             ParameterDesc::Make<BufferView>(csUavAccess, "dst")}),
+        rpsRenderGraphDeclareDynamicNode(
+            hBuilder,
+            "Copy",
+            RPS_NODE_DECL_COPY_BIT,
+            {ParameterDesc::Make<BufferView>(copySrcAccess, "src", RPS_PARAMETER_FLAG_OPTIONAL_BIT),
+             ParameterDesc::Make<BufferView>(copyDstAccess, "dst")}),
+    };
+
+    ResourceDesc* pBufferDescs = static_cast<ResourceDesc*>(rpsRenderGraphAllocateDataAligned(
+        hBuilder, sizeof(ResourceDesc) * pGraphInfo->numResources, alignof(ResourceDesc)));
+    BufferView* pViews = static_cast<BufferView*>(rpsRenderGraphAllocateDataAligned(
+        hBuilder, sizeof(BufferView) * pGraphInfo->numResources, alignof(BufferView)));
+    REQUIRE(pBufferDescs);
+    REQUIRE(pViews);
+
+    std::mt19937                            randGen(pGraphInfo->seed);
+    std::uniform_int_distribution<uint32_t> resourceDist(0, pGraphInfo->numResources - 1);
+    std::uniform_int_distribution<uint32_t> nodeDeclDist(0, RPS_TEST_COUNTOF(nodeDecls) - 1);
+    std::uniform_int_distribution<uint32_t> sizeShiftDist(0, 6);
+
+    for (uint32_t iRes = 0; iRes < pGraphInfo->numResources; iRes++)
+    {
+        pBufferDescs[iRes] = ResourceDesc::Buffer(uint64_t(64 * 1024) << sizeShiftDist(randGen));
+        pViews[iRes]       = BufferView{rpsRenderGraphDeclareResource(hBuilder, "Buffer", iRes, &pBufferDescs[iRes])};
+    }
+
+    for (uint32_t iNode = 0; iNode < pGraphInfo->numNodes; iNode++)
+    {
+        const uint32_t dstIndex = resourceDist(randGen);
+        const uint32_t srcIndex = resourceDist(randGen);
+
+        rpsRenderGraphAddNode(hBuilder,
+                              nodeDecls[nodeDeclDist(randGen)],
+                              iNode,
+                              &RecordScheduledNodeId,
+                              nullptr,
+                              RPS_CMD_CALLBACK_FLAG_NONE,
+                              {(srcIndex != dstIndex) ? &pViews[srcIndex] : nullptr, &pViews[dstIndex]});
+    }
+
+    return RPS_OK;
+}
+
+TEST_CASE("ReadyNodeQueueMatchesReferenceScheduler")
+{
+    RpsQueueFlags queueFlags[] = {RPS_QUEUE_FLAG_GRAPHICS, RPS_QUEUE_FLAG_COMPUTE, RPS_QUEUE_FLAG_COPY};
+
+    const RpsScheduleFlags scheduleFlagSets[] = {
+        RPS_SCHEDULE_DEFAULT,
+        RPS_SCHEDULE_PREFER_MEMORY_SAVING_BIT,
+        RPS_SCHEDULE_MINIMIZE_COMPUTE_GFX_SWITCH_BIT,
+        RPS_SCHEDULE_WORKLOAD_TYPE_PIPELINING_AGGRESSIVE_BIT,
+        RPS_SCHEDULE_DISABLE_DEAD_CODE_ELIMINATION_BIT,
+    };
+
+    RandomGraphInfo graphInfo = {};
+
+    RpsTestRenderGraphFixture fixture("RandomGraph", &buildRandomGraph);
+    fixture.AddParam("graphInfo", &graphInfo);
+
+    // Batches, transitions with their position and command nodes in scheduled order.
+    auto fnGetScheduledOrder = [&]() {
+        RpsRenderGraphBatchLayout batchLayout = {};
+        REQUIRE_RPS_OK(rpsRenderGraphGetBatchLayout(fixture.hRenderGraph, &batchLayout));
+
+        RpsRenderGraphDiagnosticInfo diagInfo = {};
+        REQUIRE_RPS_OK(rpsRenderGraphGetDiagnosticInfo(
+            fixture.hRenderGraph, &diagInfo, RPS_RENDER_GRAPH_DIAGNOSTIC_INFO_DEFAULT));
+
+        std::vector<uint64_t>  order;
+        std::vector<RpsNodeId> nodeIds;
+
+        for (uint32_t iBatch = 0; iBatch < batchLayout.numCmdBatches; iBatch++)
+        {
+            const RpsCommandBatch& batch = batchLayout.pCmdBatches[iBatch];
+            order.push_back((uint64_t(batch.queueIndex) << 32) | batch.numCmds);
+
+            RpsRenderGraphRecordCommandInfo recordInfo = {};
+            recordInfo.pUserContext                    = &nodeIds;
+            recordInfo.cmdBeginIndex                   = batch.cmdBegin;
+            recordInfo.numCmds                         = batch.numCmds;
+            REQUIRE_RPS_OK(rpsRenderGraphRecordCommands(fixture.hRenderGraph, &recordInfo));
+        }
+
+        for (uint32_t iCmd = 0; iCmd < diagInfo.numCommandInfos; iCmd++)
+        {
+            const RpsCmdDiagnosticInfo& cmdInfo = diagInfo.pCmdDiagInfos[iCmd];
+
+            if (cmdInfo.isTransition)
+            {
+                order.push_back((uint64_t(iCmd) << 32) | cmdInfo.transition.resourceIndex);
+                order.push_back(cmdInfo.transition.nextAccess.accessFlags);
+            }
+        }
+
+        order.insert(order.end(), nodeIds.begin(), nodeIds.end());
+
+        return order;
+    };
+
+    for (uint32_t numQueues = 1; numQueues <= RPS_TEST_COUNTOF(queueFlags); numQueues += 2)
+    {
+        for (RpsScheduleFlags scheduleFlags : scheduleFlagSets)
+        {
+            fixture.createInfo.scheduleInfo.numQueues     = numQueues;
+            fixture.createInfo.scheduleInfo.pQueueInfos   = queueFlags;
+            fixture.createInfo.scheduleInfo.scheduleFlags = scheduleFlags;
+            REQUIRE_RPS_OK(fixture.CreateRenderGraph());
+
+            for (uint32_t seed = 0; seed < 16; seed++)
+            {
+                graphInfo = {seed, 16 + seed * 8, 4 + seed};
+
+                fixture.updateInfo.diagnosticFlags = RPS_DIAGNOSTIC_ENABLE_REFERENCE_SCHEDULER;
+                REQUIRE_RPS_OK(fixture.Update());
+                const auto referenceOrder = fnGetScheduledOrder();
+
+                fixture.updateInfo.diagnosticFlags = RPS_DIAGNOSTIC_NONE;
+                REQUIRE_RPS_OK(fixture.Update());
+                REQUIRE(referenceOrder == fnGetScheduledOrder());
+            }
+        }
+    }
+
+    fixture.Destroy();
+}
+
+// Simulates the GPU execution of the schedule with per node times, to compare the makespan of schedules.
+struct NodeTimeSimulation
+{
+    std::vector<float> nodeTimes;
+    float              batchTime = 0.0f;
+
+    static float TimeFromName(const char* pNodeName)
+    {
+        return (strcmp(pNodeName, "AsyncWork") == 0) ? 8.0f : (strcmp(pNodeName, "Chain") == 0) ? 2.0f : 1.0f;
+    }
+
+    static float EstimateNodeTime(void* pContext, RpsNodeId nodeId, const char* pNodeName)
+    {
+        auto pThis = static_cast<NodeTimeSimulation*>(pContext);
+
+        if (pThis->nodeTimes.size() <= nodeId)
+        {
+            pThis->nodeTimes.resize(nodeId + 1, 0.0f);
+        }
+        pThis->nodeTimes[nodeId] = TimeFromName(pNodeName);
+
+        return pThis->nodeTimes[nodeId];
+    }
+
+    static void RecordNode(const RpsCmdCallbackContext* pContext)
+    {
+        auto pThis = static_cast<NodeTimeSimulation*>(pContext->pUserRecordContext);
+
+        RpsNodeId nodeId = RPS_CMD_ID_INVALID;
+        REQUIRE_RPS_OK(rpsCmdGetNodeId(pContext, &nodeId));
+
+        const char* pNodeName = nullptr;
+        REQUIRE_RPS_OK(rpsCmdGetNodeName(pContext, &pNodeName, nullptr));
+
+        pThis->batchTime += TimeFromName(pNodeName);
+    }
+
+    float CalcMakespan(RpsRenderGraph hRenderGraph)
+    {
+        RpsRenderGraphBatchLayout batchLayout = {};
+        REQUIRE_RPS_OK(rpsRenderGraphGetBatchLayout(hRenderGraph, &batchLayout));
+
+        float              queueEndTimes[RPS_MAX_QUEUES] = {};
+        std::vector<float> fenceTimes(batchLayout.numCmdBatches, 0.0f);
+
+        for (uint32_t iBatch = 0; iBatch < batchLayout.numCmdBatches; iBatch++)
+        {
+            const RpsCommandBatch& batch = batchLayout.pCmdBatches[iBatch];
+
+            float startTime = queueEndTimes[batch.queueIndex];
+
+            for (uint32_t iWait = 0; iWait < batch.numWaitFences; iWait++)
+            {
+                const uint32_t fenceIndex = batchLayout.pWaitFenceIndices[batch.waitFencesBegin + iWait];
+                REQUIRE(fenceIndex < fenceTimes.size());
+                startTime = std::max(startTime, fenceTimes[fenceIndex]);
+            }
+
+            batchTime = 0.0f;
+
+            RpsRenderGraphRecordCommandInfo recordInfo = {};
+            recordInfo.pUserContext                    = this;
+            recordInfo.cmdBeginIndex                   = batch.cmdBegin;
+            recordInfo.numCmds                         = batch.numCmds;
+            REQUIRE_RPS_OK(rpsRenderGraphRecordCommands(hRenderGraph, &recordInfo));
+
+            queueEndTimes[batch.queueIndex] = startTime + batchTime;
+
+            if (batch.signalFenceIndex != RPS_INDEX_NONE_U32)
+            {
+                REQUIRE(batch.signalFenceIndex < fenceTimes.size());
+                fenceTimes[batch.signalFenceIndex] = queueEndTimes[batch.queueIndex];
+            }
+        }
+
+        return *std::max_element(std::begin(queueEndTimes), std::end(queueEndTimes));
+    }
+};
+
+// A long async compute node consumed by a short graphics node, and an independent graphics chain.
+// Both are consumed by a final node. In program order the short node comes before the chain, so without time
+// estimates it is scheduled first and stalls the graphics queue until the async node is done.
+static RpsResult buildAsyncOverlapGraph(RpsRenderGraphBuilder hBuilder, const RpsConstant*, uint32_t)
+{
+    using namespace rps;
+
+    static constexpr uint32_t NumChainNodes = 4;
+
+    const AccessAttr uavAccess(RPS_ACCESS_UNORDERED_ACCESS_BIT, RPS_SHADER_STAGE_CS);
+    const AccessAttr srvAccess(RPS_ACCESS_SHADER_RESOURCE_BIT, RPS_SHADER_STAGE_CS);
+
+    RpsNodeDeclId asyncNode = rpsRenderGraphDeclareDynamicNode(hBuilder,
+                                                               "AsyncWork",
+                                                               RPS_NODE_DECL_COMPUTE_BIT | RPS_NODE_DECL_PREFER_ASYNC,
+                                                               {ParameterDesc::Make<BufferView>(uavAccess, "dst")});
+
+    RpsNodeDeclId resolveNode = rpsRenderGraphDeclareDynamicNode(
+        hBuilder,
+        "Resolve",
+        RPS_NODE_DECL_COMPUTE_BIT,
+        {ParameterDesc::Make<BufferView>(srvAccess, "src"), ParameterDesc::Make<BufferView>(uavAccess, "dst")});
+
+    RpsNodeDeclId chainNode = rpsRenderGraphDeclareDynamicNode(
+        hBuilder,
+        "Chain",
+        RPS_NODE_DECL_COMPUTE_BIT,
+        {ParameterDesc::Make<BufferView>(srvAccess, "src", RPS_PARAMETER_FLAG_OPTIONAL_BIT),
+         ParameterDesc::Make<BufferView>(uavAccess, "dst")});
+
+    RpsNodeDeclId combineNode =
+        rpsRenderGraphDeclareDynamicNode(hBuilder,
+                                         "Combine",
+                                         RPS_NODE_DECL_COMPUTE_BIT,
+                                         {ParameterDesc::Make<BufferView>(srvAccess, "chain"),
+                                          ParameterDesc::Make<BufferView>(srvAccess, "resolved"),
+                                          ParameterDesc::Make<BufferView>(uavAccess, "dst")});
+
+    enum ViewIndices
+    {
+        VIEW_ASYNC,
+        VIEW_RESOLVED,
+        VIEW_COMBINED,
+        VIEW_CHAIN,
+        NUM_VIEWS = VIEW_CHAIN + NumChainNodes,
+    };
+
+    ResourceDesc* pBufferDesc = rpsRenderGraphAllocateData<ResourceDesc>(hBuilder);
+    BufferView*   pViews      = static_cast<BufferView*>(
+        rpsRenderGraphAllocateDataAligned(hBuilder, sizeof(BufferView) * NUM_VIEWS, alignof(BufferView)));
+    REQUIRE(pBufferDesc);
+    REQUIRE(pViews);
+
+    *pBufferDesc = ResourceDesc::Buffer(64 * 1024);
+
+    for (uint32_t iView = 0; iView < NUM_VIEWS; iView++)
+    {
+        pViews[iView] = BufferView{rpsRenderGraphDeclareResource(hBuilder, "Buffer", iView, pBufferDesc)};
+    }
+
+    uint32_t localNodeId = 0;
+
+    rpsRenderGraphAddNode(hBuilder,
+                          asyncNode,
+                          localNodeId++,
+                          &NodeTimeSimulation::RecordNode,
+                          nullptr,
+                          RPS_CMD_CALLBACK_FLAG_NONE,
+                          {&pViews[VIEW_ASYNC]});
+
+    rpsRenderGraphAddNode(hBuilder,
+                          resolveNode,
+                          localNodeId++,
+                          &NodeTimeSimulation::RecordNode,
+                          nullptr,
+                          RPS_CMD_CALLBACK_FLAG_NONE,
+                          {&pViews[VIEW_ASYNC], &pViews[VIEW_RESOLVED]});
+
+    for (uint32_t iNode = 0; iNode < NumChainNodes; iNode++)
+    {
+        rpsRenderGraphAddNode(hBuilder,
+                              chainNode,
+                              localNodeId++,
+                              &NodeTimeSimulation::RecordNode,
+                              nullptr,
+                              RPS_CMD_CALLBACK_FLAG_NONE,
+                              {(iNode > 0) ? &pViews[VIEW_CHAIN + iNode - 1] : nullptr, &pViews[VIEW_CHAIN + iNode]});
+    }
+
+    rpsRenderGraphAddNode(hBuilder,
+                          combineNode,
+                          localNodeId++,
+                          &NodeTimeSimulation::RecordNode,
+                          nullptr,
+                          RPS_CMD_CALLBACK_FLAG_NONE,
+                          {&pViews[VIEW_CHAIN + NumChainNodes - 1], &pViews[VIEW_RESOLVED], &pViews[VIEW_COMBINED]});
+
+    return RPS_OK;
+}
+
+TEST_CASE("ScheduleWithNodeTimeEstimates")
+{
+    RpsQueueFlags queueFlags[] = {RPS_QUEUE_FLAG_GRAPHICS, RPS_QUEUE_FLAG_COMPUTE};
+
+    RpsTestRenderGraphFixture fixture("AsyncOverlap", &buildAsyncOverlapGraph);
+    fixture.createInfo.scheduleInfo.numQueues   = RPS_TEST_COUNTOF(queueFlags);
+    fixture.createInfo.scheduleInfo.pQueueInfos = queueFlags;
+    fixture.createInfo.scheduleInfo.scheduleFlags =
+        RPS_SCHEDULE_AVOID_RESCHEDULE_BIT | RPS_SCHEDULE_DISABLE_DEAD_CODE_ELIMINATION_BIT;
+    REQUIRE_RPS_OK(fixture.CreateRenderGraph());
+
+    NodeTimeSimulation   simulation = {};
+    RpsNodeTimeEstimator estimator  = {&NodeTimeSimulation::EstimateNodeTime, &simulation};
+
+    REQUIRE_RPS_OK(fixture.Update());
+    const float defaultMakespan = simulation.CalcMakespan(fixture.hRenderGraph);
+
+    fixture.updateInfo.frameIndex++;
+    fixture.updateInfo.pNodeTimeEstimator = &estimator;
+    REQUIRE_RPS_OK(fixture.Update());
+    const float estimatedMakespan = simulation.CalcMakespan(fixture.hRenderGraph);
+
+    // Every command node got an estimate.
+    REQUIRE(simulation.nodeTimes.size() == 7);
+
+    // The async node overlaps the graphics chain, only the resolve and final nodes run after both.
+    REQUIRE(estimatedMakespan < defaultMakespan);
+    REQUIRE(estimatedMakespan == 10.0f);
+
+    // Unchanged estimates keep the schedule, changed ones are picked up.
+    fixture.updateInfo.frameIndex++;
+    REQUIRE_RPS_OK(fixture.Update());
+    REQUIRE(estimatedMakespan == simulation.CalcMakespan(fixture.hRenderGraph));
+
+    fixture.updateInfo.frameIndex++;
+    fixture.updateInfo.pNodeTimeEstimator = nullptr;
+    REQUIRE_RPS_OK(fixture.Update());
+    REQUIRE(defaultMakespan == simulation.CalcMakespan(fixture.hRenderGraph));
+
+    fixture.Destroy();
+}
+
+// A producer and its consumer with independent nodes in between. The transition of the produced buffer can start
+// right after the producer and only has to be done before the consumer.
+static RpsResult buildSplitBarrierGraph(RpsRenderGraphBuilder hBuilder, const RpsConstant*, uint32_t)
+{
+    using namespace rps;
+
+    static constexpr uint32_t NumIndependentNodes = 3;
+
+    const AccessAttr uavAccess(RPS_ACCESS_UNORDERED_ACCESS_BIT, RPS_SHADER_STAGE_CS);
+    const AccessAttr srvAccess(RPS_ACCESS_SHADER_RESOURCE_BIT, RPS_SHADER_STAGE_CS);
+
+    RpsNodeDeclId writeNode = rpsRenderGraphDeclareDynamicNode(
+        hBuilder, "Write", RPS_NODE_DECL_COMPUTE_BIT, {ParameterDesc::Make<BufferView>(uavAccess, "dst")});
+
+    RpsNodeDeclId readNode = rpsRenderGraphDeclareDynamicNode(
+        hBuilder,
+        "Read",
+        RPS_NODE_DECL_COMPUTE_BIT,
+        {ParameterDesc::Make<BufferView>(srvAccess, "src"), ParameterDesc::Make<BufferView>(uavAccess, "dst")});
+
+    enum ViewIndices
+    {
+        VIEW_PRODUCED,
+        VIEW_CONSUMED,
+        VIEW_INDEPENDENT,
+        NUM_VIEWS = VIEW_INDEPENDENT + NumIndependentNodes,
+    };
+
+    ResourceDesc* pBufferDesc = rpsRenderGraphAllocateData<ResourceDesc>(hBuilder);
+    BufferView*   pViews      = static_cast<BufferView*>(
+        rpsRenderGraphAllocateDataAligned(hBuilder, sizeof(BufferView) * NUM_VIEWS, alignof(BufferView)));
+    REQUIRE(pBufferDesc);
+    REQUIRE(pViews);
+
+    *pBufferDesc = ResourceDesc::Buffer(64 * 1024);
+
+    for (uint32_t iView = 0; iView < NUM_VIEWS; iView++)
+    {
+        pViews[iView] = BufferView{rpsRenderGraphDeclareResource(hBuilder, "Buffer", iView, pBufferDesc)};
+    }
+
+    uint32_t localNodeId = 0;
+
+    rpsRenderGraphAddNode(
+        hBuilder, writeNode, localNodeId++, nullptr, nullptr, RPS_CMD_CALLBACK_FLAG_NONE, {&pViews[VIEW_PRODUCED]});
+
+    for (uint32_t iNode = 0; iNode < NumIndependentNodes; iNode++)
+    {
+        rpsRenderGraphAddNode(hBuilder,
+                              writeNode,
+                              localNodeId++,
+                              nullptr,
+                              nullptr,
+                              RPS_CMD_CALLBACK_FLAG_NONE,
+                              {&pViews[VIEW_INDEPENDENT + iNode]});
+    }
+
+    rpsRenderGraphAddNode(hBuilder,
+                          readNode,
+                          localNodeId++,
+                          nullptr,
+                          nullptr,
+                          RPS_CMD_CALLBACK_FLAG_NONE,
+                          {&pViews[VIEW_PRODUCED], &pViews[VIEW_CONSUMED]});
+
+    return RPS_OK;
+}
+
+TEST_CASE("SplitBarriers")
+{
+    RpsTestRenderGraphFixture fixture("SplitBarriers", &buildSplitBarrierGraph);
+    fixture.createInfo.scheduleInfo.scheduleFlags =
+        RPS_SCHEDULE_KEEP_PROGRAM_ORDER_BIT | RPS_SCHEDULE_DISABLE_DEAD_CODE_ELIMINATION_BIT;
+    REQUIRE_RPS_OK(fixture.CreateRenderGraph());
+
+    struct SplitBarrierStats
+    {
+        uint32_t numCmds;
+        uint32_t numSplitBegins;
+        uint32_t numSplitEnds;
+    };
+
+    auto fnGetSplitBarrierStats = [&]() {
+        RpsRenderGraphDiagnosticInfo diagInfo = {};
+        REQUIRE_RPS_OK(rpsRenderGraphGetDiagnosticInfo(
+            fixture.hRenderGraph, &diagInfo, RPS_RENDER_GRAPH_DIAGNOSTIC_INFO_DEFAULT));
+
+        SplitBarrierStats stats = {diagInfo.numCommandInfos, 0, 0};
+
+        for (uint32_t iCmd = 0; iCmd < diagInfo.numCommandInfos; iCmd++)
+        {
+            const RpsCmdDiagnosticInfo& beginCmd = diagInfo.pCmdDiagInfos[iCmd];
+
+            if (!beginCmd.isTransition)
+            {
+                continue;
+            }
+
+            stats.numSplitEnds += beginCmd.transition.isSplitEnd ? 1 : 0;
+
+            if (!beginCmd.transition.isSplitBegin)
+            {
+                continue;
+            }
+
+            stats.numSplitBegins++;
+
+            // The matching end half follows with a command in between.
+            bool     bFoundEnd     = false;
+            uint32_t numCmdsInside = 0;
+
+            for (uint32_t iNext = iCmd + 1; (iNext < diagInfo.numCommandInfos) && !bFoundEnd; iNext++)
+            {
+                const RpsCmdDiagnosticInfo& nextCmd = diagInfo.pCmdDiagInfos[iNext];
+
+                numCmdsInside += nextCmd.isTransition ? 0 : 1;
+
+                bFoundEnd = nextCmd.isTransition && nextCmd.transition.isSplitEnd &&
+                            (nextCmd.transition.resourceIndex == beginCmd.transition.resourceIndex) &&
+                            (nextCmd.transition.prevAccess.accessFlags == beginCmd.transition.prevAccess.accessFlags) &&
+                            (nextCmd.transition.nextAccess.accessFlags == beginCmd.transition.nextAccess.accessFlags);
+            }
+
+            REQUIRE(bFoundEnd);
+            REQUIRE(numCmdsInside > 0);
+        }
+
+        return stats;
+    };
+
+    REQUIRE_RPS_OK(fixture.Update());
+    const SplitBarrierStats defaultStats = fnGetSplitBarrierStats();
+
+    REQUIRE(defaultStats.numSplitBegins == 0);
+    REQUIRE(defaultStats.numSplitEnds == 0);
+
+    fixture.updateInfo.frameIndex++;
+    fixture.updateInfo.scheduleFlags = RPS_SCHEDULE_KEEP_PROGRAM_ORDER_BIT |
+                                       RPS_SCHEDULE_DISABLE_DEAD_CODE_ELIMINATION_BIT |
+                                       RPS_SCHEDULE_ALLOW_SPLIT_BARRIERS_BIT;
+    REQUIRE_RPS_OK(fixture.Update());
+    const SplitBarrierStats splitStats = fnGetSplitBarrierStats();
+
+    // The produced buffer transition is split around the independent nodes, each split adds one runtime cmd.
+    REQUIRE(splitStats.numSplitBegins > 0);
+    REQUIRE(splitStats.numSplitBegins == splitStats.numSplitEnds);
+    REQUIRE(splitStats.numCmds == (defaultStats.numCmds + splitStats.numSplitBegins));
+
+    RpsRenderGraphBatchLayout batchLayout = {};
+    REQUIRE_RPS_OK(rpsRenderGraphGetBatchLayout(fixture.hRenderGraph, &batchLayout));
+    REQUIRE(batchLayout.numCmdBatches == 1);
+    REQUIRE(batchLayout.pCmdBatches[0].numCmds == splitStats.numCmds);
+
+    fixture.Destroy();
+}
+
+static constexpr uint32_t OrderedWriterCount = 6;
+
+static RpsResult buildOrderedWritersGraph(RpsRenderGraphBuilder hBuilder, const RpsConstant*, uint32_t)
+{
+    using namespace rps;
+
+    const AccessAttr copyDstAccess(RPS_ACCESS_COPY_DEST_BIT, RPS_SHADER_STAGE_NONE);
+    const AccessAttr srvAccess(RPS_ACCESS_SHADER_RESOURCE_BIT, RPS_SHADER_STAGE_CS);
+
+    RpsNodeDeclId fillNode = rpsRenderGraphDeclareDynamicNode(
+        hBuilder, "Fill", RPS_NODE_DECL_COPY_BIT, {ParameterDesc::Make<BufferView>(copyDstAccess, "dst")});
+
+    RpsNodeDeclId readNode = rpsRenderGraphDeclareDynamicNode(
+        hBuilder, "Read", RPS_NODE_DECL_COMPUTE_BIT, {ParameterDesc::Make<BufferView>(srvAccess, "src")});
+
+    ResourceDesc* pBufferDesc = rpsRenderGraphAllocateData<ResourceDesc>(hBuilder);
+    BufferView*   pView       = rpsRenderGraphAllocateData<BufferView>(hBuilder);
+    REQUIRE(pBufferDesc);
+    REQUIRE(pView);
+
+    *pBufferDesc = ResourceDesc::Buffer(64 * 1024);
+    *pView       = BufferView{rpsRenderGraphDeclareResource(hBuilder, "Buffer", 0, pBufferDesc)};
+
+    uint32_t localNodeId = 0;
+
+    // Same access without a transition, each writer is ordered after the previous one.
+    for (uint32_t iNode = 0; iNode < OrderedWriterCount; iNode++)
+    {
+        rpsRenderGraphAddNode(hBuilder, fillNode, localNodeId++, nullptr, nullptr, RPS_CMD_CALLBACK_FLAG_NONE, {pView});
+    }
+
+    rpsRenderGraphAddNode(hBuilder, readNode, localNodeId++, nullptr, nullptr, RPS_CMD_CALLBACK_FLAG_NONE, {pView});
+
+    return RPS_OK;
+}
+
+static std::string s_dagDumpLog;
+
+static void PrintToDagDumpLog(void*, const char* formatString, ...)
+{
+    char buf[1024];
+
+    va_list args;
+    va_start(args, formatString);
+    vsnprintf(buf, sizeof(buf), formatString, args);
+    va_end(args);
+
+    s_dagDumpLog += buf;
+}
+
+TEST_CASE("AccessDAGEdgePruning")
+{
+    RpsTestRenderGraphFixture fixture("AccessDAGEdgePruning", &buildOrderedWritersGraph, &PrintToDagDumpLog);
+    fixture.updateInfo.diagnosticFlags = RPS_DIAGNOSTIC_ENABLE_DAG_DUMP;
+    REQUIRE_RPS_OK(fixture.CreateRenderGraph());
+
+    s_dagDumpLog.clear();
+    REQUIRE_RPS_OK(fixture.Update());
+
+    // Only the last writer needs an edge to the transition into the read access.
+    const size_t edgeCountPos = s_dagDumpLog.find("// Edges:");
+    REQUIRE(edgeCountPos != std::string::npos);
+
+    uint32_t numEdges = 0, numEdgesBeforePruning = 0;
+    REQUIRE(sscanf(s_dagDumpLog.c_str() + edgeCountPos,
+                   "// Edges: %u (%u before pruning)",
+                   &numEdges,
+                   &numEdgesBeforePruning) == 2);
+    REQUIRE(numEdgesBeforePruning == numEdges + (OrderedWriterCount - 1));
+
+    // The read transition still comes after all writers.
+    RpsRenderGraphDiagnosticInfo diagInfo = {};
+    REQUIRE_RPS_OK(rpsRenderGraphGetDiagnosticInfo(
+        fixture.hRenderGraph, &diagInfo, RPS_RENDER_GRAPH_DIAGNOSTIC_INFO_DEFAULT));
+
+    uint32_t numCmdsBeforeRead    = 0;
+    bool     bFoundReadTransition = false;
+
+    for (uint32_t iCmd = 0; (iCmd < diagInfo.numCommandInfos) && !bFoundReadTransition; iCmd++)
+    {
+        const RpsCmdDiagnosticInfo& cmdInfo = diagInfo.pCmdDiagInfos[iCmd];
+
+        bFoundReadTransition =
+            cmdInfo.isTransition && (cmdInfo.transition.nextAccess.accessFlags & RPS_ACCESS_SHADER_RESOURCE_BIT);
+        numCmdsBeforeRead += cmdInfo.isTransition ? 0 : 1;
+    }
+
+    REQUIRE(bFoundReadTransition);
+    REQUIRE(numCmdsBeforeRead == OrderedWriterCount);
+
+    fixture.Destroy();
+}
+
+struct AliasingChainInfo
+{
+    uint32_t numBuffers;
+    uint32_t bufferSize;
+};
+
+// Builds a chain where every node reads the buffer of the previous node and writes its own, so buffers two nodes
+// apart have disjoint lifetimes and can alias.
+static RpsResult buildAliasingChainGraph(RpsRenderGraphBuilder hBuilder, const RpsConstant* ppArgs, uint32_t numArgs)
+{
+    using namespace rps;
+
+    REQUIRE(numArgs == 1);
+
+    const AliasingChainInfo* pInfo = static_cast<const AliasingChainInfo*>(ppArgs[0]);
+
+    const AccessAttr uavAccess(RPS_ACCESS_UNORDERED_ACCESS_BIT, RPS_SHADER_STAGE_CS);
+    const AccessAttr srvAccess(RPS_ACCESS_SHADER_RESOURCE_BIT, RPS_SHADER_STAGE_CS);
+
+    RpsNodeDeclId writeNode = rpsRenderGraphDeclareDynamicNode(
+        hBuilder, "Write", RPS_NODE_DECL_COMPUTE_BIT, {ParameterDesc::Make<BufferView>(uavAccess, "dst")});
+
+    RpsNodeDeclId transformNode = rpsRenderGraphDeclareDynamicNode(
+        hBuilder,
+        "Transform",
+        RPS_NODE_DECL_COMPUTE_BIT,
+        {ParameterDesc::Make<BufferView>(srvAccess, "src"), ParameterDesc::Make<BufferView>(uavAccess, "dst")});
+
+    ResourceDesc* pBufferDesc = rpsRenderGraphAllocateData<ResourceDesc>(hBuilder);
+    BufferView*   pViews      = static_cast<BufferView*>(
+        rpsRenderGraphAllocateDataAligned(hBuilder, sizeof(BufferView) * pInfo->numBuffers, alignof(BufferView)));
+    REQUIRE(pBufferDesc);
+    REQUIRE(pViews);
+
+    *pBufferDesc = ResourceDesc::Buffer(pInfo->bufferSize);
+
+    for (uint32_t iView = 0; iView < pInfo->numBuffers; iView++)
+    {
+        pViews[iView] = BufferView{rpsRenderGraphDeclareResource(hBuilder, "Buffer", iView, pBufferDesc)};
+    }
+
+    rpsRenderGraphAddNode(hBuilder, writeNode, 0, nullptr, nullptr, RPS_CMD_CALLBACK_FLAG_NONE, {&pViews[0]});
+
+    for (uint32_t iNode = 1; iNode < pInfo->numBuffers; iNode++)
+    {
+        rpsRenderGraphAddNode(hBuilder,
+                              transformNode,
+                              iNode,
+                              nullptr,
+                              nullptr,
+                              RPS_CMD_CALLBACK_FLAG_NONE,
+                              {&pViews[iNode - 1], &pViews[iNode]});
+    }
+
+    return RPS_OK;
+}
+
+TEST_CASE("PlacementCache")
+{
+    AliasingChainInfo chainInfo = {6, 64 * 1024};
+
+    RpsTestRenderGraphFixture fixture("PlacementCache", &buildAliasingChainGraph);
+    fixture.AddParam("chainInfo", &chainInfo);
+    fixture.createInfo.scheduleInfo.scheduleFlags =
+        RPS_SCHEDULE_KEEP_PROGRAM_ORDER_BIT | RPS_SCHEDULE_DISABLE_DEAD_CODE_ELIMINATION_BIT;
+    REQUIRE_RPS_OK(fixture.CreateRenderGraph());
+
+    auto fnGetPlacements = [&]() {
+        RpsRenderGraphDiagnosticInfo diagInfo = {};
+        REQUIRE_RPS_OK(rpsRenderGraphGetDiagnosticInfo(
+            fixture.hRenderGraph, &diagInfo, RPS_RENDER_GRAPH_DIAGNOSTIC_INFO_DEFAULT));
+        REQUIRE(diagInfo.numResourceInfos == chainInfo.numBuffers);
+
+        std::vector<RpsHeapPlacement> placements;
+
+        for (uint32_t iRes = 0; iRes < diagInfo.numResourceInfos; iRes++)
+        {
+            const RpsResourceDiagnosticInfo& resA = diagInfo.pResourceDiagInfos[iRes];
+
+            REQUIRE(resA.allocRequirement.size >= chainInfo.bufferSize);
+
+            for (uint32_t jRes = iRes + 1; jRes < diagInfo.numResourceInfos; jRes++)
+            {
+                const RpsResourceDiagnosticInfo& resB = diagInfo.pResourceDiagInfos[jRes];
+
+                const bool bOverlap =
+                    (resA.allocPlacement.heapId == resB.allocPlacement.heapId) &&
+                    (resA.lifetimeBegin <= resB.lifetimeEnd) && (resB.lifetimeBegin <= resA.lifetimeEnd) &&
+                    (resA.allocPlacement.offset < (resB.allocPlacement.offset + resB.allocRequirement.size)) &&
+                    (resB.allocPlacement.offset < (resA.allocPlacement.offset + resA.allocRequirement.size));
+                REQUIRE(!bOverlap);
+            }
+
+            placements.push_back(resA.allocPlacement);
+        }
+
+        // Buffers two nodes apart share memory.
+        REQUIRE(placements[0].heapId == placements[2].heapId);
+        REQUIRE(placements[0].offset == placements[2].offset);
+
+        return placements;
+    };
+
+    auto fnPlacementsEqual = [](const std::vector<RpsHeapPlacement>& a, const std::vector<RpsHeapPlacement>& b) {
+        return std::equal(a.begin(), a.end(), b.begin(), b.end(), [](const auto& placementA, const auto& placementB) {
+            return (placementA.heapId == placementB.heapId) && (placementA.offset == placementB.offset);
+        });
+    };
+
+    REQUIRE_RPS_OK(fixture.Update());
+    const std::vector<RpsHeapPlacement> initialPlacements = fnGetPlacements();
+
+    // Steady state frames reuse the cached placements.
+    for (uint32_t iFrame = 1; iFrame < 4; iFrame++)
+    {
+        fixture.updateInfo.frameIndex = iFrame;
+        REQUIRE_RPS_OK(fixture.Update());
+        REQUIRE(fnPlacementsEqual(initialPlacements, fnGetPlacements()));
+    }
+
+    // Changing the resource sizes must invalidate the cache.
+    chainInfo.bufferSize *= 4;
+    fixture.updateInfo.frameIndex++;
+    REQUIRE_RPS_OK(fixture.Update());
+    REQUIRE(!fnPlacementsEqual(initialPlacements, fnGetPlacements()));
+
+    chainInfo.bufferSize /= 4;
+    for (uint32_t iFrame = 0; iFrame < 3; iFrame++)
+    {
+        fixture.updateInfo.frameIndex++;
+        REQUIRE_RPS_OK(fixture.Update());
+        REQUIRE(fnPlacementsEqual(initialPlacements, fnGetPlacements()));
+    }
+
+    fixture.Destroy();
+}
+
+// Ids of the resources a runtime device was asked to initialize subresource and alloc infos for.
+struct ResourceInfoQueries
+{
+    std::vector<uint32_t> subresourceInfoResIds;
+    std::vector<uint32_t> allocInfoResIds;
+
+    void Clear()
+    {
+        subresourceInfoResIds.clear();
+        allocInfoResIds.clear();
+    }
+};
+
+// A null runtime device recording the resources its resource info queries are made for.
+class CountingRuntimeDevice final : public rps::RuntimeDevice
+{
+public:
+    CountingRuntimeDevice(rps::Device* pDevice, ResourceInfoQueries* pQueries)
+        : RuntimeDevice(pDevice, nullptr)
+        , m_nullDevice(pDevice)
+        , m_pQueries(pQueries)
+    {
+    }
+
+    virtual RpsResult BuildDefaultRenderGraphPhases(rps::RenderGraph& renderGraph) override final
+    {
+        return m_nullDevice.BuildDefaultRenderGraphPhases(renderGraph);
+    }
+
+    virtual RpsResult InitializeSubresourceInfos(rps::ArrayRef<rps::ResourceInstance> resInstances) override final
+    {
+        for (const rps::ResourceInstance& resInst : resInstances)
+        {
+            m_pQueries->subresourceInfoResIds.push_back(resInst.resourceDeclId);
+        }
+
+        return m_nullDevice.InitializeSubresourceInfos(resInstances);
+    }
+
+    virtual RpsResult InitializeResourceAllocInfos(rps::ArrayRef<rps::ResourceInstance> resInstances) override final
+    {
+        for (const rps::ResourceInstance& resInst : resInstances)
+        {
+            m_pQueries->allocInfoResIds.push_back(resInst.resourceDeclId);
+        }
+
+        return m_nullDevice.InitializeResourceAllocInfos(resInstances);
+    }
+
+    virtual RpsResult GetSubresourceRangeFromImageView(rps::SubresourceRangePacked& outRange,
+                                                       const rps::ResourceInstance& resourceInfo,
+                                                       const RpsAccessAttr&         accessAttr,
+                                                       const RpsImageView&          imageView) override final
+    {
+        return m_nullDevice.GetSubresourceRangeFromImageView(outRange, resourceInfo, accessAttr, imageView);
+    }
+
+    virtual RpsImageAspectUsageFlags GetImageAspectUsages(uint32_t aspectMask) const override final
+    {
+        return m_nullDevice.GetImageAspectUsages(aspectMask);
+    }
+
+    virtual rps::ConstArrayRef<RpsMemoryTypeInfo> GetMemoryTypeInfos() const override final
+    {
+        return m_nullDevice.GetMemoryTypeInfos();
+    }
+
+private:
+    rps::NullRuntimeDevice     m_nullDevice;
+    ResourceInfoQueries* const m_pQueries;
+};
+
+struct ResourceInfoGraphInfo
+{
+    uint32_t bufferSizes[3];
+    uint32_t copySrcBuffer;
+};
+
+// Writes and reads a few buffers, and optionally copies from one of them, which adds an access to it.
+static RpsResult buildResourceInfoGraph(RpsRenderGraphBuilder hBuilder, const RpsConstant* ppArgs, uint32_t numArgs)
+{
+    using namespace rps;
+
+    REQUIRE(numArgs == 1);
+
+    const ResourceInfoGraphInfo* pInfo = static_cast<const ResourceInfoGraphInfo*>(ppArgs[0]);
+
+    const AccessAttr uavAccess(RPS_ACCESS_UNORDERED_ACCESS_BIT, RPS_SHADER_STAGE_CS);
+    const AccessAttr srvAccess(RPS_ACCESS_SHADER_RESOURCE_BIT, RPS_SHADER_STAGE_CS);
+    const AccessAttr copySrcAccess(RPS_ACCESS_COPY_SRC_BIT, RPS_SHADER_STAGE_NONE);
+
+    RpsNodeDeclId writeNode = rpsRenderGraphDeclareDynamicNode(
+        hBuilder, "Write", RPS_NODE_DECL_COMPUTE_BIT, {ParameterDesc::Make<BufferView>(uavAccess, "dst")});
+
+    RpsNodeDeclId readNode = rpsRenderGraphDeclareDynamicNode(
+        hBuilder, "Read", RPS_NODE_DECL_COMPUTE_BIT, {ParameterDesc::Make<BufferView>(srvAccess, "src")});
+
+    RpsNodeDeclId copyFromNode = rpsRenderGraphDeclareDynamicNode(
+        hBuilder, "CopyFrom", RPS_NODE_DECL_COPY_BIT, {ParameterDesc::Make<BufferView>(copySrcAccess, "src")});
+
+    const uint32_t numBuffers = RPS_TEST_COUNTOF(pInfo->bufferSizes);
+
+    ResourceDesc* pBufferDescs = static_cast<ResourceDesc*>(
+        rpsRenderGraphAllocateDataAligned(hBuilder, sizeof(ResourceDesc) * numBuffers, alignof(ResourceDesc)));
+    BufferView* pViews = static_cast<BufferView*>(
+        rpsRenderGraphAllocateDataAligned(hBuilder, sizeof(BufferView) * numBuffers, alignof(BufferView)));
+    REQUIRE(pBufferDescs);
+    REQUIRE(pViews);
+
+    uint32_t nodeTag = 0;
+
+    for (uint32_t iBuffer = 0; iBuffer < numBuffers; iBuffer++)
+    {
+        pBufferDescs[iBuffer] = ResourceDesc::Buffer(pInfo->bufferSizes[iBuffer]);
+        pViews[iBuffer] =
+            BufferView{rpsRenderGraphDeclareResource(hBuilder, "Buffer", iBuffer, &pBufferDescs[iBuffer])};
+
+        rpsRenderGraphAddNode(
+            hBuilder, writeNode, nodeTag++, nullptr, nullptr, RPS_CMD_CALLBACK_FLAG_NONE, {&pViews[iBuffer]});
+        rpsRenderGraphAddNode(
+            hBuilder, readNode, nodeTag++, nullptr, nullptr, RPS_CMD_CALLBACK_FLAG_NONE, {&pViews[iBuffer]});
+    }
+
+    if (pInfo->copySrcBuffer < numBuffers)
+    {
+        rpsRenderGraphAddNode(hBuilder,
+                              copyFromNode,
+                              nodeTag++,
+                              nullptr,
+                              nullptr,
+                              RPS_CMD_CALLBACK_FLAG_NONE,
+                              {&pViews[pInfo->copySrcBuffer]});
+    }
+
+    return RPS_OK;
+}
+
+TEST_CASE("ResourceInfoQueries")
+{
+    ResourceInfoGraphInfo graphInfo = {{64 * 1024, 64 * 1024, 64 * 1024}, RPS_INDEX_NONE_U32};
+    ResourceInfoQueries   queries;
+
+    RpsDevice device = rpsTestUtilCreateDevice([&](const RpsDeviceCreateInfo* pCreateInfo, RpsDevice* phDevice) {
+        return rps::RuntimeDevice::Create<CountingRuntimeDevice>(phDevice, pCreateInfo, &queries);
+    });
+
+    RpsTestRenderGraphFixture fixture("ResourceInfoQueries", &buildResourceInfoGraph, device);
+    fixture.AddParam("graphInfo", &graphInfo);
+    fixture.createInfo.scheduleInfo.scheduleFlags = RPS_SCHEDULE_DISABLE_DEAD_CODE_ELIMINATION_BIT;
+    REQUIRE_RPS_OK(fixture.CreateRenderGraph());
+
+    const std::vector<uint32_t> allResIds = {0, 1, 2};
+
+    // The first frame queries every resource once.
+    REQUIRE_RPS_OK(fixture.Update());
+    REQUIRE(queries.subresourceInfoResIds == allResIds);
+    REQUIRE(queries.allocInfoResIds == allResIds);
+
+    // Steady state frames don't query any.
+    for (uint32_t iFrame = 1; iFrame < 4; iFrame++)
+    {
+        queries.Clear();
+        fixture.updateInfo.frameIndex = iFrame;
+        REQUIRE_RPS_OK(fixture.Update());
+        REQUIRE(queries.subresourceInfoResIds.empty());
+        REQUIRE(queries.allocInfoResIds.empty());
+    }
+
+    // A desc change queries the changed resource only.
+    queries.Clear();
+    graphInfo.bufferSizes[1] *= 2;
+    fixture.updateInfo.frameIndex++;
+    REQUIRE_RPS_OK(fixture.Update());
+    REQUIRE(queries.subresourceInfoResIds == std::vector<uint32_t>{1});
+    REQUIRE(queries.allocInfoResIds == std::vector<uint32_t>{1});
+
+    queries.Clear();
+    fixture.updateInfo.frameIndex++;
+    REQUIRE_RPS_OK(fixture.Update());
+    REQUIRE(queries.subresourceInfoResIds.empty());
+    REQUIRE(queries.allocInfoResIds.empty());
+
+    // So does a new access to a resource.
+    queries.Clear();
+    graphInfo.copySrcBuffer = 2;
+    fixture.updateInfo.frameIndex++;
+    REQUIRE_RPS_OK(fixture.Update());
+    REQUIRE(queries.subresourceInfoResIds == std::vector<uint32_t>{2});
+    REQUIRE(queries.allocInfoResIds == std::vector<uint32_t>{2});
+
+    queries.Clear();
+    fixture.updateInfo.frameIndex++;
+    REQUIRE_RPS_OK(fixture.Update());
+    REQUIRE(queries.subresourceInfoResIds.empty());
+    REQUIRE(queries.allocInfoResIds.empty());
+
+    fixture.Destroy();
+}
+
+TEST_CASE("DynamicMemoryAliasing")
+{
+    AliasingChainInfo chainInfo = {6, 64 * 1024};
+
+    RpsTestRenderGraphFixture fixture("DynamicMemoryAliasing", &buildAliasingChainGraph);
+    fixture.AddParam("chainInfo", &chainInfo);
+    fixture.createInfo.scheduleInfo.scheduleFlags =
+        RPS_SCHEDULE_KEEP_PROGRAM_ORDER_BIT | RPS_SCHEDULE_DISABLE_DEAD_CODE_ELIMINATION_BIT;
+    fixture.createInfo.renderGraphFlags = RPS_RENDER_GRAPH_INCREMENTAL_UPDATE;
+    REQUIRE_RPS_OK(fixture.CreateRenderGraph());
+
+    // Returns the placements, checking no two resources overlap in memory while both are live, or at all without
+    // aliasing.
+    auto fnGetPlacements = [&](bool bAliasing) {
+        RpsRenderGraphDiagnosticInfo diagInfo = {};
+        REQUIRE_RPS_OK(rpsRenderGraphGetDiagnosticInfo(
+            fixture.hRenderGraph, &diagInfo, RPS_RENDER_GRAPH_DIAGNOSTIC_INFO_DEFAULT));
+        REQUIRE(diagInfo.numResourceInfos == chainInfo.numBuffers);
+
+        std::vector<RpsHeapPlacement> placements;
+
+        for (uint32_t iRes = 0; iRes < diagInfo.numResourceInfos; iRes++)
+        {
+            const RpsResourceDiagnosticInfo& resA = diagInfo.pResourceDiagInfos[iRes];
+
+            for (uint32_t jRes = iRes + 1; jRes < diagInfo.numResourceInfos; jRes++)
+            {
+                const RpsResourceDiagnosticInfo& resB = diagInfo.pResourceDiagInfos[jRes];
+
+                const bool bLifetimeOverlap = !bAliasing || ((resA.lifetimeBegin <= resB.lifetimeEnd) &&
+                                                             (resB.lifetimeBegin <= resA.lifetimeEnd));
+
+                const bool bOverlap =
+                    bLifetimeOverlap && (resA.allocPlacement.heapId == resB.allocPlacement.heapId) &&
+                    (resA.allocPlacement.offset < (resB.allocPlacement.offset + resB.allocRequirement.size)) &&
+                    (resB.allocPlacement.offset < (resA.allocPlacement.offset + resA.allocRequirement.size));
+                REQUIRE(!bOverlap);
+            }
+
+            placements.push_back(resA.allocPlacement);
+        }
+
+        return placements;
+    };
+
+    auto fnPlacementEqual = [](const RpsHeapPlacement& a, const RpsHeapPlacement& b) {
+        return (a.heapId == b.heapId) && (a.offset == b.offset);
+    };
+
+    // The null device never creates resources, so every update with new placement inputs places them again.
+    const RpsMemoryAliasingMode aliasingModes[] = {RPS_MEMORY_ALIASING_DEFAULT,
+                                                   RPS_MEMORY_ALIASING_DISABLED,
+                                                   RPS_MEMORY_ALIASING_ENABLED,
+                                                   RPS_MEMORY_ALIASING_DISABLED,
+                                                   RPS_MEMORY_ALIASING_DEFAULT};
+
+    for (uint32_t iFrame = 0; iFrame < RPS_TEST_COUNTOF(aliasingModes); iFrame++)
+    {
+        const bool bAliasing = (aliasingModes[iFrame] != RPS_MEMORY_ALIASING_DISABLED);
+
+        fixture.updateInfo.frameIndex         = iFrame;
+        fixture.updateInfo.memoryAliasingMode = aliasingModes[iFrame];
+        REQUIRE_RPS_OK(fixture.Update());
+
+        const std::vector<RpsHeapPlacement> placements = fnGetPlacements(bAliasing);
+
+        // Buffers two nodes apart share memory if aliasing is enabled.
+        REQUIRE(fnPlacementEqual(placements[0], placements[2]) == bAliasing);
+    }
+
+    // Aliasing can't be enabled per update without lifetime analysis.
+    fixture.createInfo.renderGraphFlags =
+        RPS_RENDER_GRAPH_NO_GPU_MEMORY_ALIASING | RPS_RENDER_GRAPH_NO_LIFETIME_ANALYSIS;
+    REQUIRE_RPS_OK(fixture.CreateRenderGraph());
+
+    fixture.updateInfo.frameIndex         = 0;
+    fixture.updateInfo.memoryAliasingMode = RPS_MEMORY_ALIASING_DEFAULT;
+    REQUIRE_RPS_OK(fixture.Update());
+
+    fixture.updateInfo.frameIndex         = 1;
+    fixture.updateInfo.memoryAliasingMode = RPS_MEMORY_ALIASING_ENABLED;
+    REQUIRE(fixture.Update() == RPS_ERROR_INVALID_OPERATION);
+
+    fixture.Destroy();
+}
+
+TEST_CASE("HeapCompaction")
+{
+    AliasingChainInfo chainInfo = {6, 1024 * 1024};
+
+    RpsTestRenderGraphFixture fixture("HeapCompaction", &buildAliasingChainGraph);
+    fixture.AddParam("chainInfo", &chainInfo);
+    fixture.createInfo.scheduleInfo.scheduleFlags =
+        RPS_SCHEDULE_KEEP_PROGRAM_ORDER_BIT | RPS_SCHEDULE_DISABLE_DEAD_CODE_ELIMINATION_BIT;
+    fixture.createInfo.renderGraphFlags                       = RPS_RENDER_GRAPH_COMPACT_HEAPS;
+    fixture.createInfo.memoryInfo.maxCompactionMovesPerUpdate = 1;
+    REQUIRE_RPS_OK(fixture.CreateRenderGraph());
+
+    struct HeapStats
+    {
+        uint32_t numHeaps;
+        uint64_t totalSize;
+    };
+
+    // Checks that no two resources overlap in both lifetime and placement, and returns the live heap stats.
+    auto fnGetHeapStats = [&]() {
+        RpsRenderGraphDiagnosticInfo diagInfo = {};
+        REQUIRE_RPS_OK(rpsRenderGraphGetDiagnosticInfo(
+            fixture.hRenderGraph, &diagInfo, RPS_RENDER_GRAPH_DIAGNOSTIC_INFO_DEFAULT));
+
+        for (uint32_t iRes = 0; iRes < diagInfo.numResourceInfos; iRes++)
+        {
+            const RpsResourceDiagnosticInfo& resA = diagInfo.pResourceDiagInfos[iRes];
+
+            REQUIRE(resA.allocPlacement.heapId < diagInfo.numHeapInfos);
+            REQUIRE(diagInfo.pHeapDiagInfos[resA.allocPlacement.heapId].memoryTypeIndex != UINT32_MAX);
+
+            for (uint32_t jRes = iRes + 1; jRes < diagInfo.numResourceInfos; jRes++)
+            {
+                const RpsResourceDiagnosticInfo& resB = diagInfo.pResourceDiagInfos[jRes];
+
+                const bool bOverlap =
+                    (resA.allocPlacement.heapId == resB.allocPlacement.heapId) &&
+                    (resA.lifetimeBegin <= resB.lifetimeEnd) && (resB.lifetimeBegin <= resA.lifetimeEnd) &&
+                    (resA.allocPlacement.offset < (resB.allocPlacement.offset + resB.allocRequirement.size)) &&
+                    (resB.allocPlacement.offset < (resA.allocPlacement.offset + resA.allocRequirement.size));
+                REQUIRE(!bOverlap);
+            }
+        }
+
+        HeapStats stats = {};
+
+        for (uint32_t iHeap = 0; iHeap < diagInfo.numHeapInfos; iHeap++)
+        {
+            if (diagInfo.pHeapDiagInfos[iHeap].memoryTypeIndex != UINT32_MAX)
+            {
+                stats.numHeaps++;
+                stats.totalSize += diagInfo.pHeapDiagInfos[iHeap].size;
+            }
+        }
+
+        return stats;
+    };
+
+    auto fnUpdate = [&]() {
+        fixture.updateInfo.frameIndex++;
+        fixture.updateInfo.gpuCompletedFrameIndex = fixture.updateInfo.frameIndex - 2;
+        REQUIRE_RPS_OK(fixture.Update());
+        return fnGetHeapStats();
+    };
+
+    REQUIRE_RPS_OK(fixture.Update());
+    const HeapStats initialStats = fnGetHeapStats();
+    REQUIRE(initialStats.numHeaps == 1);
+
+    // Shrinking the buffers leaves the heap mostly unused, which triggers compaction.
+    chainInfo.bufferSize /= 16;
+    HeapStats stats = fnUpdate();
+    REQUIRE(stats.totalSize == initialStats.totalSize);
+
+    // Resources move to a new heap one per update, then the old heap is released after the GPU passed it.
+    for (uint32_t iFrame = 0; (iFrame < 16) && (stats.totalSize >= initialStats.totalSize); iFrame++)
+    {
+        stats = fnUpdate();
+        REQUIRE(stats.numHeaps <= 2);
+    }
+
+    REQUIRE(stats.numHeaps == 1);
+    REQUIRE(stats.totalSize * 8 <= initialStats.totalSize);
+
+    // The compacted layout is kept in steady state.
+    for (uint32_t iFrame = 0; iFrame < 4; iFrame++)
+    {
+        const HeapStats steadyStats = fnUpdate();
+        REQUIRE(steadyStats.numHeaps == stats.numHeaps);
+        REQUIRE(steadyStats.totalSize == stats.totalSize);
+    }
+
+    fixture.Destroy();
+}
+
+TEST_CASE("HeapSizePolicy")
+{
+    static constexpr uint64_t DefaultHeapSize = 1024 * 1024;
+    static constexpr uint64_t PageSize        = 64 * 1024;
+
+    AliasingChainInfo chainInfo = {16, 256 * 1024};
+
+    RpsTestRenderGraphFixture fixture("HeapSizePolicy", &buildAliasingChainGraph);
+    fixture.AddParam("chainInfo", &chainInfo);
+    fixture.createInfo.scheduleInfo.scheduleFlags =
+        RPS_SCHEDULE_KEEP_PROGRAM_ORDER_BIT | RPS_SCHEDULE_DISABLE_DEAD_CODE_ELIMINATION_BIT;
+    fixture.createInfo.memoryInfo.defaultHeapSize = DefaultHeapSize;
+    fixture.createInfo.renderGraphFlags           = RPS_RENDER_GRAPH_SMALL_RESOURCE_PAGES;
+    REQUIRE_RPS_OK(fixture.CreateRenderGraph());
+
+    RpsRenderGraphDiagnosticInfo diagInfo = {};
+
+    // Checks that no two resources overlap in both lifetime and placement, and that every resource fits its heap.
+    auto fnUpdate = [&]() {
+        fixture.updateInfo.frameIndex++;
+        REQUIRE_RPS_OK(fixture.Update());
+        REQUIRE_RPS_OK(rpsRenderGraphGetDiagnosticInfo(
+            fixture.hRenderGraph, &diagInfo, RPS_RENDER_GRAPH_DIAGNOSTIC_INFO_DEFAULT));
+        REQUIRE(diagInfo.numResourceInfos == chainInfo.numBuffers);
+
+        for (uint32_t iRes = 0; iRes < diagInfo.numResourceInfos; iRes++)
+        {
+            const RpsResourceDiagnosticInfo& resA = diagInfo.pResourceDiagInfos[iRes];
+
+            REQUIRE(resA.allocPlacement.heapId < diagInfo.numHeapInfos);
+            REQUIRE((resA.allocPlacement.offset + resA.allocRequirement.size) <=
+                    diagInfo.pHeapDiagInfos[resA.allocPlacement.heapId].size);
+
+            for (uint32_t jRes = iRes + 1; jRes < diagInfo.numResourceInfos; jRes++)
+            {
+                const RpsResourceDiagnosticInfo& resB = diagInfo.pResourceDiagInfos[jRes];
+
+                const bool bOverlap =
+                    (resA.allocPlacement.heapId == resB.allocPlacement.heapId) &&
+                    (resA.lifetimeBegin <= resB.lifetimeEnd) && (resB.lifetimeBegin <= resA.lifetimeEnd) &&
+                    (resA.allocPlacement.offset < (resB.allocPlacement.offset + resB.allocRequirement.size)) &&
+                    (resB.allocPlacement.offset < (resA.allocPlacement.offset + resA.allocRequirement.size));
+                REQUIRE(!bOverlap);
+            }
+        }
+    };
+
+    // Heaps are created with the default size, a single one holds the whole chain.
+    fnUpdate();
+    REQUIRE(diagInfo.numHeapInfos == 1);
+    REQUIRE(diagInfo.pHeapDiagInfos[0].size == DefaultHeapSize);
+
+    // Resources larger than the default heap size go to dedicated heaps sized to fit, aliasing among themselves.
+    chainInfo.bufferSize = 2 * DefaultHeapSize;
+    fnUpdate();
+    REQUIRE(diagInfo.numHeapInfos == 3);
+
+    for (uint32_t iRes = 0; iRes < diagInfo.numResourceInfos; iRes++)
+    {
+        const uint32_t heapId = diagInfo.pResourceDiagInfos[iRes].allocPlacement.heapId;
+        REQUIRE(heapId != 0);
+        REQUIRE(diagInfo.pHeapDiagInfos[heapId].size == chainInfo.bufferSize);
+    }
+
+    // Small buffers are packed into a single page of the default sized heap, sharing it by lifetime.
+    chainInfo.bufferSize = 1000;
+    fnUpdate();
+
+    for (uint32_t iRes = 0; iRes < diagInfo.numResourceInfos; iRes++)
+    {
+        const RpsHeapPlacement& placement = diagInfo.pResourceDiagInfos[iRes].allocPlacement;
+        REQUIRE(placement.heapId == 0);
+        REQUIRE(placement.offset < PageSize);
+        REQUIRE(placement.offset + chainInfo.bufferSize <= PageSize);
+    }
+
+    // Buffers two nodes apart share memory within the page.
+    REQUIRE(diagInfo.pResourceDiagInfos[0].allocPlacement.offset ==
+            diagInfo.pResourceDiagInfos[2].allocPlacement.offset);
+
+    // The placements of pooled resources are kept by later updates.
+    std::vector<RpsHeapPlacement> placements;
+    for (uint32_t iRes = 0; iRes < diagInfo.numResourceInfos; iRes++)
+    {
+        placements.push_back(diagInfo.pResourceDiagInfos[iRes].allocPlacement);
+    }
+
+    fnUpdate();
+
+    for (uint32_t iRes = 0; iRes < diagInfo.numResourceInfos; iRes++)
+    {
+        REQUIRE(diagInfo.pResourceDiagInfos[iRes].allocPlacement.heapId == placements[iRes].heapId);
+        REQUIRE(diagInfo.pResourceDiagInfos[iRes].allocPlacement.offset == placements[iRes].offset);
+    }
+
+    // Pages are opt-in. Without them, small buffers are placed like any other resource and no page is held.
+    fixture.createInfo.renderGraphFlags = RPS_RENDER_GRAPH_FLAG_NONE;
+    REQUIRE_RPS_OK(fixture.CreateRenderGraph());
+    fnUpdate();
+    REQUIRE(diagInfo.numHeapInfos == 1);
+    REQUIRE(diagInfo.pHeapDiagInfos[0].usedSize < PageSize);
+
+    fixture.Destroy();
+}
+
+// Writes all buffers first, then reads them. Scheduling every read right after its write keeps a single buffer live.
+static RpsResult buildWriteAllThenReadGraph(RpsRenderGraphBuilder hBuilder,
+                                            const RpsConstant*    ppArgs,
+                                            uint32_t              numArgs)
+{
+    using namespace rps;
+
+    REQUIRE(numArgs == 1);
+
+    const AliasingChainInfo* pInfo = static_cast<const AliasingChainInfo*>(ppArgs[0]);
+
+    const AccessAttr uavAccess(RPS_ACCESS_UNORDERED_ACCESS_BIT, RPS_SHADER_STAGE_CS);
+    const AccessAttr srvAccess(RPS_ACCESS_SHADER_RESOURCE_BIT, RPS_SHADER_STAGE_CS);
+
+    RpsNodeDeclId writeNode = rpsRenderGraphDeclareDynamicNode(
+        hBuilder, "Write", RPS_NODE_DECL_COMPUTE_BIT, {ParameterDesc::Make<BufferView>(uavAccess, "dst")});
+
+    RpsNodeDeclId readNode = rpsRenderGraphDeclareDynamicNode(
+        hBuilder, "Read", RPS_NODE_DECL_COMPUTE_BIT, {ParameterDesc::Make<BufferView>(srvAccess, "src")});
+
+    ResourceDesc* pBufferDesc = rpsRenderGraphAllocateData<ResourceDesc>(hBuilder);
+    BufferView*   pViews      = static_cast<BufferView*>(
+        rpsRenderGraphAllocateDataAligned(hBuilder, sizeof(BufferView) * pInfo->numBuffers, alignof(BufferView)));
+    REQUIRE(pBufferDesc);
+    REQUIRE(pViews);
+
+    *pBufferDesc = ResourceDesc::Buffer(pInfo->bufferSize);
+
+    for (uint32_t iView = 0; iView < pInfo->numBuffers; iView++)
+    {
+        pViews[iView] = BufferView{rpsRenderGraphDeclareResource(hBuilder, "Buffer", iView, pBufferDesc)};
+        rpsRenderGraphAddNode(
+            hBuilder, writeNode, iView, nullptr, nullptr, RPS_CMD_CALLBACK_FLAG_NONE, {&pViews[iView]});
+    }
+
+    for (uint32_t iView = 0; iView < pInfo->numBuffers; iView++)
+    {
+        rpsRenderGraphAddNode(hBuilder,
+                              readNode,
+                              pInfo->numBuffers + iView,
+                              nullptr,
+                              nullptr,
+                              RPS_CMD_CALLBACK_FLAG_NONE,
+                              {&pViews[iView]});
+    }
+
+    return RPS_OK;
+}
+
+static uint64_t GetTotalHeapSize(RpsRenderGraph hRenderGraph)
+{
+    RpsRenderGraphDiagnosticInfo diagInfo = {};
+    REQUIRE_RPS_OK(rpsRenderGraphGetDiagnosticInfo(hRenderGraph, &diagInfo, RPS_RENDER_GRAPH_DIAGNOSTIC_INFO_DEFAULT));
+
+    uint64_t totalSize = 0;
+    for (uint32_t iHeap = 0; iHeap < diagInfo.numHeapInfos; iHeap++)
+    {
+        totalSize += diagInfo.pHeapDiagInfos[iHeap].size;
+    }
+    return totalSize;
+}
+
+static std::string s_memoryBudgetLog;
+
+static void PrintToMemoryBudgetLog(void*, const char* formatString, ...)
+{
+    char buf[1024];
+
+    va_list args;
+    va_start(args, formatString);
+    vsnprintf(buf, sizeof(buf), formatString, args);
+    va_end(args);
+
+    s_memoryBudgetLog += buf;
+}
+
+TEST_CASE("MemoryBudget")
+{
+    // The null runtime device has a single memory type.
+    const uint32_t heapBudgetMiBs[] = {2};
+
+    AliasingChainInfo chainInfo = {4, 1024 * 1024};
+
+    RpsTestRenderGraphFixture fixture("MemoryBudget", &buildWriteAllThenReadGraph, &PrintToMemoryBudgetLog);
+    fixture.AddParam("chainInfo", &chainInfo);
+    fixture.createInfo.scheduleInfo.scheduleFlags = RPS_SCHEDULE_DISABLE_DEAD_CODE_ELIMINATION_BIT;
+
+    // Without a budget, the default schedule writes all buffers before reading any of them.
+    REQUIRE_RPS_OK(fixture.CreateRenderGraph());
+    REQUIRE_RPS_OK(fixture.Update());
+    REQUIRE(GetTotalHeapSize(fixture.hRenderGraph) == chainInfo.numBuffers * chainInfo.bufferSize);
+
+    // Over budget, the update is scheduled again preferring memory saving, which fits.
+    fixture.createInfo.memoryInfo.numHeaps       = RPS_TEST_COUNTOF(heapBudgetMiBs);
+    fixture.createInfo.memoryInfo.heapBudgetMiBs = heapBudgetMiBs;
+    REQUIRE_RPS_OK(fixture.CreateRenderGraph());
+
+    for (uint32_t iFrame = 0; iFrame < 3; iFrame++)
+    {
+        fixture.updateInfo.frameIndex = iFrame;
+        REQUIRE_RPS_OK(fixture.Update());
+        REQUIRE(GetTotalHeapSize(fixture.hRenderGraph) <= (uint64_t(heapBudgetMiBs[0]) << 20));
+    }
+
+    // A single buffer exceeds the budget no matter the schedule, report the resources live at the peak.
+    s_memoryBudgetLog.clear();
+    chainInfo.bufferSize = 4 * 1024 * 1024;
+    fixture.updateInfo.frameIndex++;
+    REQUIRE(fixture.Update() == RPS_ERROR_OUT_OF_MEMORY);
+    REQUIRE(s_memoryBudgetLog.find("Memory budget exceeded for memory type 0") != std::string::npos);
+    REQUIRE(s_memoryBudgetLog.find("'Buffer") != std::string::npos);
+
+    fixture.Destroy();
+}
+
+// Writes all buffers, then reads the first buffer together with each of the others. Which read of the first buffer
+// is the last one, and with it gets the discard flag from lifetime analysis, depends on the schedule.
+static RpsResult buildWriteAllThenReadShared(RpsRenderGraphBuilder hBuilder, const RpsConstant* ppArgs, uint32_t)
+{
+    using namespace rps;
+
+    const AliasingChainInfo* pInfo = static_cast<const AliasingChainInfo*>(ppArgs[0]);
+
+    const AccessAttr uavAccess(RPS_ACCESS_UNORDERED_ACCESS_BIT, RPS_SHADER_STAGE_CS);
+    const AccessAttr srvAccess(RPS_ACCESS_SHADER_RESOURCE_BIT, RPS_SHADER_STAGE_CS);
+
+    RpsNodeDeclId writeNode = rpsRenderGraphDeclareDynamicNode(
+        hBuilder,
+        "Write",
+        RPS_NODE_DECL_COMPUTE_BIT,
+        {ParameterDesc::Make<BufferView>(uavAccess, "dst", RPS_PARAMETER_FLAG_RESOURCE_BIT)});
+
+    RpsNodeDeclId readPairNode = rpsRenderGraphDeclareDynamicNode(
+        hBuilder,
+        "ReadPair",
+        RPS_NODE_DECL_COMPUTE_BIT,
+        {ParameterDesc::Make<BufferView>(srvAccess, "src0", RPS_PARAMETER_FLAG_RESOURCE_BIT),
+         ParameterDesc::Make<BufferView>(srvAccess, "src1", RPS_PARAMETER_FLAG_RESOURCE_BIT)});
+
+    ResourceDesc* pBufferDesc = rpsRenderGraphAllocateData<ResourceDesc>(hBuilder);
+    BufferView*   pViews      = static_cast<BufferView*>(
+        rpsRenderGraphAllocateDataAligned(hBuilder, sizeof(BufferView) * pInfo->numBuffers, alignof(BufferView)));
+    REQUIRE(pBufferDesc);
+    REQUIRE(pViews);
+
+    *pBufferDesc = ResourceDesc::Buffer(pInfo->bufferSize);
+
+    uint32_t nodeTag = 0;
+
+    for (uint32_t iBuffer = 0; iBuffer < pInfo->numBuffers; iBuffer++)
+    {
+        pViews[iBuffer] = BufferView{rpsRenderGraphDeclareResource(hBuilder, "Buffer", iBuffer, pBufferDesc)};
+
+        rpsRenderGraphAddNode(hBuilder,
+                              writeNode,
+                              nodeTag++,
+                              &AccessFlagsRecorder::RecordNode,
+                              nullptr,
+                              RPS_CMD_CALLBACK_FLAG_NONE,
+                              {&pViews[iBuffer]});
+    }
+
+    for (uint32_t iBuffer = 1; iBuffer < pInfo->numBuffers; iBuffer++)
+    {
+        rpsRenderGraphAddNode(hBuilder,
+                              readPairNode,
+                              nodeTag++,
+                              &AccessFlagsRecorder::RecordNode,
+                              nullptr,
+                              RPS_CMD_CALLBACK_FLAG_NONE,
+                              {&pViews[0], &pViews[iBuffer]});
+    }
+
+    return RPS_OK;
+}
+
+TEST_CASE("RescheduleAccessFlags")
+{
+    AliasingChainInfo   chainInfo = {4, 1024 * 1024};
+    AccessFlagsRecorder recorder;
+
+    std::mt19937             mt19937;
+    RpsRandomNumberGenerator randGen = {};
+    randGen.pContext                 = &mt19937;
+    randGen.pfnRandomUniformInt      = [](void* pContext, int32_t minVal, int32_t maxVal) {
+        return std::uniform_int_distribution<>(minVal, maxVal)(*static_cast<std::mt19937*>(pContext));
+    };
+
+    // Each memory feedback iteration computes a new random schedule, reordering the reads of the first buffer.
+    RpsTestRenderGraphFixture fixture("RescheduleAccessFlags", &buildWriteAllThenReadShared);
+    fixture.AddParam("chainInfo", &chainInfo);
+    fixture.createInfo.scheduleInfo.scheduleFlags =
+        RPS_SCHEDULE_DISABLE_DEAD_CODE_ELIMINATION_BIT | RPS_SCHEDULE_RANDOM_ORDER_BIT;
+    fixture.createInfo.scheduleInfo.numMemoryFeedbackIterations = 4;
+    fixture.updateInfo.pRandomNumberGenerator                   = &randGen;
+    REQUIRE_RPS_OK(fixture.CreateRenderGraph());
+
+    for (uint32_t iFrame = 0; iFrame < 32; iFrame++)
+    {
+        fixture.updateInfo.frameIndex = iFrame;
+        REQUIRE_RPS_OK(fixture.Update());
+
+        recorder.Record(fixture.hRenderGraph);
+
+        // Only the last access of each buffer in the final schedule may discard it afterwards, discard flags from
+        // a previous schedule of the same update must not be left behind.
+        for (size_t iAccess = 0; iAccess < recorder.accessFlags.size(); iAccess++)
+        {
+            const bool bIsLastAccess =
+                std::find(recorder.resourceIds.begin() + iAccess + 1,
+                          recorder.resourceIds.end(),
+                          recorder.resourceIds[iAccess]) == recorder.resourceIds.end();
+
+            REQUIRE(!!(recorder.accessFlags[iAccess] & RPS_ACCESS_DISCARD_DATA_AFTER_BIT) == bIsLastAccess);
+        }
+    }
+
+    fixture.Destroy();
+}
+
+TEST_CASE("MemoryFeedback")
+{
+    AliasingChainInfo chainInfo = {4, 1024 * 1024};
+
+    RpsTestRenderGraphFixture fixture("MemoryFeedback", &buildWriteAllThenReadGraph);
+    fixture.AddParam("chainInfo", &chainInfo);
+    fixture.createInfo.scheduleInfo.scheduleFlags =
+        RPS_SCHEDULE_DISABLE_DEAD_CODE_ELIMINATION_BIT | RPS_SCHEDULE_AVOID_RESCHEDULE_BIT;
+
+    // The default schedule batches all writes before the reads, so all buffers are live at once.
+    REQUIRE_RPS_OK(fixture.CreateRenderGraph());
+    REQUIRE_RPS_OK(fixture.Update());
+    REQUIRE(GetTotalHeapSize(fixture.hRenderGraph) == chainInfo.numBuffers * chainInfo.bufferSize);
+
+    // Feedback from the heap usage moves each read next to its write, without preferring memory saving up front.
+    fixture.createInfo.scheduleInfo.numMemoryFeedbackIterations = 4;
+    REQUIRE_RPS_OK(fixture.CreateRenderGraph());
+
+    for (uint32_t iFrame = 0; iFrame < 3; iFrame++)
+    {
+        fixture.updateInfo.frameIndex = iFrame;
+        REQUIRE_RPS_OK(fixture.Update());
+        REQUIRE(GetTotalHeapSize(fixture.hRenderGraph) == chainInfo.bufferSize);
+    }
+
+    // A changed graph is scheduled from scratch again.
+    chainInfo.numBuffers = 6;
+    fixture.updateInfo.frameIndex++;
+    REQUIRE_RPS_OK(fixture.Update());
+    REQUIRE(GetTotalHeapSize(fixture.hRenderGraph) == chainInfo.bufferSize);
+
+    fixture.Destroy();
+}
+
+// Writes the top mip of a texture, downsamples it mip by mip, then reads the last mip only.
+static RpsResult buildMipChainGraph(RpsRenderGraphBuilder hBuilder, const RpsConstant*, uint32_t)
+{
+    using namespace rps;
+
+    static constexpr uint32_t NumMips = 4;
+
+    const AccessAttr uavAccess(RPS_ACCESS_UNORDERED_ACCESS_BIT, RPS_SHADER_STAGE_CS);
+    const AccessAttr srvAccess(RPS_ACCESS_SHADER_RESOURCE_BIT, RPS_SHADER_STAGE_CS);
+
+    RpsNodeDeclId writeNode = rpsRenderGraphDeclareDynamicNode(
+        hBuilder, "Write", RPS_NODE_DECL_COMPUTE_BIT, {ParameterDesc::Make<ImageView>(uavAccess, "dst")});
+
+    RpsNodeDeclId downsampleNode =
+        rpsRenderGraphDeclareDynamicNode(hBuilder,
+                                         "Downsample",
+                                         RPS_NODE_DECL_COMPUTE_BIT,
+                                         {ParameterDesc::Make<ImageView>(srvAccess, "src"),
+                                          ParameterDesc::Make<ImageView>(uavAccess, "dst")});
+
+    RpsNodeDeclId readNode = rpsRenderGraphDeclareDynamicNode(
+        hBuilder, "Read", RPS_NODE_DECL_COMPUTE_BIT, {ParameterDesc::Make<ImageView>(srvAccess, "src")});
+
+    ResourceDesc* pTextureDesc = rpsRenderGraphAllocateData<ResourceDesc>(hBuilder);
+    ImageView*    pMipViews    = static_cast<ImageView*>(
+        rpsRenderGraphAllocateDataAligned(hBuilder, sizeof(ImageView) * NumMips, alignof(ImageView)));
+    REQUIRE(pTextureDesc);
+    REQUIRE(pMipViews);
+
+    *pTextureDesc = ResourceDesc::Image2D(RPS_FORMAT_R8G8B8A8_UNORM, 256, 256, 1, NumMips);
+
+    const RpsResourceId textureId = rpsRenderGraphDeclareResource(hBuilder, "MipChain", 0, pTextureDesc);
+
+    for (uint32_t iMip = 0; iMip < NumMips; iMip++)
+    {
+        pMipViews[iMip] = ImageView{
+            textureId, RPS_FORMAT_UNKNOWN, 0, RPS_RESOURCE_VIEW_FLAG_NONE, SubresourceRange(uint16_t(iMip))};
+    }
+
+    rpsRenderGraphAddNode(hBuilder, writeNode, 0, nullptr, nullptr, RPS_CMD_CALLBACK_FLAG_NONE, {&pMipViews[0]});
+
+    for (uint32_t iMip = 1; iMip < NumMips; iMip++)
+    {
+        rpsRenderGraphAddNode(hBuilder,
+                              downsampleNode,
+                              iMip,
+                              nullptr,
+                              nullptr,
+                              RPS_CMD_CALLBACK_FLAG_NONE,
+                              {&pMipViews[iMip - 1], &pMipViews[iMip]});
+    }
+
+    rpsRenderGraphAddNode(
+        hBuilder, readNode, NumMips, nullptr, nullptr, RPS_CMD_CALLBACK_FLAG_NONE, {&pMipViews[NumMips - 1]});
+
+    return RPS_OK;
+}
+
+TEST_CASE("SubresourceLifetimes")
+{
+    RpsTestRenderGraphFixture fixture("SubresourceLifetimes", &buildMipChainGraph);
+    fixture.createInfo.scheduleInfo.scheduleFlags =
+        RPS_SCHEDULE_KEEP_PROGRAM_ORDER_BIT | RPS_SCHEDULE_DISABLE_DEAD_CODE_ELIMINATION_BIT;
+
+    auto fnGetMipChainInfo = [&]() {
+        RpsRenderGraphDiagnosticInfo diagInfo = {};
+        REQUIRE_RPS_OK(rpsRenderGraphGetDiagnosticInfo(
+            fixture.hRenderGraph, &diagInfo, RPS_RENDER_GRAPH_DIAGNOSTIC_INFO_DEFAULT));
+        REQUIRE(diagInfo.numResourceInfos == 1);
+        return diagInfo.pResourceDiagInfos[0];
+    };
+
+    // Only resource lifetimes are recorded by default.
+    {
+        REQUIRE_RPS_OK(fixture.CreateRenderGraph());
+        REQUIRE_RPS_OK(fixture.Update());
+
+        const RpsResourceDiagnosticInfo mipChainInfo = fnGetMipChainInfo();
+        REQUIRE(mipChainInfo.numSubresourceLifetimes == 0);
+        REQUIRE(mipChainInfo.pSubresourceLifetimes == nullptr);
+    }
+
+    fixture.createInfo.renderGraphFlags = RPS_RENDER_GRAPH_SUBRESOURCE_LIFETIMES;
+    REQUIRE_RPS_OK(fixture.CreateRenderGraph());
+    REQUIRE_RPS_OK(fixture.Update());
+
+    const RpsResourceDiagnosticInfo mipChainInfo = fnGetMipChainInfo();
+    REQUIRE(mipChainInfo.numSubresourceLifetimes == 4);
+
+    const RpsSubresourceLifetime* pMipLifetimes = mipChainInfo.pSubresourceLifetimes;
+    REQUIRE(pMipLifetimes[0].lifetimeBegin == mipChainInfo.lifetimeBegin);
+    REQUIRE(pMipLifetimes[3].lifetimeEnd == mipChainInfo.lifetimeEnd);
+
+    // Each mip is dead once the next one is downsampled from it, long before the resource is.
+    for (uint32_t iMip = 0; iMip < mipChainInfo.numSubresourceLifetimes; iMip++)
+    {
+        REQUIRE(pMipLifetimes[iMip].lifetimeBegin <= pMipLifetimes[iMip].lifetimeEnd);
+        REQUIRE(mipChainInfo.lifetimeBegin <= pMipLifetimes[iMip].lifetimeBegin);
+        REQUIRE(pMipLifetimes[iMip].lifetimeEnd <= mipChainInfo.lifetimeEnd);
+
+        if (iMip > 0)
+        {
+            REQUIRE(pMipLifetimes[iMip - 1].lifetimeEnd < pMipLifetimes[iMip].lifetimeEnd);
+            REQUIRE(pMipLifetimes[iMip - 1].lifetimeBegin < pMipLifetimes[iMip].lifetimeBegin);
+        }
+    }
+
+    REQUIRE(pMipLifetimes[0].lifetimeEnd < pMipLifetimes[3].lifetimeBegin);
+
+    fixture.Destroy();
+}
+
+// Clears a texture array, writes each layer as a separate page, then reads the whole array.
+static RpsResult buildPagedArrayGraph(RpsRenderGraphBuilder hBuilder, const RpsConstant*, uint32_t)
+{
+    using namespace rps;
+
+    static constexpr uint32_t NumPages = 16;
+
+    const AccessAttr copyDestAccess(RPS_ACCESS_COPY_DEST_BIT, RPS_SHADER_STAGE_NONE);
+    const AccessAttr uavAccess(RPS_ACCESS_UNORDERED_ACCESS_BIT, RPS_SHADER_STAGE_CS);
+    const AccessAttr srvAccess(RPS_ACCESS_SHADER_RESOURCE_BIT, RPS_SHADER_STAGE_CS);
+
+    RpsNodeDeclId clearNode = rpsRenderGraphDeclareDynamicNode(
+        hBuilder, "Clear", RPS_NODE_DECL_COPY_BIT, {ParameterDesc::Make<ImageView>(copyDestAccess, "dst")});
+
+    RpsNodeDeclId pageNode = rpsRenderGraphDeclareDynamicNode(
+        hBuilder, "WritePage", RPS_NODE_DECL_COMPUTE_BIT, {ParameterDesc::Make<ImageView>(uavAccess, "dst")});
+
+    RpsNodeDeclId readNode = rpsRenderGraphDeclareDynamicNode(
+        hBuilder, "Read", RPS_NODE_DECL_COMPUTE_BIT, {ParameterDesc::Make<ImageView>(srvAccess, "src")});
+
+    ResourceDesc* pTextureDesc = rpsRenderGraphAllocateData<ResourceDesc>(hBuilder);
+    ImageView*    pViews       = static_cast<ImageView*>(
+        rpsRenderGraphAllocateDataAligned(hBuilder, sizeof(ImageView) * (NumPages + 1), alignof(ImageView)));
+    REQUIRE(pTextureDesc);
+    REQUIRE(pViews);
+
+    *pTextureDesc = ResourceDesc::Image2D(RPS_FORMAT_R8G8B8A8_UNORM, 128, 128, NumPages);
+
+    const RpsResourceId textureId = rpsRenderGraphDeclareResource(hBuilder, "PagedArray", 0, pTextureDesc);
+
+    for (uint32_t iPage = 0; iPage < NumPages; iPage++)
+    {
+        pViews[iPage] =
+            ImageView{textureId, RPS_FORMAT_UNKNOWN, 0, RPS_RESOURCE_VIEW_FLAG_NONE, SubresourceRange(0, 1, iPage, 1)};
+    }
+
+    pViews[NumPages] =
+        ImageView{textureId, RPS_FORMAT_UNKNOWN, 0, RPS_RESOURCE_VIEW_FLAG_NONE, SubresourceRange(0, 1, 0, NumPages)};
+
+    rpsRenderGraphAddNode(hBuilder, clearNode, 0, nullptr, nullptr, RPS_CMD_CALLBACK_FLAG_NONE, {&pViews[NumPages]});
+
+    for (uint32_t iPage = 0; iPage < NumPages; iPage++)
+    {
+        rpsRenderGraphAddNode(
+            hBuilder, pageNode, iPage + 1, nullptr, nullptr, RPS_CMD_CALLBACK_FLAG_NONE, {&pViews[iPage]});
+    }
+
+    rpsRenderGraphAddNode(
+        hBuilder, readNode, NumPages + 1, nullptr, nullptr, RPS_CMD_CALLBACK_FLAG_NONE, {&pViews[NumPages]});
+
+    return RPS_OK;
+}
+
+TEST_CASE("SubresourceStateCoalescing")
+{
+    RpsTestRenderGraphFixture fixture("SubresourceStateCoalescing", &buildPagedArrayGraph);
+    REQUIRE_RPS_OK(fixture.CreateRenderGraph());
+    REQUIRE_RPS_OK(fixture.Update());
+
+    RpsRenderGraphDiagnosticInfo diagInfo = {};
+    REQUIRE_RPS_OK(rpsRenderGraphGetDiagnosticInfo(
+        fixture.hRenderGraph, &diagInfo, RPS_RENDER_GRAPH_DIAGNOSTIC_INFO_DEFAULT));
+
+    uint32_t numClearTransitions = 0;
+    uint32_t numPageTransitions  = 0;
+    uint32_t numReadTransitions  = 0;
+
+    for (uint32_t iCmd = 0; iCmd < diagInfo.numCommandInfos; iCmd++)
+    {
+        const RpsCmdDiagnosticInfo& cmdInfo = diagInfo.pCmdDiagInfos[iCmd];
+        if (!cmdInfo.isTransition)
+        {
+            continue;
+        }
+
+        const RpsAccessFlags nextAccess = cmdInfo.transition.nextAccess.accessFlags;
+        const uint32_t       numLayers  = cmdInfo.transition.range.arrayLayers;
+
+        if (nextAccess & RPS_ACCESS_COPY_DEST_BIT)
+        {
+            numClearTransitions++;
+            REQUIRE(numLayers == 16);
+        }
+        else if (nextAccess & RPS_ACCESS_UNORDERED_ACCESS_BIT)
+        {
+            numPageTransitions++;
+            REQUIRE(numLayers == 1);
+        }
+        else if (nextAccess & RPS_ACCESS_SHADER_RESOURCE_BIT)
+        {
+            numReadTransitions++;
+            REQUIRE(numLayers == 16);
+        }
+    }
+
+    // Splitting the cleared state per page shares its transition, and the pages merge back before the full read.
+    REQUIRE(numClearTransitions <= 1);
+    REQUIRE(numPageTransitions == 16);
+    REQUIRE(numReadTransitions == 1);
+
+    fixture.Destroy();
+}
+
+struct CloneContextStressInfo
+{
+    uint32_t                                  numThreads;
+    uint32_t                                  numClonesPerThread;
+    std::vector<const RpsCmdCallbackContext*> clones;
+};
+
+static void CloneContextStressCallback(const RpsCmdCallbackContext* pContext)
+{
+    auto pStressInfo = static_cast<CloneContextStressInfo*>(pContext->pCmdCallbackContext);
+
+    const uint32_t numClonesPerThread = pStressInfo->numClonesPerThread;
+    const size_t   cloneBaseIndex     = pStressInfo->clones.size();
+
+    pStressInfo->clones.resize(cloneBaseIndex + pStressInfo->numThreads * numClonesPerThread);
+
+    std::vector<std::thread> threads;
+
+    for (uint32_t iThread = 0; iThread < pStressInfo->numThreads; iThread++)
+    {
+        threads.emplace_back([=]() {
+            const RpsCmdCallbackContext** ppClones =
+                pStressInfo->clones.data() + cloneBaseIndex + iThread * numClonesPerThread;
+
+            for (uint32_t iClone = 0; iClone < numClonesPerThread; iClone++)
+            {
+                // Alternate between cloning the primary context and the clone made by this thread before.
+                const RpsCmdCallbackContext* pSrcContext = ((iClone & 1) && (iClone > 0)) ? ppClones[iClone - 1] : pContext;
+                const RpsRuntimeCommandBuffer hCmdBuf    = {reinterpret_cast<void*>(uintptr_t(iThread + 1))};
+
+                if (RPS_FAILED(rpsCmdCloneContext(pSrcContext, hCmdBuf, &ppClones[iClone])))
+                {
+                    ppClones[iClone] = nullptr;
+                }
+            }
+        });
+    }
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+}
+
+RpsResult buildCloneContextStress(RpsRenderGraphBuilder hBuilder, const RpsConstant* ppArgs, uint32_t numArgs)
+{
+    using namespace rps;
+
+    REQUIRE(numArgs == 2);
+
+    RpsNodeDeclId cloneNode = rpsRenderGraphDeclareDynamicNode(
+        hBuilder,
+        "Clone",
+        RPS_NODE_DECL_FLAG_NONE,
+        {ParameterDesc::Make<ImageView>(AccessAttr(RPS_ACCESS_RENDER_TARGET_BIT), "renderTarget")});
+
+    ImageView* pBackBufferView = rpsRenderGraphAllocateData<ImageView>(hBuilder);
+    REQUIRE(pBackBufferView);
+
+    *pBackBufferView = ImageView{rpsRenderGraphGetParamResourceId(hBuilder, 0)};
+
+    auto pStressInfo = *static_cast<CloneContextStressInfo* const*>(ppArgs[1]);
+
+    for (uint32_t iNode = 0; iNode < 4; iNode++)
+    {
+        rpsRenderGraphAddNode(hBuilder,
+                              cloneNode,
+                              iNode,
+                              &CloneContextStressCallback,
+                              pStressInfo,
+                              RPS_CMD_CALLBACK_FLAG_NONE,
+                              {pBackBufferView});
+    }
+
+    return RPS_OK;
+}
+
+TEST_CASE("CloneContextMultiThreaded")
+{
+    const RpsResourceDesc backBufferResDesc = rpsTestUtilMakeBackBufferDesc(1280, 720);
+
+    CloneContextStressInfo  stressInfo  = {8, 1024, {}};
+    CloneContextStressInfo* pStressInfo = &stressInfo;
+
+    RpsTestRenderGraphFixture fixture("CloneContextStress", &buildCloneContextStress);
+    fixture.AddBackBufferParam(&backBufferResDesc);
+    fixture.AddParam("stressInfo", &pStressInfo);
+    REQUIRE_RPS_OK(fixture.CreateRenderGraph());
+
+    // Multiple frames so recycled arena blocks are exercised as well.
+    for (uint32_t iFrame = 0; iFrame < 4; iFrame++)
+    {
+        fixture.updateInfo.frameIndex = iFrame;
+        REQUIRE_RPS_OK(fixture.Update());
+
+        RpsRenderGraphBatchLayout batchLayout = {};
+        REQUIRE_RPS_OK(rpsRenderGraphGetBatchLayout(fixture.hRenderGraph, &batchLayout));
+
+        stressInfo.clones.clear();
+
+        for (uint32_t iBatch = 0; iBatch < batchLayout.numCmdBatches; iBatch++)
+        {
+            RpsRenderGraphRecordCommandInfo recordInfo = {};
+            recordInfo.frameIndex                      = iFrame;
+            recordInfo.cmdBeginIndex                   = batchLayout.pCmdBatches[iBatch].cmdBegin;
+            recordInfo.numCmds                         = batchLayout.pCmdBatches[iBatch].numCmds;
+
+            REQUIRE_RPS_OK(rpsRenderGraphRecordCommands(fixture.hRenderGraph, &recordInfo));
+        }
+
+        REQUIRE(stressInfo.clones.size() == 4 * stressInfo.numThreads * stressInfo.numClonesPerThread);
+
+        // Every clone must be a distinct allocation carrying the command buffer of the thread which created it.
+        const size_t numClonesPerNode = stressInfo.numThreads * stressInfo.numClonesPerThread;
+
+        for (size_t iClone = 0; iClone < stressInfo.clones.size(); iClone++)
+        {
+            const uint32_t iThread = uint32_t((iClone % numClonesPerNode) / stressInfo.numClonesPerThread);
+
+            REQUIRE(stressInfo.clones[iClone] != nullptr);
+            REQUIRE(stressInfo.clones[iClone]->hCommandBuffer.ptr == reinterpret_cast<void*>(uintptr_t(iThread + 1)));
+        }
+
+        std::vector<const RpsCmdCallbackContext*> sortedClones = stressInfo.clones;
+        std::sort(sortedClones.begin(), sortedClones.end());
+        REQUIRE(std::adjacent_find(sortedClones.begin(), sortedClones.end()) == sortedClones.end());
+    }
+
+    fixture.Destroy();
+}
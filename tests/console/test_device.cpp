@@ -13,7 +13,7 @@
 
 #include "utils/rps_test_common.h"
 
-void* FailingMalloc(void* pContext, size_t size, size_t alignment)
+void* FailingMalloc(void*, size_t, size_t)
 {
     return NULL;
 }
@@ -0,0 +1,933 @@
+// Copyright (c) 2024 Advanced Micro Devices, Inc.
+//
+// This file is part of the AMD Render Pipeline Shaders SDK which is
+// released under the MIT LICENSE.
+//
+// See file LICENSE.txt for full license details.
+
+#define CATCH_CONFIG_MAIN
+
+#include "rps/rps.h"
+
+#include "runtime/common/rps_heap_range_sweep.hpp"
+
+#include "utils/rps_test_common.h"
+#include "utils/rps_test_render_graph_fixture.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Performance tests on synthetic render graphs, run through the null runtime device.
+// These measure the render graph update time only, no GPU work is involved.
+
+struct WideGraphInfo
+{
+    uint32_t           numChains;
+    uint32_t           bufferSize;
+    PFN_rpsCmdCallback pfnNodeCallback;
+    RpsNodeDeclFlags   consumeDeclFlags;
+};
+
+// Builds numChains independent producer -> consumer chains, where every consumer also reads one shared buffer.
+// This gives a ready list as wide as the number of chains during scheduling.
+static RpsResult buildWideGraph(RpsRenderGraphBuilder hBuilder, const RpsConstant* ppArgs, uint32_t numArgs)
+{
+    using namespace rps;
+
+    REQUIRE(numArgs == 1);
+
+    const WideGraphInfo* pInfo = static_cast<const WideGraphInfo*>(ppArgs[0]);
+
+    const AccessAttr uavAccess(RPS_ACCESS_UNORDERED_ACCESS_BIT, RPS_SHADER_STAGE_CS);
+    const AccessAttr srvAccess(RPS_ACCESS_SHADER_RESOURCE_BIT, RPS_SHADER_STAGE_CS);
+
+    RpsNodeDeclId produce = rpsRenderGraphDeclareDynamicNode(
+        hBuilder, "Produce", RPS_NODE_DECL_COMPUTE_BIT, {ParameterDesc::Make<BufferView>(uavAccess, "dst")});
+
+    RpsNodeDeclId consume = rpsRenderGraphDeclareDynamicNode(hBuilder,
+                                                             "Consume",
+                                                             RPS_NODE_DECL_COMPUTE_BIT | pInfo->consumeDeclFlags,
+                                                             {ParameterDesc::Make<BufferView>(srvAccess, "src"),
+                                                              ParameterDesc::Make<BufferView>(srvAccess, "shared"),
+                                                              ParameterDesc::Make<BufferView>(uavAccess, "dst")});
+
+    const uint32_t numViews = pInfo->numChains * 2 + 1;
+
+    ResourceDesc* pBufferDesc = rpsRenderGraphAllocateData<ResourceDesc>(hBuilder);
+    BufferView*   pViews      = static_cast<BufferView*>(
+        rpsRenderGraphAllocateDataAligned(hBuilder, sizeof(BufferView) * numViews, alignof(BufferView)));
+    REQUIRE(pBufferDesc);
+    REQUIRE(pViews);
+
+    *pBufferDesc = ResourceDesc::Buffer(pInfo->bufferSize);
+
+    for (uint32_t iView = 0; iView < numViews; iView++)
+    {
+        pViews[iView] = BufferView{rpsRenderGraphDeclareResource(hBuilder, "Buffer", iView, pBufferDesc)};
+    }
+
+    BufferView* pSharedView = &pViews[numViews - 1];
+
+    rpsRenderGraphAddNode(
+        hBuilder, produce, numViews - 1, pInfo->pfnNodeCallback, nullptr, RPS_CMD_CALLBACK_FLAG_NONE, {pSharedView});
+
+    for (uint32_t iChain = 0; iChain < pInfo->numChains; iChain++)
+    {
+        BufferView* pSrcView = &pViews[iChain * 2];
+        BufferView* pDstView = &pViews[iChain * 2 + 1];
+
+        rpsRenderGraphAddNode(
+            hBuilder, produce, iChain * 2, pInfo->pfnNodeCallback, nullptr, RPS_CMD_CALLBACK_FLAG_NONE, {pSrcView});
+        rpsRenderGraphAddNode(hBuilder,
+                              consume,
+                              iChain * 2 + 1,
+                              pInfo->pfnNodeCallback,
+                              nullptr,
+                              RPS_CMD_CALLBACK_FLAG_NONE,
+                              {pSrcView, pSharedView, pDstView});
+    }
+
+    return RPS_OK;
+}
+
+TEST_CASE("ScheduleWideGraph")
+{
+    RpsQueueFlags queueFlags[] = {RPS_QUEUE_FLAG_GRAPHICS, RPS_QUEUE_FLAG_COMPUTE};
+
+    const uint32_t chainCounts[] = {64, 256, 1024};
+
+    WideGraphInfo graphInfo = {};
+
+    RpsTestRenderGraphFixture fixture("WideGraph", &buildWideGraph);
+    fixture.AddParam("graphInfo", &graphInfo);
+    fixture.createInfo.scheduleInfo.pQueueInfos   = queueFlags;
+    fixture.createInfo.scheduleInfo.scheduleFlags = RPS_SCHEDULE_DISABLE_DEAD_CODE_ELIMINATION_BIT;
+
+    for (uint32_t numQueues = 1; numQueues <= RPS_TEST_COUNTOF(queueFlags); numQueues++)
+    {
+        for (uint32_t numChains : chainCounts)
+        {
+            fixture.createInfo.scheduleInfo.numQueues = numQueues;
+            REQUIRE_RPS_OK(fixture.CreateRenderGraph());
+
+            graphInfo = {numChains, 64 * 1024, nullptr, RPS_NODE_DECL_FLAG_NONE};
+
+            static constexpr uint32_t NumFrames = 8;
+
+            // Time the ready node queue against the reference scheduler, which rescans every ready node per pick
+            // like the scheduler did before the queue.
+            const RpsDiagnosticFlags diagFlags[] = {RPS_DIAGNOSTIC_ENABLE_REFERENCE_SCHEDULER, RPS_DIAGNOSTIC_NONE};
+
+            double   msPerFrame[RPS_TEST_COUNTOF(diagFlags)] = {};
+            uint32_t numCommandInfos                         = 0;
+
+            for (uint32_t iMode = 0; iMode < RPS_TEST_COUNTOF(diagFlags); iMode++)
+            {
+                fixture.updateInfo.diagnosticFlags = diagFlags[iMode];
+
+                const auto timeBegin = std::chrono::high_resolution_clock::now();
+
+                for (uint32_t iFrame = 0; iFrame < NumFrames; iFrame++)
+                {
+                    fixture.updateInfo.frameIndex = iMode * NumFrames + iFrame;
+                    REQUIRE_RPS_OK(fixture.Update());
+                }
+
+                const auto timeEnd = std::chrono::high_resolution_clock::now();
+
+                RpsRenderGraphDiagnosticInfo diagInfo = {};
+                REQUIRE_RPS_OK(rpsRenderGraphGetDiagnosticInfo(
+                    fixture.hRenderGraph, &diagInfo, RPS_RENDER_GRAPH_DIAGNOSTIC_INFO_DEFAULT));
+
+                // Every chain node and the shared producer must be scheduled, along with their transitions.
+                REQUIRE(diagInfo.numCommandInfos >= (numChains * 2 + 1));
+
+                // Both schedulers must produce the same schedule.
+                REQUIRE(((iMode == 0) || (diagInfo.numCommandInfos == numCommandInfos)));
+                numCommandInfos = diagInfo.numCommandInfos;
+
+                msPerFrame[iMode] =
+                    std::chrono::duration<double, std::milli>(timeEnd - timeBegin).count() / NumFrames;
+            }
+
+            fixture.updateInfo.diagnosticFlags = RPS_DIAGNOSTIC_NONE;
+
+            printf("ScheduleWideGraph: %u queue(s), %4u chains, %5u runtime cmds: %8.3f ms / update full rescan, "
+                   "%8.3f ms / update ready queue\n",
+                   numQueues,
+                   numChains,
+                   numCommandInfos,
+                   msPerFrame[0],
+                   msPerFrame[1]);
+        }
+    }
+
+    fixture.Destroy();
+}
+
+struct TransientResourceGraphInfo
+{
+    uint32_t numResources;
+    uint32_t maxLifetime;
+};
+
+// Builds a chain of nodes where node i writes resource i and reads a resource written up to maxLifetime nodes
+// earlier. Buffer sizes vary between 64KiB and 4MiB, which gives a mix of lifetimes and sizes to place in heaps.
+static RpsResult buildTransientResourceGraph(RpsRenderGraphBuilder hBuilder,
+                                             const RpsConstant*    ppArgs,
+                                             uint32_t              numArgs)
+{
+    using namespace rps;
+
+    REQUIRE(numArgs == 1);
+
+    const TransientResourceGraphInfo* pInfo = static_cast<const TransientResourceGraphInfo*>(ppArgs[0]);
+
+    const AccessAttr uavAccess(RPS_ACCESS_UNORDERED_ACCESS_BIT, RPS_SHADER_STAGE_CS);
+    const AccessAttr srvAccess(RPS_ACCESS_SHADER_RESOURCE_BIT, RPS_SHADER_STAGE_CS);
+
+    RpsNodeDeclId produce = rpsRenderGraphDeclareDynamicNode(
+        hBuilder, "Produce", RPS_NODE_DECL_COMPUTE_BIT, {ParameterDesc::Make<BufferView>(uavAccess, "dst")});
+
+    RpsNodeDeclId transform = rpsRenderGraphDeclareDynamicNode(
+        hBuilder,
+        "Transform",
+        RPS_NODE_DECL_COMPUTE_BIT,
+        {ParameterDesc::Make<BufferView>(srvAccess, "src"), ParameterDesc::Make<BufferView>(uavAccess, "dst")});
+
+    ResourceDesc* pDescs = static_cast<ResourceDesc*>(rpsRenderGraphAllocateDataAligned(
+        hBuilder, sizeof(ResourceDesc) * pInfo->numResources, alignof(ResourceDesc)));
+    BufferView* pViews = static_cast<BufferView*>(
+        rpsRenderGraphAllocateDataAligned(hBuilder, sizeof(BufferView) * pInfo->numResources, alignof(BufferView)));
+    REQUIRE(pDescs);
+    REQUIRE(pViews);
+
+    uint32_t randState = 0x12345678u;
+
+    auto fnRand = [&randState]() {
+        randState = randState * 1664525u + 1013904223u;
+        return randState >> 8;
+    };
+
+    for (uint32_t iRes = 0; iRes < pInfo->numResources; iRes++)
+    {
+        pDescs[iRes] = ResourceDesc::Buffer(uint64_t(1 + fnRand() % 64) * 64 * 1024);
+        pViews[iRes] = BufferView{rpsRenderGraphDeclareResource(hBuilder, "Buffer", iRes, &pDescs[iRes])};
+    }
+
+    for (uint32_t iNode = 0; iNode < pInfo->numResources; iNode++)
+    {
+        const uint32_t lifetime = 1 + fnRand() % pInfo->maxLifetime;
+
+        if (iNode >= lifetime)
+        {
+            rpsRenderGraphAddNode(hBuilder,
+                                  transform,
+                                  iNode,
+                                  nullptr,
+                                  nullptr,
+                                  RPS_CMD_CALLBACK_FLAG_NONE,
+                                  {&pViews[iNode - lifetime], &pViews[iNode]});
+        }
+        else
+        {
+            rpsRenderGraphAddNode(
+                hBuilder, produce, iNode, nullptr, nullptr, RPS_CMD_CALLBACK_FLAG_NONE, {&pViews[iNode]});
+        }
+    }
+
+    return RPS_OK;
+}
+
+TEST_CASE("PlaceTransientResources")
+{
+    const uint32_t resourceCounts[] = {256, 1024, 4096};
+
+    const struct
+    {
+        RpsMemoryPlacementStrategy strategy;
+        const char*                name;
+    } strategies[] = {
+        {RPS_MEMORY_PLACEMENT_BEST_FIT, "best fit"},
+        {RPS_MEMORY_PLACEMENT_FIRST_FIT, "first fit"},
+        {RPS_MEMORY_PLACEMENT_MIN_MEMORY, "min memory"},
+    };
+
+    uint64_t peakHeapSizes[RPS_TEST_COUNTOF(strategies)][RPS_TEST_COUNTOF(resourceCounts)] = {};
+
+    TransientResourceGraphInfo graphInfo = {};
+
+    RpsTestRenderGraphFixture fixture("TransientResources", &buildTransientResourceGraph);
+    fixture.AddParam("graphInfo", &graphInfo);
+    fixture.createInfo.scheduleInfo.scheduleFlags =
+        RPS_SCHEDULE_KEEP_PROGRAM_ORDER_BIT | RPS_SCHEDULE_DISABLE_DEAD_CODE_ELIMINATION_BIT;
+
+    for (uint32_t iStrategy = 0; iStrategy < RPS_TEST_COUNTOF(strategies); iStrategy++)
+    {
+        for (uint32_t iCount = 0; iCount < RPS_TEST_COUNTOF(resourceCounts); iCount++)
+        {
+            const uint32_t numResources = resourceCounts[iCount];
+
+            fixture.createInfo.memoryInfo.placementStrategy = strategies[iStrategy].strategy;
+            REQUIRE_RPS_OK(fixture.CreateRenderGraph());
+
+            graphInfo = {numResources, 64};
+
+            // Time the first update, which also creates the heaps, separately from the following ones.
+            const auto firstBegin = std::chrono::high_resolution_clock::now();
+            REQUIRE_RPS_OK(fixture.Update());
+            const auto firstEnd = std::chrono::high_resolution_clock::now();
+
+            static constexpr uint32_t NumFrames = 8;
+
+            for (uint32_t iFrame = 1; iFrame <= NumFrames; iFrame++)
+            {
+                fixture.updateInfo.frameIndex = iFrame;
+                REQUIRE_RPS_OK(fixture.Update());
+            }
+
+            const auto steadyEnd = std::chrono::high_resolution_clock::now();
+
+            RpsRenderGraphDiagnosticInfo diagInfo = {};
+            REQUIRE_RPS_OK(rpsRenderGraphGetDiagnosticInfo(
+                fixture.hRenderGraph, &diagInfo, RPS_RENDER_GRAPH_DIAGNOSTIC_INFO_DEFAULT));
+
+            REQUIRE(diagInfo.numResourceInfos == numResources);
+
+            // No two resources may overlap in both lifetime and heap range.
+            for (uint32_t iRes = 0; iRes < diagInfo.numResourceInfos; iRes++)
+            {
+                const RpsResourceDiagnosticInfo& resA = diagInfo.pResourceDiagInfos[iRes];
+
+                for (uint32_t jRes = iRes + 1; jRes < diagInfo.numResourceInfos; jRes++)
+                {
+                    const RpsResourceDiagnosticInfo& resB = diagInfo.pResourceDiagInfos[jRes];
+
+                    const uint64_t endA = resA.allocPlacement.offset + resA.allocRequirement.size;
+                    const uint64_t endB = resB.allocPlacement.offset + resB.allocRequirement.size;
+
+                    const bool bOverlap = (resA.allocPlacement.heapId == resB.allocPlacement.heapId) &&
+                                          (resA.lifetimeBegin <= resB.lifetimeEnd) &&
+                                          (resB.lifetimeBegin <= resA.lifetimeEnd) &&
+                                          (resA.allocPlacement.offset < endB) && (resB.allocPlacement.offset < endA);
+                    REQUIRE(!bOverlap);
+                }
+            }
+
+            uint64_t totalHeapSize = 0;
+
+            for (uint32_t iHeap = 0; iHeap < diagInfo.numHeapInfos; iHeap++)
+            {
+                totalHeapSize += diagInfo.pHeapDiagInfos[iHeap].maxUsedSize;
+            }
+
+            peakHeapSizes[iStrategy][iCount] = totalHeapSize;
+
+            printf("PlaceTransientResources: %-10s %4u resources, %3u heaps, %7.1f MiB peak: %8.3f ms first update, "
+                   "%8.3f ms / update\n",
+                   strategies[iStrategy].name,
+                   numResources,
+                   diagInfo.numHeapInfos,
+                   double(totalHeapSize) / (1024.0 * 1024.0),
+                   std::chrono::duration<double, std::milli>(firstEnd - firstBegin).count(),
+                   std::chrono::duration<double, std::milli>(steadyEnd - firstEnd).count() / NumFrames);
+        }
+    }
+
+    // Min memory packing also tries the best fit and first fit layouts, so it never uses more memory than either.
+    for (uint32_t iCount = 0; iCount < RPS_TEST_COUNTOF(resourceCounts); iCount++)
+    {
+        REQUIRE(peakHeapSizes[2][iCount] <= peakHeapSizes[0][iCount]);
+        REQUIRE(peakHeapSizes[2][iCount] <= peakHeapSizes[1][iCount]);
+    }
+
+    fixture.Destroy();
+}
+
+// The loop resource aliasing used before rps::HeapRangeSweep, as the baseline of the ResourceAliasing benchmark.
+// Clips the current range against every live heap range, live ranges are kept unsorted.
+static void ClipLoopPlace(std::vector<rps::HeapRangeUsage>&          heapRangeUsages,
+                          const rps::HeapRangeUsage&                 currentResourceRange,
+                          std::vector<std::pair<uint32_t, uint32_t>>& aliasingPairs)
+{
+    rps::HeapRangeUsage complementParts[2];
+
+    const uint32_t initialNumActiveRanges = uint32_t(heapRangeUsages.size());
+
+    for (uint32_t iRange = 0; iRange < std::min(initialNumActiveRanges, uint32_t(heapRangeUsages.size())); iRange++)
+    {
+        if (heapRangeUsages[iRange].heapIndex != currentResourceRange.heapIndex)
+        {
+            continue;
+        }
+
+        uint32_t clipResultMask = 0;
+
+        if (rps::HeapRangeClip(&currentResourceRange, &heapRangeUsages[iRange], complementParts, clipResultMask))
+        {
+            aliasingPairs.emplace_back(heapRangeUsages[iRange].resourceIndex, currentResourceRange.resourceIndex);
+
+            if (clipResultMask & 0x1)
+            {
+                heapRangeUsages[iRange] = complementParts[0];
+
+                if (clipResultMask & 0x2)
+                {
+                    heapRangeUsages.push_back(complementParts[1]);
+                }
+            }
+            else if (clipResultMask == 0x2)
+            {
+                heapRangeUsages[iRange] = complementParts[1];
+            }
+            else  // fully overlap
+            {
+                heapRangeUsages[iRange] = heapRangeUsages.back();
+                heapRangeUsages.pop_back();
+
+                iRange--;
+            }
+        }
+    }
+
+    heapRangeUsages.push_back(currentResourceRange);
+}
+
+// Compares the sweep resource aliasing places the resources with, against the clip loop it replaced, on the same
+// placements. Many small ranges at random offsets keep many heap ranges live at a time, the worst case for the clip
+// loop. Both must find the same aliasing pairs and end with the same heap ranges.
+TEST_CASE("ResourceAliasing")
+{
+    const uint32_t resourceCounts[] = {1024, 4096, 8192};
+
+    static constexpr uint32_t NumRuns    = 4;
+    static constexpr uint32_t NumHeaps   = 4;
+    static constexpr uint64_t HeapSize   = 256ull << 20;
+    static constexpr uint64_t RangeAlign = 64 << 10;
+
+    RpsAllocator allocator = {
+        &CountedMalloc,
+        &CountedFree,
+        &CountedRealloc,
+        nullptr,
+    };
+
+    std::mt19937 mt19937;
+
+    for (uint32_t iCount = 0; iCount < RPS_TEST_COUNTOF(resourceCounts); iCount++)
+    {
+        const uint32_t numResources = resourceCounts[iCount];
+
+        // Ranges in the order their resource lifetimes begin.
+        std::vector<rps::HeapRangeUsage> placements(numResources);
+
+        for (uint32_t iRes = 0; iRes < numResources; iRes++)
+        {
+            rps::HeapRangeUsage& range = placements[iRes];
+
+            const uint64_t size      = std::uniform_int_distribution<uint64_t>(1, 64)(mt19937) * RangeAlign;
+            const uint64_t maxOffset = HeapSize - size;
+
+            range.size          = size;
+            range.heapOffset    = std::uniform_int_distribution<uint64_t>(0, maxOffset / RangeAlign)(mt19937);
+            range.heapOffset    = range.heapOffset * RangeAlign;
+            range.heapIndex     = std::uniform_int_distribution<uint32_t>(0, NumHeaps - 1)(mt19937);
+            range.resourceIndex = iRes;
+        }
+
+        double msPerRun[2] = {};
+
+        std::vector<std::pair<uint32_t, uint32_t>> aliasingPairs[2];
+        std::vector<rps::HeapRangeUsage>           finalRanges[2];
+
+        for (uint32_t iRun = 0; iRun < NumRuns; iRun++)
+        {
+            aliasingPairs[0].clear();
+            aliasingPairs[1].clear();
+
+            std::vector<rps::HeapRangeUsage> heapRangeUsages;
+
+            const auto clipBegin = std::chrono::high_resolution_clock::now();
+
+            for (const rps::HeapRangeUsage& range : placements)
+            {
+                ClipLoopPlace(heapRangeUsages, range, aliasingPairs[0]);
+            }
+
+            const auto clipEnd = std::chrono::high_resolution_clock::now();
+
+            RPS_TEST_MALLOC_CHECKPOINT(0);
+
+            {
+                rps::Arena arena(allocator);
+
+                const auto sweepBegin = std::chrono::high_resolution_clock::now();
+
+                rps::HeapRangeSweep heapRangeSweep(&arena);
+                REQUIRE(heapRangeSweep.reserve(numResources * 2 + 1));
+
+                RpsResult result = RPS_OK;
+
+                for (uint32_t iRes = 0; (iRes < numResources) && (result == RPS_OK); iRes++)
+                {
+                    result = heapRangeSweep.Place(placements[iRes], [&](uint32_t srcResourceIndex) {
+                        aliasingPairs[1].emplace_back(srcResourceIndex, iRes);
+                        return RPS_OK;
+                    });
+                }
+
+                const auto sweepEnd = std::chrono::high_resolution_clock::now();
+
+                REQUIRE_RPS_OK(result);
+
+                finalRanges[1].assign(heapRangeSweep.GetRanges().begin(), heapRangeSweep.GetRanges().end());
+
+                msPerRun[0] += std::chrono::duration<double, std::milli>(clipEnd - clipBegin).count();
+                msPerRun[1] += std::chrono::duration<double, std::milli>(sweepEnd - sweepBegin).count();
+            }
+
+            RPS_TEST_MALLOC_COUNTER_EQUAL_CURRENT(0);
+
+            finalRanges[0] = std::move(heapRangeUsages);
+        }
+
+        // The clip loop visits the live ranges in no particular order, and keeps them unsorted.
+        const auto fnRangeLess = [](const rps::HeapRangeUsage& lhs, const rps::HeapRangeUsage& rhs) {
+            return (lhs.heapIndex < rhs.heapIndex) ||
+                   ((lhs.heapIndex == rhs.heapIndex) && (lhs.heapOffset < rhs.heapOffset));
+        };
+
+        std::sort(aliasingPairs[0].begin(), aliasingPairs[0].end());
+        std::sort(aliasingPairs[1].begin(), aliasingPairs[1].end());
+        std::sort(finalRanges[0].begin(), finalRanges[0].end(), fnRangeLess);
+
+        REQUIRE(aliasingPairs[0] == aliasingPairs[1]);
+        REQUIRE(finalRanges[0].size() == finalRanges[1].size());
+
+        for (size_t iRange = 0; iRange < finalRanges[0].size(); iRange++)
+        {
+            REQUIRE(finalRanges[0][iRange].heapIndex == finalRanges[1][iRange].heapIndex);
+            REQUIRE(finalRanges[0][iRange].heapOffset == finalRanges[1][iRange].heapOffset);
+            REQUIRE(finalRanges[0][iRange].size == finalRanges[1][iRange].size);
+            REQUIRE(finalRanges[0][iRange].resourceIndex == finalRanges[1][iRange].resourceIndex);
+        }
+
+        printf("ResourceAliasing: %5u resources, %5u live ranges, %6u aliasing pairs: %8.3f ms clip loop, %8.3f ms "
+               "sweep\n",
+               numResources,
+               uint32_t(finalRanges[1].size()),
+               uint32_t(aliasingPairs[1].size()),
+               msPerRun[0] / NumRuns,
+               msPerRun[1] / NumRuns);
+    }
+}
+
+struct MipChainGraphInfo
+{
+    uint32_t numTextures;
+    uint32_t numArrayLayers;
+    uint32_t numMips;
+};
+
+// Builds numTextures independent texture arrays, each written as a whole, downsampled one layer and mip at a time and
+// read as a whole. Every downsample splits the subresource states of its texture.
+static RpsResult buildMipChainGraph(RpsRenderGraphBuilder hBuilder, const RpsConstant* ppArgs, uint32_t numArgs)
+{
+    using namespace rps;
+
+    REQUIRE(numArgs == 1);
+
+    const MipChainGraphInfo* pInfo = static_cast<const MipChainGraphInfo*>(ppArgs[0]);
+
+    const AccessAttr uavAccess(RPS_ACCESS_UNORDERED_ACCESS_BIT, RPS_SHADER_STAGE_CS);
+    const AccessAttr srvAccess(RPS_ACCESS_SHADER_RESOURCE_BIT, RPS_SHADER_STAGE_CS);
+
+    RpsNodeDeclId writeNode = rpsRenderGraphDeclareDynamicNode(
+        hBuilder, "Write", RPS_NODE_DECL_COMPUTE_BIT, {ParameterDesc::Make<ImageView>(uavAccess, "dst")});
+
+    RpsNodeDeclId downsampleNode =
+        rpsRenderGraphDeclareDynamicNode(hBuilder,
+                                         "Downsample",
+                                         RPS_NODE_DECL_COMPUTE_BIT,
+                                         {ParameterDesc::Make<ImageView>(srvAccess, "src"),
+                                          ParameterDesc::Make<ImageView>(uavAccess, "dst")});
+
+    RpsNodeDeclId readNode = rpsRenderGraphDeclareDynamicNode(
+        hBuilder, "Read", RPS_NODE_DECL_COMPUTE_BIT, {ParameterDesc::Make<ImageView>(srvAccess, "src")});
+
+    const uint32_t numSubresources = pInfo->numArrayLayers * pInfo->numMips;
+
+    ResourceDesc* pTextureDesc = rpsRenderGraphAllocateData<ResourceDesc>(hBuilder);
+    ImageView*    pViews       = static_cast<ImageView*>(rpsRenderGraphAllocateDataAligned(
+        hBuilder, sizeof(ImageView) * (numSubresources + 1) * pInfo->numTextures, alignof(ImageView)));
+    REQUIRE(pTextureDesc);
+    REQUIRE(pViews);
+
+    *pTextureDesc =
+        ResourceDesc::Image2D(RPS_FORMAT_R8G8B8A8_UNORM, 256, 256, pInfo->numArrayLayers, pInfo->numMips);
+
+    for (uint32_t iTexture = 0; iTexture < pInfo->numTextures; iTexture++)
+    {
+        const RpsResourceId textureId = rpsRenderGraphDeclareResource(hBuilder, "Texture", iTexture, pTextureDesc);
+
+        ImageView* pTextureViews = &pViews[(numSubresources + 1) * iTexture];
+        ImageView* pFullView     = &pTextureViews[numSubresources];
+
+        *pFullView = ImageView{textureId,
+                               RPS_FORMAT_UNKNOWN,
+                               0,
+                               RPS_RESOURCE_VIEW_FLAG_NONE,
+                               SubresourceRange(0, uint16_t(pInfo->numMips), 0, pInfo->numArrayLayers)};
+
+        rpsRenderGraphAddNode(hBuilder, writeNode, 0, nullptr, nullptr, RPS_CMD_CALLBACK_FLAG_NONE, {pFullView});
+
+        for (uint32_t iLayer = 0; iLayer < pInfo->numArrayLayers; iLayer++)
+        {
+            ImageView* pLayerViews = &pTextureViews[iLayer * pInfo->numMips];
+
+            for (uint32_t iMip = 0; iMip < pInfo->numMips; iMip++)
+            {
+                pLayerViews[iMip] = ImageView{textureId,
+                                              RPS_FORMAT_UNKNOWN,
+                                              0,
+                                              RPS_RESOURCE_VIEW_FLAG_NONE,
+                                              SubresourceRange(uint16_t(iMip), 1, iLayer)};
+            }
+
+            for (uint32_t iMip = 1; iMip < pInfo->numMips; iMip++)
+            {
+                rpsRenderGraphAddNode(hBuilder,
+                                      downsampleNode,
+                                      iMip,
+                                      nullptr,
+                                      nullptr,
+                                      RPS_CMD_CALLBACK_FLAG_NONE,
+                                      {&pLayerViews[iMip - 1], &pLayerViews[iMip]});
+            }
+        }
+
+        rpsRenderGraphAddNode(hBuilder, readNode, 0, nullptr, nullptr, RPS_CMD_CALLBACK_FLAG_NONE, {pFullView});
+    }
+
+    return RPS_OK;
+}
+
+TEST_CASE("BuildAccessDAG")
+{
+    // 6 * 8 subresources fit in a mask, 12 * 8 don't.
+    const MipChainGraphInfo graphInfos[] = {{64, 6, 8}, {256, 6, 8}, {64, 12, 8}};
+
+    MipChainGraphInfo graphInfo = {};
+
+    RpsTestRenderGraphFixture fixture("MipChains", &buildMipChainGraph);
+    fixture.AddParam("graphInfo", &graphInfo);
+    fixture.createInfo.scheduleInfo.scheduleFlags =
+        RPS_SCHEDULE_KEEP_PROGRAM_ORDER_BIT | RPS_SCHEDULE_DISABLE_DEAD_CODE_ELIMINATION_BIT;
+
+    for (const MipChainGraphInfo& mipChainInfo : graphInfos)
+    {
+        REQUIRE_RPS_OK(fixture.CreateRenderGraph());
+
+        graphInfo = mipChainInfo;
+
+        static constexpr uint32_t NumFrames = 8;
+
+        const auto timeBegin = std::chrono::high_resolution_clock::now();
+
+        for (uint32_t iFrame = 0; iFrame < NumFrames; iFrame++)
+        {
+            fixture.updateInfo.frameIndex = iFrame;
+            REQUIRE_RPS_OK(fixture.Update());
+        }
+
+        const auto timeEnd = std::chrono::high_resolution_clock::now();
+
+        RpsRenderGraphDiagnosticInfo diagInfo = {};
+        REQUIRE_RPS_OK(rpsRenderGraphGetDiagnosticInfo(
+            fixture.hRenderGraph, &diagInfo, RPS_RENDER_GRAPH_DIAGNOSTIC_INFO_DEFAULT));
+
+        printf("BuildAccessDAG: %4u textures of %3u subresources, %6u runtime cmds: %8.3f ms / update\n",
+               graphInfo.numTextures,
+               graphInfo.numArrayLayers * graphInfo.numMips,
+               diagInfo.numCommandInfos,
+               std::chrono::duration<double, std::milli>(timeEnd - timeBegin).count() / NumFrames);
+    }
+
+    fixture.Destroy();
+}
+
+// Minimal task system running each task of a job on its own thread.
+struct ThreadTaskSystem
+{
+    std::atomic<uint32_t> numJobs = {};
+
+    static void* EnqueueJob(void* pUserContext, PFN_rpsTask pfnTask, void* pTaskContext, uint32_t numTasks)
+    {
+        static_cast<ThreadTaskSystem*>(pUserContext)->numJobs++;
+
+        auto pThreads = new std::vector<std::thread>();
+        for (uint32_t iTask = 0; iTask < numTasks; iTask++)
+        {
+            pThreads->emplace_back(pfnTask, pTaskContext, iTask);
+        }
+        return pThreads;
+    }
+
+    static void WaitJob(void*, void* hJob)
+    {
+        auto pThreads = static_cast<std::vector<std::thread>*>(hJob);
+        for (auto& thread : *pThreads)
+        {
+            thread.join();
+        }
+        delete pThreads;
+    }
+};
+
+TEST_CASE("ParallelTaskSystem")
+{
+    ThreadTaskSystem taskSystem;
+
+    std::vector<RpsResourceDiagnosticInfo> resourceInfos[2];
+
+    WideGraphInfo graphInfo = {512, 64 * 1024, nullptr, RPS_NODE_DECL_FLAG_NONE};
+
+    RpsTestRenderGraphFixture fixture("WideGraph", &buildWideGraph);
+    fixture.AddParam("graphInfo", &graphInfo);
+    fixture.createInfo.scheduleInfo.scheduleFlags = RPS_SCHEDULE_DISABLE_DEAD_CODE_ELIMINATION_BIT;
+
+    for (uint32_t iPass = 0; iPass < 2; iPass++)
+    {
+        const bool bParallel = (iPass == 1);
+
+        if (bParallel)
+        {
+            fixture.createInfo.taskSystem.pfnEnqueueJob    = &ThreadTaskSystem::EnqueueJob;
+            fixture.createInfo.taskSystem.pfnWaitJob       = &ThreadTaskSystem::WaitJob;
+            fixture.createInfo.taskSystem.numWorkerThreads = 4;
+            fixture.createInfo.taskSystem.pUserContext     = &taskSystem;
+        }
+
+        REQUIRE_RPS_OK(fixture.CreateRenderGraph());
+
+        for (uint32_t iFrame = 0; iFrame < 3; iFrame++)
+        {
+            fixture.updateInfo.frameIndex = iFrame;
+            REQUIRE_RPS_OK(fixture.Update());
+        }
+
+        RpsRenderGraphDiagnosticInfo diagInfo = {};
+        REQUIRE_RPS_OK(rpsRenderGraphGetDiagnosticInfo(
+            fixture.hRenderGraph, &diagInfo, RPS_RENDER_GRAPH_DIAGNOSTIC_INFO_DEFAULT));
+
+        resourceInfos[iPass].assign(diagInfo.pResourceDiagInfos,
+                                    diagInfo.pResourceDiagInfos + diagInfo.numResourceInfos);
+    }
+
+    // Parallel updates must have used the task system and produce the same lifetimes and placements.
+    CHECK(taskSystem.numJobs > 0);
+
+    REQUIRE(resourceInfos[0].size() == resourceInfos[1].size());
+
+    for (size_t iRes = 0; iRes < resourceInfos[0].size(); iRes++)
+    {
+        const auto& serialInfo   = resourceInfos[0][iRes];
+        const auto& parallelInfo = resourceInfos[1][iRes];
+
+        CHECK(serialInfo.lifetimeBegin == parallelInfo.lifetimeBegin);
+        CHECK(serialInfo.lifetimeEnd == parallelInfo.lifetimeEnd);
+        CHECK(serialInfo.allocPlacement.heapId == parallelInfo.allocPlacement.heapId);
+        CHECK(serialInfo.allocPlacement.offset == parallelInfo.allocPlacement.offset);
+    }
+
+    fixture.Destroy();
+}
+
+struct ExecuteTestContext
+{
+    struct RecordedNode
+    {
+        void* const* ppArgs;
+        uintptr_t    cmdBuf;
+    };
+
+    std::mutex                recordMutex;
+    std::vector<RecordedNode> recordedNodes;
+    std::vector<uint32_t>     cmdBufQueues;
+    std::vector<bool>         cmdBufSubmitted;
+    std::vector<bool>         fenceSignaled;
+    uint32_t                  numSubmits   = 0;
+    bool                      bFencesValid = true;
+
+    static void RecordNode(const RpsCmdCallbackContext* pContext)
+    {
+        auto pThis = static_cast<ExecuteTestContext*>(pContext->pUserRecordContext);
+
+        // Node arguments are stored per node, so their address identifies the node.
+        std::lock_guard<std::mutex> lock(pThis->recordMutex);
+        pThis->recordedNodes.push_back({pContext->ppArgs, reinterpret_cast<uintptr_t>(pContext->hCommandBuffer.ptr)});
+    }
+
+    static RpsResult AcquireCmdBufs(void*                    pUserContext,
+                                    uint32_t                 queueIndex,
+                                    uint32_t                 numCmdBuffers,
+                                    RpsRuntimeCommandBuffer* pCmdBuffers)
+    {
+        auto pThis = static_cast<ExecuteTestContext*>(pUserContext);
+
+        for (uint32_t iCmdBuf = 0; iCmdBuf < numCmdBuffers; iCmdBuf++)
+        {
+            // Handle values are 1-based indices into cmdBufQueues.
+            pThis->cmdBufQueues.push_back(queueIndex);
+            pThis->cmdBufSubmitted.push_back(false);
+            pCmdBuffers[iCmdBuf] = {reinterpret_cast<void*>(uintptr_t(pThis->cmdBufQueues.size()))};
+        }
+
+        return RPS_OK;
+    }
+
+    static RpsResult SubmitCmdBufs(void*                          pUserContext,
+                                   uint32_t                       queueIndex,
+                                   const RpsRuntimeCommandBuffer* pRuntimeCmdBufs,
+                                   uint32_t                       numRuntimeCmdBufs,
+                                   const uint32_t*                pWaitFenceIndices,
+                                   uint32_t                       numWaitFences,
+                                   uint32_t                       signalFenceIndex)
+    {
+        auto pThis = static_cast<ExecuteTestContext*>(pUserContext);
+
+        pThis->numSubmits++;
+
+        for (uint32_t iCmdBuf = 0; iCmdBuf < numRuntimeCmdBufs; iCmdBuf++)
+        {
+            const uintptr_t cmdBufIndex = reinterpret_cast<uintptr_t>(pRuntimeCmdBufs[iCmdBuf].ptr) - 1;
+
+            if ((pThis->cmdBufQueues[cmdBufIndex] != queueIndex) || pThis->cmdBufSubmitted[cmdBufIndex])
+            {
+                return RPS_ERROR_INVALID_OPERATION;
+            }
+
+            pThis->cmdBufSubmitted[cmdBufIndex] = true;
+        }
+
+        // Every waited fence must have been signaled by an earlier submission.
+        for (uint32_t iFence = 0; iFence < numWaitFences; iFence++)
+        {
+            const uint32_t fenceIndex = pWaitFenceIndices[iFence];
+            pThis->bFencesValid &= (fenceIndex < pThis->fenceSignaled.size()) && pThis->fenceSignaled[fenceIndex];
+        }
+
+        if (signalFenceIndex != RPS_INDEX_NONE_U32)
+        {
+            pThis->fenceSignaled.resize(std::max(pThis->fenceSignaled.size(), size_t(signalFenceIndex + 1)));
+            pThis->fenceSignaled[signalFenceIndex] = true;
+        }
+
+        return RPS_OK;
+    }
+
+    static uint32_t GetCmdRecordCost(void*, RpsNodeId nodeId)
+    {
+        return (nodeId % 3) + 1;
+    }
+};
+
+TEST_CASE("ExecuteParallelRecording")
+{
+    RpsQueueFlags queueFlags[] = {RPS_QUEUE_FLAG_GRAPHICS, RPS_QUEUE_FLAG_COMPUTE};
+
+    ThreadTaskSystem taskSystem;
+
+    // Async consumers give batches on both queues, synchronized with fences.
+    WideGraphInfo graphInfo = {256, 64 * 1024, &ExecuteTestContext::RecordNode, RPS_NODE_DECL_PREFER_ASYNC};
+
+    RpsTestRenderGraphFixture fixture("WideGraph", &buildWideGraph);
+    fixture.AddParam("graphInfo", &graphInfo);
+    fixture.createInfo.scheduleInfo.pQueueInfos   = queueFlags;
+    fixture.createInfo.scheduleInfo.scheduleFlags = RPS_SCHEDULE_DISABLE_DEAD_CODE_ELIMINATION_BIT;
+
+    for (uint32_t numQueues = 1; numQueues <= RPS_TEST_COUNTOF(queueFlags); numQueues++)
+    {
+        for (uint32_t iPass = 0; iPass < 2; iPass++)
+        {
+            const bool bParallel = (iPass == 1);
+
+            fixture.createInfo.scheduleInfo.numQueues = numQueues;
+            fixture.createInfo.taskSystem             = {};
+
+            if (bParallel)
+            {
+                fixture.createInfo.taskSystem.pfnEnqueueJob    = &ThreadTaskSystem::EnqueueJob;
+                fixture.createInfo.taskSystem.pfnWaitJob       = &ThreadTaskSystem::WaitJob;
+                fixture.createInfo.taskSystem.numWorkerThreads = 4;
+                fixture.createInfo.taskSystem.pUserContext     = &taskSystem;
+            }
+
+            REQUIRE_RPS_OK(fixture.CreateRenderGraph());
+
+            REQUIRE_RPS_OK(fixture.Update());
+
+            const uint32_t     numNodes = graphInfo.numChains * 2 + 1;
+            ExecuteTestContext context;
+
+            RpsRenderGraphExecuteInfo executeInfo = {};
+            executeInfo.pUserContext              = &context;
+            executeInfo.pfnAcquireRuntimeCmdBufCb = &ExecuteTestContext::AcquireCmdBufs;
+            executeInfo.pfnSubmitRuntimeCmdBufCb  = &ExecuteTestContext::SubmitCmdBufs;
+            executeInfo.pfnGetCmdRecordCostCb     = &ExecuteTestContext::GetCmdRecordCost;
+            executeInfo.minRecordCostPerCmdBuffer = 16;
+
+            REQUIRE_RPS_OK(rpsRenderGraphExecute(fixture.hRenderGraph, &executeInfo));
+
+            RpsRenderGraphBatchLayout batchLayout = {};
+            REQUIRE_RPS_OK(rpsRenderGraphGetBatchLayout(fixture.hRenderGraph, &batchLayout));
+
+            // Every batch is submitted once, with all fence waits satisfied by earlier signals.
+            REQUIRE(context.numSubmits == batchLayout.numCmdBatches);
+            REQUIRE(context.bFencesValid);
+            REQUIRE(std::find(context.cmdBufSubmitted.begin(), context.cmdBufSubmitted.end(), false) ==
+                    context.cmdBufSubmitted.end());
+
+            // Without a task system each batch is recorded into a single command buffer.
+            if (bParallel)
+            {
+                REQUIRE(context.cmdBufQueues.size() > batchLayout.numCmdBatches);
+            }
+            else
+            {
+                REQUIRE(context.cmdBufQueues.size() <= batchLayout.numCmdBatches);
+            }
+
+            // Every node is recorded exactly once, into a submitted command buffer.
+            REQUIRE(context.recordedNodes.size() == numNodes);
+
+            std::sort(context.recordedNodes.begin(), context.recordedNodes.end(), [](const auto& lhs, const auto& rhs) {
+                return lhs.ppArgs < rhs.ppArgs;
+            });
+
+            for (uint32_t iNode = 0; iNode < numNodes; iNode++)
+            {
+                const auto& recordedNode = context.recordedNodes[iNode];
+
+                REQUIRE(((iNode == 0) || (context.recordedNodes[iNode - 1].ppArgs != recordedNode.ppArgs)));
+                REQUIRE(recordedNode.cmdBuf > 0);
+                REQUIRE(recordedNode.cmdBuf <= context.cmdBufQueues.size());
+            }
+
+            printf("ExecuteParallelRecording: %u queue(s), %s: %u batches, %zu command buffers\n",
+                   numQueues,
+                   bParallel ? "parallel" : "serial",
+                   batchLayout.numCmdBatches,
+                   context.cmdBufQueues.size());
+        }
+    }
+
+    fixture.Destroy();
+}
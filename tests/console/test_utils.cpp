@@ -9,6 +9,7 @@
 #include <catch2/catch.hpp>
 #include <stdarg.h>
 
+#include "core/rps_graph.hpp"
 #include "core/rps_util.hpp"
 
 #include "utils/rps_test_common.h"
@@ -816,6 +817,134 @@ TEST_CASE("Span")
     RPS_TEST_MALLOC_COUNTER_EQUAL_CURRENT(0);
 }
 
+TEST_CASE("GraphFrozenEdges")
+{
+    using rps::Edge;
+    using rps::NodeId;
+
+    RpsAllocator allocator = {
+        &CountedMalloc,
+        &CountedFree,
+        &CountedRealloc,
+        nullptr,
+    };
+
+    RPS_TEST_MALLOC_CHECKPOINT(0);
+
+    RpsDeviceCreateInfo deviceCreateInfo = {};
+    deviceCreateInfo.allocator           = allocator;
+    deviceCreateInfo.printer.pfnPrintf   = PrintToStdErr;
+
+    rps::Device* pDevice = nullptr;
+    REQUIRE_RPS_OK(rps::Device::Create(&deviceCreateInfo, &pDevice));
+
+    do
+    {
+        rps::Arena graphArena(allocator);
+        rps::Arena buildArena(allocator);
+
+        rps::Graph graph(*pDevice, graphArena);
+        graph.Reset(buildArena);
+
+        for (int32_t iCmd = 0; iCmd < 6; iCmd++)
+        {
+            REQUIRE(graph.AddNode(iCmd) == NodeId(iCmd));
+        }
+
+        graph.AddEdge(0, 1);
+        graph.AddEdge(0, 2);
+        graph.AddEdge(1, 3);
+        graph.AddEdge(2, 3);
+        graph.AddEdge(3, 4);
+
+        auto fnCheckEdgeLists = [&](NodeId                        nodeId,
+                                    std::initializer_list<NodeId> expectedDsts,
+                                    std::initializer_list<NodeId> expectedSrcs) {
+            const rps::Node* pNode    = graph.GetNode(nodeId);
+            const auto       outEdges = pNode->outEdges.Get(graph.GetEdges());
+            const auto       inEdges  = pNode->inEdges.Get(graph.GetEdges());
+
+            REQUIRE(outEdges.size() == expectedDsts.size());
+            REQUIRE(inEdges.size() == expectedSrcs.size());
+
+            uint32_t iEdge = 0;
+            for (NodeId dst : expectedDsts)
+            {
+                REQUIRE(outEdges[iEdge].src == nodeId);
+                REQUIRE(outEdges[iEdge].dst == dst);
+                REQUIRE(graph.HasEdge(nodeId, dst));
+                iEdge++;
+            }
+
+            iEdge = 0;
+            for (NodeId src : expectedSrcs)
+            {
+                REQUIRE(inEdges[iEdge].src == src);
+                REQUIRE(inEdges[iEdge].dst == nodeId);
+                REQUIRE(graph.HasEdge(src, nodeId));
+                iEdge++;
+            }
+        };
+
+        REQUIRE_RPS_OK(graph.Freeze());
+        REQUIRE(graph.IsFrozen());
+
+        // Packed in CSR order, the out edges of all nodes by node id followed by their in edges.
+        const uint32_t numFrozenEdges = uint32_t(graph.GetEdges().size());
+        REQUIRE(numFrozenEdges == 10);
+
+        uint32_t offset = 0;
+        for (const rps::Node& node : graph.GetNodes())
+        {
+            REQUIRE(node.outEdges.GetBegin() == offset);
+            offset += node.outEdges.size();
+        }
+        for (const rps::Node& node : graph.GetNodes())
+        {
+            REQUIRE(node.inEdges.GetBegin() == offset);
+            offset += node.inEdges.size();
+        }
+
+        fnCheckEdgeLists(0, {1, 2}, {});
+        fnCheckEdgeLists(3, {4}, {1, 2});
+        fnCheckEdgeLists(4, {}, {3});
+
+        const uint32_t node1OutBegin = graph.GetNode(1)->outEdges.GetBegin();
+        const uint32_t node3OutBegin = graph.GetNode(3)->outEdges.GetBegin();
+
+        // Adding to a packed list moves it out of the packed range, adding to an empty list allocates a new one.
+        graph.AddEdge(0, 4);
+        graph.AddEdge(5, 3);
+        graph.AddEdge(0, 5);
+        graph.AddEdge(2, 5);
+
+        REQUIRE(graph.GetNode(0)->outEdges.GetBegin() >= numFrozenEdges);
+        REQUIRE(graph.GetNode(3)->inEdges.GetBegin() >= numFrozenEdges);
+        REQUIRE(graph.GetNode(4)->inEdges.GetBegin() >= numFrozenEdges);
+        REQUIRE(graph.GetNode(5)->outEdges.GetBegin() >= numFrozenEdges);
+
+        // Lists not added to stay where they were packed.
+        REQUIRE(graph.GetNode(1)->outEdges.GetBegin() == node1OutBegin);
+        REQUIRE(graph.GetNode(3)->outEdges.GetBegin() == node3OutBegin);
+
+        fnCheckEdgeLists(0, {1, 2, 4, 5}, {});
+        fnCheckEdgeLists(1, {3}, {0});
+        fnCheckEdgeLists(2, {3, 5}, {0});
+        fnCheckEdgeLists(3, {4}, {1, 2, 5});
+        fnCheckEdgeLists(4, {}, {3, 0});
+        fnCheckEdgeLists(5, {3}, {0, 2});
+
+        REQUIRE(!graph.HasEdge(1, 0));
+        REQUIRE(!graph.HasEdge(4, 0));
+        REQUIRE(!graph.HasEdge(1, 5));
+
+    } while (false);
+
+    pDevice->Destroy();
+
+    RPS_TEST_MALLOC_COUNTER_EQUAL_CURRENT(0);
+}
+
 template <size_t T>
 static void StrBuilderCheck(const rps::StrBuilder<T>& builder, const char *str)
 {
@@ -134,19 +134,14 @@ RPS_TEST_MAYBE_UNUSED static RpsDevice rpsTestUtilCreateDevice(
     return device;
 }
 
-RPS_TEST_MAYBE_UNUSED static RpsDevice rpsTestUtilCreateNullRuntimeDevice()
+RPS_TEST_MAYBE_UNUSED static RpsDevice rpsTestUtilCreateNullRuntimeDevice(PFN_rpsPrintf pfnPrintf = PrintToStdErr)
 {
     RpsDevice           device     = RPS_NULL_HANDLE;
     RpsDeviceCreateInfo createInfo = {};
 
     createInfo.allocator.pfnAlloc = CountedMalloc;
     createInfo.allocator.pfnFree  = CountedFree;
-    createInfo.printer.pfnPrintf  = PrintToStdErr;
-
-    RpsRuntimeCallbacks callbacks       = {};
-    callbacks.pfnBuildRenderGraphPhases = nullptr;
-
-    RpsRuntimeDeviceCreateInfo rtCreate = {};
+    createInfo.printer.pfnPrintf  = pfnPrintf;
 
     RpsNullRuntimeDeviceCreateInfo nullCreateInfo = {};
     nullCreateInfo.pDeviceCreateInfo              = &createInfo;
@@ -0,0 +1,114 @@
+// Copyright (c) 2024 Advanced Micro Devices, Inc.
+//
+// This file is part of the AMD Render Pipeline Shaders SDK which is
+// released under the MIT LICENSE.
+//
+// See file LICENSE.txt for full license details.
+
+#pragma once
+
+#include "rps_test_common.h"
+
+#include <vector>
+
+RPS_TEST_MAYBE_UNUSED static RpsResourceDesc rpsTestUtilMakeBackBufferDesc(uint32_t width, uint32_t height)
+{
+    RpsResourceDesc backBufferDesc   = {};
+    backBufferDesc.type              = RPS_RESOURCE_TYPE_IMAGE_2D;
+    backBufferDesc.temporalLayers    = 1;
+    backBufferDesc.image.arrayLayers = 1;
+    backBufferDesc.image.format      = RPS_FORMAT_R8G8B8A8_UNORM;
+    backBufferDesc.image.mipLevels   = 1;
+    backBufferDesc.image.sampleCount = 1;
+    backBufferDesc.image.width       = width;
+    backBufferDesc.image.height      = height;
+    return backBufferDesc;
+}
+
+// A render graph on a null runtime device, built by a C++ callback from the parameters added with AddParam.
+// createInfo and updateInfo can be adjusted before CreateRenderGraph and Update. Destroy checks for leaks.
+struct RpsTestRenderGraphFixture
+{
+    RpsDevice                     device       = RPS_NULL_HANDLE;
+    RpsRenderGraph                hRenderGraph = RPS_NULL_HANDLE;
+    std::vector<RpsParameterDesc> paramDescs;
+    std::vector<RpsConstant>      args;
+    RpsRenderGraphSignatureDesc   signatureDesc = {};
+    RpsRenderGraphCreateInfo      createInfo    = {};
+    RpsRenderGraphUpdateInfo      updateInfo    = {};
+
+    RpsTestRenderGraphFixture(const char*             name,
+                              PFN_rpsRenderGraphBuild pfnBuildCallback,
+                              PFN_rpsPrintf           pfnPrintf = PrintToStdErr)
+        : RpsTestRenderGraphFixture(name, pfnBuildCallback, rpsTestUtilCreateNullRuntimeDevice(pfnPrintf))
+    {
+    }
+
+    // Runs on inDevice instead, which the fixture destroys.
+    RpsTestRenderGraphFixture(const char* name, PFN_rpsRenderGraphBuild pfnBuildCallback, RpsDevice inDevice)
+        : device(inDevice)
+    {
+        signatureDesc.name                            = name;
+        createInfo.mainEntryCreateInfo.pSignatureDesc = &signatureDesc;
+        updateInfo.gpuCompletedFrameIndex             = RPS_GPU_COMPLETED_FRAME_INDEX_NONE;
+        updateInfo.pfnBuildCallback                   = pfnBuildCallback;
+    }
+
+    RpsTestRenderGraphFixture(const RpsTestRenderGraphFixture&) = delete;
+    RpsTestRenderGraphFixture& operator=(const RpsTestRenderGraphFixture&) = delete;
+
+    ~RpsTestRenderGraphFixture()
+    {
+        // Only reached without Destroy if a REQUIRE failed, so skip the leak check.
+        rpsRenderGraphDestroy(hRenderGraph);
+        rpsDeviceDestroy(device);
+    }
+
+    template <typename T>
+    void AddParam(const char* name, const T* pArg, RpsParameterFlags flags = RPS_PARAMETER_FLAG_NONE)
+    {
+        RpsParameterDesc paramDesc = {};
+        paramDesc.typeInfo         = rpsTypeInfoInitFromType(T);
+        paramDesc.flags            = flags;
+        paramDesc.name             = name;
+
+        paramDescs.push_back(paramDesc);
+        args.push_back(pArg);
+    }
+
+    void AddBackBufferParam(const RpsResourceDesc* pBackBufferDesc)
+    {
+        AddParam("backBuffer", pBackBufferDesc, RPS_PARAMETER_FLAG_RESOURCE_BIT);
+    }
+
+    // Creates the render graph from the current createInfo, replacing any previous one.
+    RpsResult CreateRenderGraph()
+    {
+        DestroyRenderGraph();
+
+        signatureDesc.numParams   = uint32_t(paramDescs.size());
+        signatureDesc.pParamDescs = paramDescs.data();
+        updateInfo.numArgs        = uint32_t(args.size());
+        updateInfo.ppArgs         = args.data();
+
+        return rpsRenderGraphCreate(device, &createInfo, &hRenderGraph);
+    }
+
+    RpsResult Update()
+    {
+        return rpsRenderGraphUpdate(hRenderGraph, &updateInfo);
+    }
+
+    void DestroyRenderGraph()
+    {
+        rpsRenderGraphDestroy(hRenderGraph);
+        hRenderGraph = RPS_NULL_HANDLE;
+    }
+
+    void Destroy()
+    {
+        DestroyRenderGraph();
+        rpsTestUtilDestroyDevice(device);
+        device = RPS_NULL_HANDLE;
+    }
+};